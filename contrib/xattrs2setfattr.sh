@@ -0,0 +1,50 @@
+#!/bin/sh
+set -eu
+
+####
+#
+# Export the extended attributes emulated by "proot -0" -- file
+# capabilities for instance -- in the format of "getfattr --dump", so
+# they can be applied for real with "setfattr --restore".
+#
+# Usage:
+#  - run "PROOT_XATTR_STORE=store proot -0 -r rootfs ..."
+#  - run "xattrs2setfattr.sh store rootfs > xattrs"
+#  - run "cd rootfs && setfattr --restore=xattrs" as root
+#
+# Note: the store is keyed by host device and inode numbers, so this
+# has to be run before the files in "rootfs" are copied or replaced.
+#
+####
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 store rootfs" >&2
+    exit 1
+fi
+
+store="$1"
+rootfs="$2"
+
+find "${rootfs}" -xdev -printf '%D %i %P\n' | awk '
+    # First pass: the store ("<dev> <inode> <name> 0x<value>").
+    FNR == NR {
+        key = $1 " " $2
+        xattrs[key] = xattrs[key] $3 "=" $4 "\n"
+        next
+    }
+
+    # Second pass: the files of the rootfs ("<dev> <inode> <path>").
+    {
+        key = $1 " " $2
+        if (!(key in xattrs))
+            next
+
+        path = $0
+        sub(/^[^ ]* [^ ]* /, "", path)
+        if (path == "")
+            path = "."
+
+        printf "# file: %s\n%s\n", path, xattrs[key]
+        delete xattrs[key]
+    }
+' "${store}" -
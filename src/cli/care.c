@@ -34,6 +34,7 @@
 #include "cli/note.h"
 #include "path/binding.h"
 #include "path/temp.h"
+#include "path/cwd.h"
 #include "extension/extension.h"
 #include "extension/care/care.h"
 #include "extension/care/extract.h"
@@ -327,10 +328,8 @@ static int pre_initialize_bindings(Tracee *tracee, const Cli *cli,
 		return -1;
 	}
 
-	tracee->fs->cwd = talloc_strdup(tracee->fs, path);
-	if (tracee->fs->cwd == NULL)
+	if (set_cwd(tracee->fs, path) < 0)
 		return -1;
-	talloc_set_name_const(tracee->fs->cwd, "$cwd");
 
 	/* Initialize @tracee's root (required by PRoot).  */
 	binding = new_binding(tracee, "/", "/", true);
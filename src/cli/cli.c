@@ -43,9 +43,14 @@
 #include "extension/extension.h"
 #include "tracee/tracee.h"
 #include "tracee/event.h"
+#include "tracee/features.h"
 #include "path/binding.h"
 #include "path/canon.h"
 #include "path/path.h"
+#include "path/cwd.h"
+#include "path/temp.h"
+#include "execve/runner.h"
+#include "syscall/unknown.h"
 
 #include "build.h"
 
@@ -184,12 +189,14 @@ static void print_argv(const Tracee *tracee, const char *prompt, char *const arg
 
 static void print_config(Tracee *tracee, char *const argv[])
 {
+	size_t i;
+
 	assert(tracee != NULL);
 
 	if (tracee->verbose <= 0)
 		return;
 
-	if (tracee->qemu)
+	if (HAS_RUNNERS(tracee))
 		note(tracee, INFO, USER, "host rootfs = %s", HOST_ROOTFS);
 
 	if (tracee->glue)
@@ -198,8 +205,11 @@ static void print_config(Tracee *tracee, char *const argv[])
 	note(tracee, INFO, USER, "exe = %s", tracee->exe);
 	print_argv(tracee, "argv", argv);
 	print_argv(tracee, "qemu", tracee->qemu);
+	for (i = 0; i < talloc_array_length(tracee->runners); i++)
+		print_argv(tracee, "runner", tracee->runners[i].command);
 	note(tracee, INFO, USER, "initial cwd = %s", tracee->fs->cwd);
 	note(tracee, INFO, USER, "verbose level = %d", tracee->verbose);
+	print_kernel_features(tracee);
 
 	notify_extensions(tracee, PRINT_CONFIG, 0, 0);
 }
@@ -247,11 +257,9 @@ static int initialize_cwd(Tracee *tracee)
 	chop_finality(path);
 
 	/* Replace with the canonicalized working directory.  */
-	TALLOC_FREE(tracee->fs->cwd);
-	tracee->fs->cwd = talloc_strdup(tracee->fs, path);
-	if (tracee->fs->cwd == NULL)
+	status = set_cwd(tracee->fs, path);
+	if (status < 0)
 		return -1;
-	talloc_set_name_const(tracee->fs->cwd, "$cwd");
 
 	/* Keep this special environment variable consistent.  */
 	setenv("PWD", path, 1);
@@ -445,6 +453,7 @@ static int parse_config(Tracee *tracee, size_t argc, char *const argv[])
 #undef HOOK_CONFIG
 
 	print_config(tracee, &argv[argc_offset]);
+	print_unknown_sysnums(tracee);
 
 	return argc_offset;
 }
@@ -469,11 +478,18 @@ int main(int argc, char *const argv[])
 		goto error;
 	tracee->pid = getpid();
 
+	/* Select the implementations depending on kernel features,
+	 * some extensions rely on this during their initialization.  */
+	probe_kernel_features();
+
 	/* Pre-configure the first tracee.  */
 	status = parse_config(tracee, argc, argv);
 	if (status < 0)
 		goto error;
 
+	/* Clean up after previous sessions that were killed.  */
+	reap_stale_temp_sessions(tracee);
+
 	/* Start the first tracee.  */
 	status = launch_process(tracee, &argv[status]);
 	if (status < 0) {
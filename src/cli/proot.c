@@ -24,11 +24,21 @@
 #include <assert.h>    /* assert(3), */
 #include <stdio.h>     /* printf(3), fflush(3), */
 #include <unistd.h>    /* write(2), */
+#include <stdlib.h>    /* strtoul(3), */
+#include <errno.h>     /* errno(3), */
 
 #include "cli/cli.h"
 #include "cli/note.h"
 #include "extension/extension.h"
 #include "path/binding.h"
+#include "path/cwd.h"
+#include "path/policy.h"
+#include "execve/runner.h"
+#include "syscall/socket.h"
+#include "syscall/io_uring.h"
+#include "syscall/unknown.h"
+#include "tracee/event.h"
+#include "tracee/watchdog.h"
 #include "attribute.h"
 
 /* These should be included last.  */
@@ -69,86 +79,47 @@ static int handle_option_b(Tracee *tracee, const Cli *cli UNUSED, const char *va
 	return 0;
 }
 
-static int handle_option_q(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+/**
+ * Bind the host rootfs into the guest rootfs, if not yet done.  This
+ * is required by runners -- see expand_runner() -- to execute host
+ * programs natively.
+ */
+static void bind_host_rootfs(Tracee *tracee)
 {
-	const char *ptr;
-	size_t nb_args;
-	bool last;
-	size_t i;
-
-	nb_args = 0;
-	ptr = value;
-	while (1) {
-		nb_args++;
+	if (HAS_RUNNERS(tracee))
+		return;
 
-		/* Keep consecutive non-space characters.  */
-		while (*ptr != ' ' && *ptr != '\0')
-			ptr++;
-
-		/* End-of-string ?  */
-		if (*ptr == '\0')
-			break;
-
-		/* Skip consecutive space separators.  */
-		while (*ptr == ' ' && *ptr != '\0')
-			ptr++;
+	new_binding(tracee, "/", HOST_ROOTFS, true);
+	new_binding(tracee, "/dev/null", "/etc/ld.so.preload", false);
+}
 
-		/* End-of-string ?  */
-		if (*ptr == '\0')
-			break;
-	}
+static int handle_option_q(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	char **qemu;
 
-	tracee->qemu = talloc_zero_array(tracee, char *, nb_args + 1);
-	if (tracee->qemu == NULL)
+	qemu = parse_runner_command(tracee, value);
+	if (qemu == NULL)
 		return -1;
-	talloc_set_name_const(tracee->qemu, "@qemu");
-
-	i = 0;
-	ptr = value;
-	do {
-		const void *start;
-		const void *end;
-		last = true;
-
-		/* Keep consecutive non-space characters.  */
-		start = ptr;
-		while (*ptr != ' ' && *ptr != '\0')
-			ptr++;
-		end = ptr;
-
-		/* End-of-string ?  */
-		if (*ptr == '\0')
-			goto next;
-
-		/* Remove consecutive space separators.  */
-		while (*ptr == ' ' && *ptr != '\0')
-			ptr++;
-
-		/* End-of-string ?  */
-		if (*ptr == '\0')
-			goto next;
-
-		last = false;
-	next:
-		tracee->qemu[i] = talloc_strndup(tracee->qemu, start, end - start);
-		if (tracee->qemu[i] == NULL)
-			return -1;
-		i++;
-	} while (!last);
-	assert(i == nb_args);
+	talloc_set_name_const(qemu, "@qemu");
 
-	new_binding(tracee, "/", HOST_ROOTFS, true);
-	new_binding(tracee, "/dev/null", "/etc/ld.so.preload", false);
+	bind_host_rootfs(tracee);
+
+	talloc_unlink(tracee, tracee->qemu);
+	tracee->qemu = qemu;
 
 	return 0;
 }
 
+static int handle_option_runner(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	bind_host_rootfs(tracee);
+	return new_runner(tracee, value);
+}
+
 static int handle_option_w(Tracee *tracee, const Cli *cli UNUSED, const char *value)
 {
-	tracee->fs->cwd = talloc_strdup(tracee->fs, value);
-	if (tracee->fs->cwd == NULL)
+	if (set_cwd(tracee->fs, value) < 0)
 		return -1;
-	talloc_set_name_const(tracee->fs->cwd, "$cwd");
 	return 0;
 }
 
@@ -197,6 +168,87 @@ static int handle_option_kill_on_exit(Tracee *tracee, const Cli *cli UNUSED, con
 	return 0;
 }
 
+static int handle_option_watchdog(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	const char *separator;
+	char *seconds;
+	int status;
+
+	separator = strchr(value, ',');
+	if (separator != NULL) {
+		if (strcmp(separator + 1, "restart") != 0) {
+			note(tracee, ERROR, USER, "option `--watchdog` expects 'seconds' or 'seconds,restart'.");
+			return -1;
+		}
+		watchdog_restart = true;
+	}
+
+	seconds = talloc_strndup(tracee->ctx, value, separator != NULL ? (size_t) (separator - value) : strlen(value));
+	if (seconds == NULL)
+		return -1;
+
+	status = parse_integer_option(tracee, &watchdog_timeout, seconds, "--watchdog");
+	if (status < 0)
+		return status;
+
+	if (watchdog_timeout <= 0) {
+		note(tracee, ERROR, USER, "option `--watchdog` expects a positive value.");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int handle_option_isolate_abstract_sockets(Tracee *tracee UNUSED, const Cli *cli UNUSED,
+						const char *value UNUSED)
+{
+	isolate_abstract_sockets();
+	return 0;
+}
+
+static int handle_option_io_uring(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	int status;
+
+	status = set_io_uring_policy(value);
+	if (status < 0) {
+		note(tracee, ERROR, USER, "option `--io-uring` expects \"deny\" or \"allow\".");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int handle_option_unknown_syscalls(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	int status;
+
+	status = set_unknown_syscalls_policy(value);
+	if (status < 0) {
+		note(tracee, ERROR, USER, "option `--unknown-syscalls` expects \"allow\", \"report\", "
+			"or \"deny\", optionally followed by a comma-separated list of syscall numbers.");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int handle_option_grace_period(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	int status;
+
+	status = parse_integer_option(tracee, &signal_grace_period, value, "--grace-period");
+	if (status < 0)
+		return status;
+
+	if (signal_grace_period < 0) {
+		note(tracee, ERROR, USER, "option `--grace-period` expects a positive value.");
+		return -1;
+	}
+
+	return 0;
+}
+
 static int handle_option_v(Tracee *tracee, const Cli *cli UNUSED, const char *value)
 {
 	int status;
@@ -322,6 +374,46 @@ static int handle_option_n(Tracee *tracee, const Cli *cli UNUSED, const char *va
 	return status;
 }
 
+static int handle_option_auto_ports(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	unsigned long first_port;
+	unsigned long last_port;
+	char *end;
+	int status = 0;
+
+	errno = 0;
+	first_port = strtoul(value, &end, 10);
+	if (errno == 0 && *end == '-')
+		last_port = strtoul(end + 1, &end, 10);
+	else
+		last_port = 0;
+
+	if (errno != 0 || *end != '\0' || first_port == 0
+	    || first_port > last_port || last_port > 65535) {
+		note(tracee, ERROR, USER, "invalid port range '%s', expected 'first-last'", value);
+		return -1;
+	}
+
+	if(global_portmap_extension == NULL)
+		status = initialize_extension(tracee, portmap_callback, value);
+	if(status < 0)
+		return status;
+
+	return activate_auto_mode(first_port, last_port);
+}
+
+static int handle_option_export_ports(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	int status = 0;
+
+	if(global_portmap_extension == NULL)
+		status = initialize_extension(tracee, portmap_callback, value);
+	if(status < 0)
+		return status;
+
+	return set_portmap_file(value);
+}
+
 #ifdef HAVE_PYTHON_EXTENSION
 static int handle_option_P(Tracee *tracee, const Cli *cli UNUSED, const char *value)
 {
@@ -330,30 +422,47 @@ static int handle_option_P(Tracee *tracee, const Cli *cli UNUSED, const char *va
 }
 #endif
 
+static int handle_option_policy(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	return new_policy(tracee, value);
+}
+
+static int handle_option_profile_bindings(Tracee *tracee UNUSED, const Cli *cli UNUSED, const char *value UNUSED)
+{
+	profile_bindings = true;
+	return 0;
+}
+
+static int handle_option_deps(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	return initialize_extension(tracee, deps_callback, value);
+}
+
+static int handle_option_reproducible(Tracee *tracee, const Cli *cli UNUSED, const char *value)
+{
+	return initialize_extension(tracee, reproducible_callback, value);
+}
+
 static int handle_option_l(Tracee *tracee, const Cli *cli UNUSED, const char *value UNUSED)
 {
 	return initialize_extension(tracee, link2symlink_callback, NULL);
 }
 
 /**
- * Initialize @tracee->qemu.
+ * Resolve the guest path to @command[0], as a host path from the
+ * tracee's point-of-view.
  */
-static int post_initialize_exe(Tracee *tracee, const Cli *cli UNUSED,
-			size_t argc UNUSED, char *const argv[] UNUSED, size_t cursor UNUSED)
+static int resolve_runner(Tracee *tracee, char **command)
 {
 	char path[PATH_MAX];
 	int status;
 
-	/* Nothing else to do ?  */
-	if (tracee->qemu == NULL)
-		return 0;
-
-	/* Resolve the full guest path to tracee->qemu[0].  */
-	status = which(tracee->reconf.tracee, tracee->reconf.paths, path, tracee->qemu[0]);
+	/* Resolve the full guest path to command[0].  */
+	status = which(tracee->reconf.tracee, tracee->reconf.paths, path, command[0]);
 	if (status < 0)
 		return -1;
 
-	/* Actually tracee->qemu[0] has to be a host path from the tracee's
+	/* Actually command[0] has to be a host path from the tracee's
 	 * point-of-view, not from the PRoot's point-of-view.  See
 	 * translate_execve() for details.  */
 	if (tracee->reconf.tracee != NULL) {
@@ -362,13 +471,37 @@ static int post_initialize_exe(Tracee *tracee, const Cli *cli UNUSED,
 			return -1;
 	}
 
-	tracee->qemu[0] = talloc_strdup(tracee->qemu, path);
-	if (tracee->qemu[0] == NULL)
+	command[0] = talloc_strdup(talloc_parent(command[0]), path);
+	if (command[0] == NULL)
 		return -1;
 
 	return 0;
 }
 
+/**
+ * Initialize @tracee->qemu, @tracee->runners, and the policies.
+ */
+static int post_initialize_exe(Tracee *tracee, const Cli *cli UNUSED,
+			size_t argc UNUSED, char *const argv[] UNUSED, size_t cursor UNUSED)
+{
+	int status;
+	size_t i;
+
+	if (tracee->qemu != NULL) {
+		status = resolve_runner(tracee, tracee->qemu);
+		if (status < 0)
+			return -1;
+	}
+
+	for (i = 0; i < talloc_array_length(tracee->runners); i++) {
+		status = resolve_runner(tracee, tracee->runners[i].command);
+		if (status < 0)
+			return -1;
+	}
+
+	return initialize_policies(tracee);
+}
+
 /**
  * Initialize @tracee's fields that are mandatory for PRoot but that
  * are not required on the command line, i.e.  "-w" and "-r".
@@ -51,6 +51,7 @@ static const char *recommended_su_bindings[] = {
 static int handle_option_r(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_b(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_q(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_runner(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_w(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_v(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_V(Tracee *tracee, const Cli *cli, const char *value);
@@ -67,6 +68,17 @@ static int handle_option_l(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_R(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_S(Tracee *tracee, const Cli *cli, const char *value);
 static int handle_option_kill_on_exit(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_isolate_abstract_sockets(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_io_uring(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_unknown_syscalls(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_grace_period(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_watchdog(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_reproducible(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_deps(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_profile_bindings(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_policy(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_auto_ports(Tracee *tracee, const Cli *cli, const char *value);
+static int handle_option_export_ports(Tracee *tracee, const Cli *cli, const char *value);
 
 static int pre_initialize_bindings(Tracee *, const Cli *, size_t, char *const *, size_t);
 static int post_initialize_exe(Tracee *, const Cli *, size_t, char *const *, size_t);
@@ -123,6 +135,23 @@ Copyright (C) 2022 PRoot Developers, licensed under GPL v2 or later.",
 \tbehavior shouldn't be a problem, although it is possible to\n\
 \texplicitly not dereference the guest location by appending it the\n\
 \t! character: -b *host_path*:*guest_location!*.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--policy", .separator = '=', .value = "flags:path" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_policy,
+	  .description = "Restrict the accesses to *path* and its content as per *flags*.",
+	  .detail = "\tThe comma-separated *flags* are \"ro\" to make writes fail with\n\
+\tEROFS, \"hide\" to make *path* look like it doesn't exist, \"deny\"\n\
+\tto make any access fail with EACCES, \"noexec\" to make executions\n\
+\tfail with EACCES, and \"rw\" to lift these restrictions.  Only the\n\
+\tpolicy of the longest *path* applies, for instance\n\
+\t--policy=ro:/ --policy=rw:/tmp makes everything read-only but\n\
+\t/tmp.  The guest *path* is resolved once bindings are installed,\n\
+\tand the policies apply to all the guest paths that lead to the\n\
+\tsame host file.  Note that hidden entries are still listed in\n\
+\ttheir parent directory.",
 	},
 	{ .class = "Regular options",
 	  .arguments = {
@@ -137,6 +166,23 @@ Copyright (C) 2022 PRoot Developers, licensed under GPL v2 or later.",
 \temulated by QEMU user-mode.  The native execution of host programs\n\
 \tis still effective and the whole host rootfs is bound to\n\
 \t/host-rootfs in the guest environment.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--runner", .separator = '=', .value = "machine:command" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_runner,
+	  .description = "Execute guest programs made for *machine* through *command*.",
+	  .detail = "\tThis option is similar to -q, except it applies only to the ELF\n\
+\tprograms made for *machine*, either a well-known name -- \"arm\",\n\
+\t\"aarch64\", \"riscv64\", ... -- or the numerical value of the\n\
+\te_machine field of their ELF header, optionally followed by /32 or\n\
+\t/64 to select an ELF class.  Well-known names also select a byte\n\
+\torder, like \"mips\" and \"mipsel\".  This option can be repeated to\n\
+\trun a rootfs that mixes programs for several machines: the first\n\
+\tmatching runner is used, otherwise the one specified with -q, if\n\
+\tany.  The machine of a given program is read only once, as long\n\
+\tas this program is not modified.",
 	},
 	{ .class = "Regular options",
 	  .arguments = {
@@ -159,6 +205,121 @@ Copyright (C) 2022 PRoot Developers, licensed under GPL v2 or later.",
 	  .detail = "\tWhen the executed command leaves orphean or detached processes\n\
 \taround, proot waits until all processes possibly terminate. This option forces\n\
 \tthe immediate termination of all tracee processes when the main command exits.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--grace-period", .separator = '=', .value = "seconds" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_grace_period,
+	  .description = "Wait *seconds* for processes to terminate when proot is asked to.",
+	  .detail = "\tWhen proot receives SIGTERM, SIGINT, or SIGHUP from another process,\n\
+\tthis signal is forwarded to the executed command (or to its process\n\
+\tgroup).  All processes are killed if they are still alive after\n\
+\t*seconds* (10 by default, 0 means immediately), or if a second\n\
+\tsignal is received in the meantime.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--watchdog", .separator = '=', .value = "seconds[,restart]" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_watchdog,
+	  .description = "Report processes kept stopped by proot for more than *seconds*.",
+	  .detail = "\tA process that stays stopped by proot -- and not on behalf of a\n\
+\tdebugger -- is likely stuck because of a bug in proot.  The state\n\
+\tof such processes is dumped on stderr, or appended to the file\n\
+\tspecified by the PROOT_STATE_DUMP environment variable.  With\n\
+\t\",restart\", proot also tries to restart them when this is safe.\n\
+\tAlso, the state of all processes is dumped when proot receives\n\
+\tSIGPWR; this signal is ignored without this option.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--isolate-abstract-sockets", .separator = '\0', .value = NULL },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_isolate_abstract_sockets,
+	  .description = "Make the abstract Unix domain sockets private to this session.",
+	  .detail = "\tAbstract Unix domain sockets are not bound to the file-system,\n\
+\thence programs from concurrent proot sessions can't use the same\n\
+\tabstract socket name.  This option transparently prefixes the\n\
+\tabstract socket names used by the guest programs with a tag that\n\
+\tis unique to the current session.  As a consequence, abstract\n\
+\tsockets created outside of the current session can't be reached.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--io-uring", .separator = '=', .value = "policy" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_io_uring,
+	  .description = "Set how io_uring is handled, either \"deny\" (default) or \"allow\".",
+	  .detail = "\tThe operations submitted through an io_uring are performed by\n\
+\tkernel threads that proot can't trace, hence their paths are not\n\
+\ttranslated and they bypass the bindings.  With \"deny\",\n\
+\tio_uring_setup(2) fails with ENOSYS so that programs fall back to\n\
+\tregular syscalls.  With \"allow\", io_uring is usable, for\n\
+\tinstance when the guest doesn't rely on any binding.  The number\n\
+\tof io_uring_setup(2) denied and allowed is reported when proot\n\
+\texits, at verbose level 1 and above, and in state dumps.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--unknown-syscalls", .separator = '=', .value = "policy[,number...]" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_unknown_syscalls,
+	  .description = "Set how syscalls unknown to proot are handled, either \"allow\" (default), \"report\", or \"deny\".",
+	  .detail = "\tThe syscalls that are not in the tables of proot are not\n\
+\ttranslated, hence the paths they take, if any, bypass the guest\n\
+\trootfs and the bindings.  With \"allow\", they run as-is.  With\n\
+\t\"report\", they run as-is too but each one is reported once.\n\
+\tWith \"deny\", they fail with ENOSYS, directly from the seccomp\n\
+\tfilter when it is available.  Syscalls known to not take any path\n\
+\tcan be allowed anyway by appending their numbers, as seen by the\n\
+\tkernel for the guest architecture, for instance\n\
+\t\"deny,451,0x4000001c\".  The ranges of unknown syscalls are\n\
+\tprinted at startup, at verbose level 1 and above, and with\n\
+\t\"report\".",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--deps", .separator = '=', .value = "file" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_deps,
+	  .description = "Write the paths accessed by each process to *file*.",
+	  .detail = "\tThis option is useful to build systems that discover the\n\
+\tdependencies of a command automatically.  For each process, and\n\
+\tagain after each successful execve(2), proot records the guest\n\
+\tpaths that were read, written, created, deleted, or probed but\n\
+\tmissing.  A file opened with O_CREAT is deemed created only if\n\
+\tO_EXCL was specified or if it was known to be missing, otherwise\n\
+\tit is deemed written.  These records are written to *file* in\n\
+\tthe JSON format once all processes have terminated.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--profile-bindings", .separator = '\0', .value = NULL },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_profile_bindings,
+	  .description = "Report how much each binding costs, and which ones are unused.",
+	  .detail = "\tFor each binding, proot counts the path lookups it matched, the\n\
+\tlstat(2) it issued during the canonicalization of guest paths,\n\
+\tand the time spent there.  When proot exits, the bindings are\n\
+\tlisted by decreasing cost, followed by the ones that were never\n\
+\tused.  This helps to drop useless bindings.",
+	},
+	{ .class = "Regular options",
+	  .arguments = {
+		{ .name = "--reproducible", .separator = '=', .value = "seed" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_reproducible,
+	  .description = "Remove some sources of nondeterminism, using *seed*.",
+	  .detail = "\tThis option is useful to make builds reproducible.  The random\n\
+\tbytes provided by the kernel to programs (AT_RANDOM) and returned by\n\
+\tgetrandom(2) are generated from *seed*, the host name and kernel\n\
+\tversion reported by uname(2) are replaced by fixed values, and the\n\
+\tentries of directories are returned in sorted order.  If the\n\
+\tSOURCE_DATE_EPOCH environment variable is set, timestamps of files\n\
+\tthat are newer than the start of the session -- files created in the\n\
+\tsession typically -- are reported as SOURCE_DATE_EPOCH.  Note that\n\
+\treading /dev/urandom is not affected.",
 	},
 	{ .class = "Regular options",
 	  .arguments = {
@@ -215,10 +376,11 @@ Copyright (C) 2022 PRoot Developers, licensed under GPL v2 or later.",
 \tprivileges, even if there is no technical reason for that.  This\n\
 \tis typically the case with package managers.  This option allows\n\
 \tusers to bypass this kind of limitation by faking the user/group\n\
-\tidentity, and by faking the success of some operations like\n\
-\tchanging the ownership of files, changing the root directory to\n\
-\t/, ...  Note that this option is quite limited compared to\n\
-\tfakeroot.",
+\tidentity, by faking the success of some operations like changing\n\
+\tthe ownership of files, by emulating changes of the root\n\
+\tdirectory (chroot), and by emulating bind mounts and tmpfs\n\
+\t(mount), ...  Note that this option is quite limited compared\n\
+\tto fakeroot.",
 	},
 	{ .class = "Extension options",
 	  .arguments = {
@@ -264,6 +426,31 @@ Copyright (C) 2022 PRoot Developers, licensed under GPL v2 or later.",
 \tto run multiple instances of a same program without worrying about the same ports\n\
 \tbeing used twice.",
 	},
+	{ .class = "Extension options",
+	  .arguments = {
+		{ .name = "--auto-ports", .separator = '=', .value = "range" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_auto_ports,
+	  .description = "Map ports in *range* \"first-last\" to free ports automatically.",
+	  .detail = "\tThe first time a guest program binds a port in *range*, PRoot\n\
+\tpicks a free port on the host and binds this latter instead.\n\
+\tThis mapping is then used by connect() for all the programs of\n\
+\tthe session, and accept(), getsockname(), and getpeername() still\n\
+\treport the ports as seen by the guest.  This way, several\n\
+\tinstances of a test suite that use the same fixed ports can run\n\
+\tin parallel.  Use --export-ports to find out the actual ports.",
+	},
+	{ .class = "Extension options",
+	  .arguments = {
+		{ .name = "--export-ports", .separator = '=', .value = "path" },
+		{ .name = NULL, .separator = '\0', .value = NULL } },
+	  .handler = handle_option_export_ports,
+	  .description = "Keep the port map written in the file at *path*.",
+	  .detail = "\tEach time a port mapping is added, the file at *path* is\n\
+\tatomically replaced with the list of all the mappings, one\n\
+\t\"port_in port_out\" pair per line.  This lets programs outside of\n\
+\tPRoot reach the services of the guest.",
+	},
 #ifdef HAVE_PYTHON_EXTENSION
 	{ .class = "Extension options",
 	  .arguments = {
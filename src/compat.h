@@ -258,5 +258,53 @@
 #    ifndef NT_ARM_SYSTEM_CALL
 #        define NT_ARM_SYSTEM_CALL		0x404
 #    endif
+#    ifndef PTRACE_GET_SYSCALL_INFO
+#        define PTRACE_GET_SYSCALL_INFO	0x420e
+#    endif
+#    ifndef SECCOMP_GET_ACTION_AVAIL
+#        define SECCOMP_GET_ACTION_AVAIL	2
+#    endif
+#    ifndef SECCOMP_RET_USER_NOTIF
+#        define SECCOMP_RET_USER_NOTIF	0x7fc00000U
+#    endif
+#    ifndef SYS_io_uring_setup
+#        define SYS_io_uring_setup	425
+#    endif
+#    ifndef SYS_pidfd_open
+#        define SYS_pidfd_open		434
+#    endif
+#    ifndef SYS_clone3
+#        define SYS_clone3		435
+#    endif
+#    ifndef CSIGNAL
+#        define CSIGNAL		0x000000ff
+#    endif
+#    ifndef CLONE_ARGS_SIZE_VER0
+#        define CLONE_ARGS_SIZE_VER0	64
+#    endif
+#    ifndef SYS_openat2
+#        define SYS_openat2		437
+#    endif
+#    ifndef RESOLVE_NO_XDEV
+#        define RESOLVE_NO_XDEV		0x01
+#    endif
+#    ifndef RESOLVE_NO_MAGICLINKS
+#        define RESOLVE_NO_MAGICLINKS	0x02
+#    endif
+#    ifndef RESOLVE_NO_SYMLINKS
+#        define RESOLVE_NO_SYMLINKS	0x04
+#    endif
+#    ifndef RESOLVE_BENEATH
+#        define RESOLVE_BENEATH		0x08
+#    endif
+#    ifndef RESOLVE_IN_ROOT
+#        define RESOLVE_IN_ROOT		0x10
+#    endif
+#    ifndef OPEN_HOW_SIZE_VER0
+#        define OPEN_HOW_SIZE_VER0	24
+#    endif
+#    ifndef RENAME_EXCHANGE
+#        define RENAME_EXCHANGE		(1 << 1)
+#    endif
 
 #endif /* COMPAT_H */
@@ -80,7 +80,7 @@ word_t get_elf_aux_vectors_address(const Tracee *tracee)
 	word_t data;
 
 	/* Sanity check: this works only in execve sysexit.  */
-	assert(IS_IN_SYSEXIT2(tracee, PR_execve));
+	assert(IS_IN_SYSEXIT2(tracee, PR_execve) || IS_IN_SYSEXIT2(tracee, PR_execveat));
 
 	/* Right after execve, the stack layout is:
 	 *
@@ -142,37 +142,3 @@ int iterate_program_headers(const Tracee *tracee, int fd, const ElfHeader *elf_h
 
 	return 0;
 }
-
-/**
- * Check if @host_path is an ELF file for the host architecture.
- */
-bool is_host_elf(const Tracee *tracee, const char *host_path)
-{
-	int host_elf_machine[] = HOST_ELF_MACHINE;
-	static int force_foreign = -1;
-	ElfHeader elf_header;
-	uint16_t elf_machine;
-	int fd;
-	int i;
-
-	if (force_foreign < 0)
-		force_foreign = (getenv("PROOT_FORCE_FOREIGN_BINARY") != NULL);
-
-	if (force_foreign > 0 || !tracee->qemu)
-		return false;
-
-	fd = open_elf(host_path, &elf_header);
-	if (fd < 0)
-		return false;
-	close(fd);
-
-	elf_machine = ELF_FIELD(elf_header, machine);
-	for (i = 0; host_elf_machine[i] != 0; i++) {
-		if (host_elf_machine[i] == elf_machine) {
-			VERBOSE(tracee, 1, "'%s' is a host ELF", host_path);
-			return true;
-		}
-	}
-
-	return false;
-}
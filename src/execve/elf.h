@@ -136,6 +136,7 @@ typedef enum {
 /* The following macros are also compatible with ELF 64-bit. */
 #define ELF_IDENT(header, index) (header).class32.e_ident[(index)]
 #define ELF_CLASS(header) ELF_IDENT(header, 4)
+#define ELF_DATA(header)  ELF_IDENT(header, 5)
 #define IS_CLASS32(header) (ELF_CLASS(header) == 1)
 #define IS_CLASS64(header) (ELF_CLASS(header) == 2)
 
@@ -168,8 +169,6 @@ typedef enum {
 
 extern int open_elf(const char *t_path, ElfHeader *elf_header);
 
-extern bool is_host_elf(const Tracee *tracee, const char *t_path);
-
 typedef int (* program_headers_iterator_t)(const ElfHeader *elf_header,
 					const ProgramHeader *program_header, void *data);
 
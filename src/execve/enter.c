@@ -22,7 +22,7 @@
 
 #include <sys/types.h>  /* lstat(2), lseek(2), */
 #include <sys/stat.h>   /* lstat(2), lseek(2), fchmod(2), */
-#include <unistd.h>     /* access(2), lstat(2), close(2), read(2), */
+#include <unistd.h>     /* access(2), lstat(2), close(2), read(2), pread(2), */
 #include <errno.h>      /* E*, */
 #include <assert.h>     /* assert(3), */
 #include <talloc.h>     /* talloc*, */
@@ -31,9 +31,11 @@
 #include <stdlib.h>     /* getenv(3), */
 #include <stdio.h>      /* fwrite(3), */
 #include <assert.h>     /* assert(3), */
+#include <fcntl.h>      /* open(2), AT_*, */
 
 #include "execve/execve.h"
 #include "execve/shebang.h"
+#include "execve/runner.h"
 #include "execve/aoxp.h"
 #include "execve/ldso.h"
 #include "execve/elf.h"
@@ -49,11 +51,38 @@
 #define P(a) PROGRAM_FIELD(load_info->elf_header, *program_header, a)
 
 /**
- * Add @program_header (type PT_LOAD) to @load_info->mappings.  This
- * function returns -errno if an error occured, otherwise it returns
- * 0.
+ * Check if the @length bytes at @offset in the file referenced by @fd
+ * are all zero, or lie beyond the end of this file.
+ */
+static bool is_zero_filled(int fd, off_t offset, size_t length)
+{
+	char buffer[4096];
+	ssize_t status;
+	size_t i;
+
+	if (length > sizeof(buffer))
+		return false;
+
+	status = pread(fd, buffer, length, offset);
+	if (status < 0)
+		return false;
+
+	/* Bytes beyond the end of the file are zero-filled by the
+	 * kernel.  */
+	for (i = 0; i < (size_t) status; i++) {
+		if (buffer[i] != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Add @program_header (type PT_LOAD) to @load_info->mappings, @fd
+ * refers to the file this latter comes from.  This function returns
+ * -errno if an error occured, otherwise it returns 0.
  */
-static int add_mapping(const Tracee *tracee UNUSED, LoadInfo *load_info,
+static int add_mapping(const Tracee *tracee UNUSED, int fd, LoadInfo *load_info,
 		const ProgramHeader *program_header)
 {
 	size_t index;
@@ -98,6 +127,13 @@ static int add_mapping(const Tracee *tracee UNUSED, LoadInfo *load_info,
 		/* How many extra bytes in the current page?  */
 		load_info->mappings[index].clear_length = end_address - P(vaddr) - P(filesz);
 
+		/* The loader doesn't have to clear them if they are
+		 * already zero in the file, this saves a copy-on-write
+		 * page fault.  */
+		if (is_zero_filled(fd, P(offset) + P(filesz),
+					load_info->mappings[index].clear_length))
+			load_info->mappings[index].clear_length = 0;
+
 		/* Create new pages for the remaining extra bytes.  */
 		start_address = end_address;
 		end_address   = (P(vaddr) + P(memsz) + page_size) & page_mask;
@@ -199,7 +235,7 @@ static int add_interp(Tracee *tracee, int fd, LoadInfo *load_info,
 	 *
 	 * In both case, it lies in "/host-rootfs" from a guest
 	 * point-of-view.  */
-	if (tracee->qemu != NULL && user_path[0] == '/') {
+	if (HAS_RUNNERS(tracee) && user_path[0] == '/') {
 		user_path = talloc_asprintf(tracee->ctx, "%s%s", HOST_ROOTFS, user_path);
 		if (user_path == NULL)
 			return -ENOMEM;
@@ -242,7 +278,7 @@ static int add_load_info(const ElfHeader *elf_header,
 
 	switch (PROGRAM_FIELD(*elf_header, *program_header, type)) {
 	case PT_LOAD:
-		status = add_mapping(data->tracee, data->load_info, program_header);
+		status = add_mapping(data->tracee, data->fd, data->load_info, program_header);
 		if (status < 0)
 			return status;
 		break;
@@ -367,6 +403,7 @@ static void compute_load_addresses(Tracee *tracee)
 static int expand_runner(Tracee* tracee, char host_path[PATH_MAX], char user_path[PATH_MAX])
 {
 	ArrayOfXPointers *envp;
+	char **runner;
 	char *argv0;
 	int status;
 
@@ -382,7 +419,8 @@ static int expand_runner(Tracee* tracee, char host_path[PATH_MAX], char user_pat
 
 	/* No need to adjust argv[] if it's a host binary (a.k.a
 	 * mixed-mode).  */
-	if (!is_host_elf(tracee, host_path)) {
+	runner = get_runner(tracee, host_path);
+	if (runner != NULL) {
 		ArrayOfXPointers *argv;
 		size_t nb_qemu_args;
 		size_t i;
@@ -409,13 +447,13 @@ static int expand_runner(Tracee* tracee, char host_path[PATH_MAX], char user_pat
 		 *           { "qemu", "-cpu", "cortex-a9", "-0", "true", "/bin/true", NULL }, ...)
 		 */
 
-		nb_qemu_args = talloc_array_length(tracee->qemu) - 1;
+		nb_qemu_args = talloc_array_length(runner) - 1;
 		status = resize_array_of_xpointers(argv, 1, nb_qemu_args + 2);
 		if (status < 0)
 			return status;
 
 		for (i = 0; i < nb_qemu_args; i++) {
-			status = write_xpointee(argv, i, tracee->qemu[i]);
+			status = write_xpointee(argv, i, runner[i]);
 			if (status < 0)
 				return status;
 		}
@@ -436,10 +474,10 @@ static int expand_runner(Tracee* tracee, char host_path[PATH_MAX], char user_pat
 
 		/* Launch the runner in lieu of the initial
 		 * program. */
-		assert(strlen(tracee->qemu[0]) + strlen(HOST_ROOTFS) < PATH_MAX);
-		assert(tracee->qemu[0][0] == '/');
+		assert(strlen(runner[0]) + strlen(HOST_ROOTFS) < PATH_MAX);
+		assert(runner[0][0] == '/');
 
-		strcpy(host_path, tracee->qemu[0]);
+		strcpy(host_path, runner[0]);
 
 		strcpy(user_path, HOST_ROOTFS);
 		strcat(user_path, host_path);
@@ -479,12 +517,21 @@ static char *extract_loader(const Tracee *tracee, bool wants_32bit_version)
 	int status;
 	int fd;
 
+	const char *temp_path;
 	char *loader_path = NULL;
 	FILE *file = NULL;
 
-	file = open_temp_file(NULL, "prooted");
-	if (file == NULL)
+	/* The loader has to be reachable by its path since it is
+	 * executed by the tracees.  */
+	temp_path = create_temp_file(NULL, "prooted");
+	if (temp_path == NULL)
 		goto end;
+
+	file = fopen(temp_path, "w");
+	if (file == NULL) {
+		note(tracee, ERROR, SYSTEM, "can't open the loader");
+		goto end;
+	}
 	fd = fileno(file);
 
 	if (wants_32bit_version) {
@@ -568,6 +615,201 @@ static inline const char *get_loader_path(const Tracee *tracee)
 	}
 }
 
+/**
+ * Copy the content of @src_path into @dest_path.  This function
+ * returns -errno if an error occurred, otherwise 0.
+ */
+static int copy_file_content(const char *src_path, const char *dest_path)
+{
+	char buffer[4096];
+	ssize_t size;
+	int status = 0;
+	int src_fd;
+	int dest_fd;
+
+	src_fd = open(src_path, O_RDONLY | O_CLOEXEC);
+	if (src_fd < 0)
+		return -errno;
+
+	dest_fd = open(dest_path, O_WRONLY | O_TRUNC | O_CLOEXEC);
+	if (dest_fd < 0) {
+		status = -errno;
+		goto end;
+	}
+
+	while ((size = read(src_fd, buffer, sizeof(buffer))) > 0) {
+		if (write(dest_fd, buffer, size) != size) {
+			status = -EIO;
+			goto end;
+		}
+	}
+	if (size < 0)
+		status = -errno;
+
+end:
+	(void) close(src_fd);
+	if (dest_fd >= 0)
+		(void) close(dest_fd);
+
+	return status;
+}
+
+/**
+ * Make the content of the file referred to by @proc_path -- for
+ * instance a memfd, or a deleted file -- reachable from @tracee
+ * through the guest path written in @user_path.  This function
+ * returns -errno if an error occurred, otherwise 0.
+ */
+static int bind_exec_copy(Tracee *tracee, const char *proc_path, char user_path[PATH_MAX])
+{
+	const char *host_path;
+	char *guest_path;
+	Binding *binding;
+	int status;
+
+	/* The loader opens the program by its path, once the
+	 * close-on-exec descriptors are gone, hence this copy.  */
+	guest_path = talloc_asprintf(tracee->ctx, "%s/proot-exec-%d",
+				get_temp_directory(), tracee->pid);
+	if (guest_path == NULL)
+		return -ENOMEM;
+
+	if (strlen(guest_path) >= PATH_MAX)
+		return -ENAMETOOLONG;
+
+	/* Remove the copy made for the previous execveat(2), if
+	 * any.  */
+	binding = get_binding(tracee, GUEST, guest_path);
+	if (binding != NULL && compare_paths(binding->guest.path, guest_path) == PATHS_ARE_EQUAL) {
+		remove_binding_from_all_lists(tracee, binding);
+		TALLOC_FREE(binding);
+	}
+
+	host_path = create_temp_file(tracee->ctx, "exec");
+	if (host_path == NULL)
+		return -EACCES;
+
+	status = copy_file_content(proc_path, host_path);
+	if (status < 0)
+		return status;
+
+	status = chmod(host_path, S_IRUSR | S_IXUSR);
+	if (status < 0)
+		return -errno;
+
+	/* Note: this binding will be removed once tracee gets freed.  */
+	binding = insort_binding3(tracee, tracee->life_context, host_path, guest_path);
+	if (binding == NULL)
+		return -ENOMEM;
+
+	/* This temporary file (host_path) will be removed once the
+	 * binding is freed.  */
+	talloc_reparent(tracee->ctx, binding, host_path);
+
+	strcpy(user_path, guest_path);
+	return 0;
+}
+
+/**
+ * Get in @user_path a guest path to the program referred to by the
+ * descriptor @fd of @tracee, as used by fexecve(3).  This function
+ * returns -errno if an error occurred, otherwise 0.
+ */
+static int get_fd_exec_path(Tracee *tracee, int fd, char user_path[PATH_MAX])
+{
+	char host_path[PATH_MAX];
+	char proc_path[32];
+	struct stat statl2;
+	struct stat statl;
+	int status;
+
+	status = snprintf(proc_path, sizeof(proc_path), "/proc/%d/fd/%d", tracee->pid, fd);
+	if (status < 0 || (size_t) status >= sizeof(proc_path))
+		return -EBADF;
+
+	/* This follows the "magic" link, even for anonymous files.  */
+	status = stat(proc_path, &statl);
+	if (status < 0)
+		return -EBADF;
+
+	if (!S_ISREG(statl.st_mode) || (statl.st_mode & (S_IXUSR | S_IXGRP | S_IXOTH)) == 0)
+		return -EACCES;
+
+	/* Use the path of this file directly if it is still reachable
+	 * from the guest, this is the common case.  */
+	status = readlink_proc_pid_fd(tracee->pid, fd, host_path);
+	if (status >= 0 && host_path[0] == '/') {
+		strcpy(user_path, host_path);
+		status = detranslate_path(tracee, user_path, NULL);
+		if (status >= 0)
+			status = translate_path(tracee, host_path, AT_FDCWD, user_path, true);
+		if (status >= 0)
+			status = stat(host_path, &statl2);
+		if (status >= 0
+		    && statl2.st_dev == statl.st_dev
+		    && statl2.st_ino == statl.st_ino)
+			return 0;
+	}
+
+	return bind_exec_copy(tracee, proc_path, user_path);
+}
+
+/**
+ * Get in @user_path the guest path of the program executed by the
+ * current execveat(2) of @tracee, then turn this latter into the
+ * equivalent execve(2).  This function returns -errno if an error
+ * occurred, otherwise 0.
+ */
+static int translate_execveat_args(Tracee *tracee, char user_path[PATH_MAX])
+{
+	char host_path[PATH_MAX];
+	struct stat statl;
+	word_t flags;
+	int dirfd;
+	int status;
+
+	dirfd = (int) peek_reg(tracee, ORIGINAL, SYSARG_1);
+	flags = peek_reg(tracee, ORIGINAL, SYSARG_5);
+
+	if ((flags & ~(word_t) (AT_EMPTY_PATH | AT_SYMLINK_NOFOLLOW)) != 0)
+		return -EINVAL;
+
+	status = get_sysarg_path(tracee, user_path, SYSARG_2);
+	if (status < 0)
+		return status;
+
+	if (user_path[0] == '\0') {
+		if ((flags & AT_EMPTY_PATH) == 0)
+			return -ENOENT;
+
+		status = get_fd_exec_path(tracee, dirfd, user_path);
+	}
+	else if ((user_path[0] != '/' && dirfd != AT_FDCWD)
+		|| (flags & AT_SYMLINK_NOFOLLOW) != 0) {
+		status = translate_path(tracee, host_path, dirfd, user_path, false);
+		if (status < 0)
+			return status;
+
+		if ((flags & AT_SYMLINK_NOFOLLOW) != 0
+		    && lstat(host_path, &statl) == 0 && S_ISLNK(statl.st_mode))
+			return -ELOOP;
+
+		/* Make it absolute, the remaining is done from the
+		 * current working directory.  */
+		strcpy(user_path, host_path);
+		status = detranslate_path(tracee, user_path, NULL);
+	}
+	if (status < 0)
+		return status;
+
+	/* From now on, this is an execve(2).  */
+	set_sysnum(tracee, PR_execve);
+	poke_reg(tracee, SYSARG_2, peek_reg(tracee, ORIGINAL, SYSARG_3));
+	poke_reg(tracee, SYSARG_3, peek_reg(tracee, ORIGINAL, SYSARG_4));
+
+	return 0;
+}
+
 /**
  * Extract all the information that will be required by
  * translate_load_*().  This function returns -errno if an error
@@ -582,7 +824,8 @@ int translate_execve_enter(Tracee *tracee)
 	const char *loader_path;
 	int status;
 
-	if (IS_NOTIFICATION_PTRACED_LOAD_DONE(tracee)) {
+	if (get_sysnum(tracee, ORIGINAL) == PR_execve
+	    && IS_NOTIFICATION_PTRACED_LOAD_DONE(tracee)) {
 		/* Syscalls can now be reported to its ptracer.  */
 		tracee->as_ptracee.ignore_loader_syscalls = false;
 
@@ -592,7 +835,10 @@ int translate_execve_enter(Tracee *tracee)
 		return 0;
 	}
 
-	status = get_sysarg_path(tracee, user_path, SYSARG_1);
+	if (get_sysnum(tracee, ORIGINAL) == PR_execveat)
+		status = translate_execveat_args(tracee, user_path);
+	else
+		status = get_sysarg_path(tracee, user_path, SYSARG_1);
 	if (status < 0)
 		return status;
 
@@ -611,7 +857,7 @@ int translate_execve_enter(Tracee *tracee)
 
 	/* user_path is modified only if there's an interpreter
 	 * (ie. for a script or with qemu).  */
-	if (status == 0 && tracee->qemu == NULL)
+	if (status == 0 && !HAS_RUNNERS(tracee))
 		TALLOC_FREE(raw_path);
 
 	/* Remember the new value for "/proc/self/exe".  It points to
@@ -626,7 +872,7 @@ int translate_execve_enter(Tracee *tracee)
 	else
 		tracee->new_exe = NULL;
 
-	if (tracee->qemu != NULL) {
+	if (HAS_RUNNERS(tracee)) {
 		status = expand_runner(tracee, host_path, user_path);
 		if (status < 0)
 			return status;
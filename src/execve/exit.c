@@ -28,6 +28,7 @@
 #include <strings.h>    /* bzero(3), */
 #include <signal.h>     /* kill(2), SIG*, */
 #include <unistd.h>     /* write(2), */
+#include <stdbool.h>    /* bool, true, false, */
 #include <errno.h>      /* E*, */
 
 #include "execve/execve.h"
@@ -39,6 +40,7 @@
 #include "syscall/sysnum.h"
 #include "execve/auxv.h"
 #include "path/binding.h"
+#include "path/proc.h"
 #include "path/temp.h"
 #include "cli/note.h"
 
@@ -137,6 +139,99 @@ static int bind_proc_pid_auxv(const Tracee *ptracee)
 	return 0;
 }
 
+/**
+ * Merge the mappings of @load_info that are contiguous, both in memory
+ * and in the file, and that have the same protection in order to
+ * reduce the number of statements -- and thus of syscalls -- the
+ * loader has to execute.
+ */
+static void optimize_mappings(const Tracee *tracee, LoadInfo *load_info)
+{
+	Mapping *mappings = load_info->mappings;
+	size_t nb_mappings;
+	size_t i, j;
+
+	nb_mappings = talloc_array_length(mappings);
+	if (nb_mappings == 0)
+		return;
+
+	for (i = 0, j = 1; j < nb_mappings; j++) {
+		Mapping *previous = &mappings[i];
+		Mapping *current  = &mappings[j];
+		bool anonymous = (previous->flags & MAP_ANONYMOUS) != 0;
+
+		if (   previous->flags == current->flags
+		    && previous->prot  == current->prot
+		    && previous->addr + previous->length == current->addr
+		    && (anonymous
+			|| (   previous->clear_length == 0
+			    && previous->offset + previous->length == current->offset))) {
+			previous->length += current->length;
+			previous->clear_length = current->clear_length;
+			continue;
+		}
+
+		mappings[++i] = *current;
+	}
+
+	if (i + 1 < nb_mappings) {
+		VERBOSE(tracee, 2, "loader: %zu mappings of '%s' merged into %zu",
+			nb_mappings, load_info->host_path, i + 1);
+		load_info->mappings = talloc_realloc(load_info, mappings, Mapping, i + 1);
+		if (load_info->mappings == NULL)
+			load_info->mappings = mappings; /* Shrinking can't fail actually.  */
+	}
+}
+
+/**
+ * Return the number of mappings in @mappings that will be partially
+ * cleared by the loader.
+ */
+static size_t count_clears(const Mapping *mappings)
+{
+	size_t count = 0;
+	size_t i;
+
+	for (i = 0; i < talloc_array_length(mappings); i++) {
+		if (mappings[i].clear_length != 0)
+			count++;
+	}
+
+	return count;
+}
+
+/**
+ * Return the number of syscalls the loader will execute to load
+ * @tracee->load_info, according to loader/loader.c.  The number of
+ * partial clears is added to @nb_clears.
+ */
+static size_t count_loader_syscalls(const Tracee *tracee, bool needs_executable_stack,
+				size_t *nb_clears)
+{
+	size_t count;
+
+	*nb_clears = count_clears(tracee->load_info->mappings);
+	if (tracee->load_info->interp != NULL)
+		*nb_clears += count_clears(tracee->load_info->interp->mappings);
+
+	/* open + mmap(s) + close + prctl.  */
+	count = 3 + talloc_array_length(tracee->load_info->mappings);
+
+	/* close + open + mmap(s).  */
+	if (tracee->load_info->interp != NULL)
+		count += 2 + talloc_array_length(tracee->load_info->interp->mappings);
+
+	/* mprotect.  */
+	if (needs_executable_stack)
+		count++;
+
+	/* execve, as a notification to the ptracer.  */
+	if (tracee->as_ptracee.ptracer != NULL)
+		count++;
+
+	return count;
+}
+
 /**
  * Convert @mappings into load @script statements at the given @cursor
  * position.  This function returns the new cursor position.
@@ -195,6 +290,8 @@ static int transfer_load_script(Tracee *tracee)
 
 	bool needs_executable_stack;
 	LoadStatement *statement;
+	size_t nb_syscalls = 0;
+	size_t nb_clears = 0;
 	void *cursor;
 	int status;
 
@@ -209,6 +306,23 @@ static int transfer_load_script(Tracee *tracee)
 				|| (   tracee->load_info->interp != NULL
 				    && tracee->load_info->interp->needs_executable_stack));
 
+	if (tracee->verbose >= 2)
+		nb_syscalls = count_loader_syscalls(tracee, needs_executable_stack, &nb_clears);
+
+	optimize_mappings(tracee, tracee->load_info);
+	if (tracee->load_info->interp != NULL)
+		optimize_mappings(tracee, tracee->load_info->interp);
+
+	if (tracee->verbose >= 2) {
+		size_t nb_syscalls2;
+		size_t nb_clears2;
+
+		nb_syscalls2 = count_loader_syscalls(tracee, needs_executable_stack, &nb_clears2);
+		VERBOSE(tracee, 2, "loader: %zu syscalls and %zu clears to load '%s' "
+			"(%zu and %zu before optimization)", nb_syscalls2, nb_clears2,
+			tracee->load_info->user_path, nb_syscalls, nb_clears);
+	}
+
 	/* Strings addresses are required to generate the load script,
 	 * for "open" actions.  Since I want to generate it in one
 	 * pass, these strings will be put right below the current
@@ -399,7 +513,8 @@ void translate_execve_exit(Tracee *tracee)
 	word_t syscall_result;
 	int status;
 
-	if (IS_NOTIFICATION_PTRACED_LOAD_DONE(tracee)) {
+	if (get_sysnum(tracee, ORIGINAL) == PR_execve
+	    && IS_NOTIFICATION_PTRACED_LOAD_DONE(tracee)) {
 		/* Be sure not to confuse the ptracer with an
 		 * unexpected syscall/returned value.  */
 		poke_reg(tracee, SYSARG_RESULT, 0);
@@ -458,6 +573,9 @@ void translate_execve_exit(Tracee *tracee)
 		talloc_set_name_const(tracee->exe, "$exe");
 	}
 
+	/* The memory mappings of the previous program are gone.  */
+	invalidate_proc_cache(tracee);
+
 	/* New processes have no heap. The process could've been cloned with
 	 * CLONE_VM so it has been sharing the heap with its parent. execve()
 	 * discards the VM so make sure to reallocate new heap. */
@@ -0,0 +1,338 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <sys/types.h>  /* stat(2), */
+#include <sys/stat.h>   /* stat(2), */
+#include <unistd.h>     /* close(2), */
+#include <stdlib.h>     /* getenv(3), strtoul(3), */
+#include <string.h>     /* strchr(3), strcmp(3), strncmp(3), */
+#include <stdbool.h>    /* bool, */
+#include <assert.h>     /* assert(3), */
+#include <errno.h>      /* E*, */
+#include <talloc.h>     /* talloc*, */
+#include <byteswap.h>   /* bswap_16(3), */
+
+#include "execve/runner.h"
+#include "execve/elf.h"
+#include "tracee/tracee.h"
+#include "cli/note.h"
+#include "arch.h"
+
+/* Values of "e_ident[EI_DATA]" in the ELF header.  */
+#define LSB 1
+#define MSB 2
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#    define HOST_ELF_DATA MSB
+#else
+#    define HOST_ELF_DATA LSB
+#endif
+
+/* Well-known names of ELF machines, as used by QEMU user-mode.  */
+static const struct {
+	const char *name;
+	uint16_t machine;
+	uint8_t class;
+	uint8_t data;
+} machines[] = {
+	{ "i386",	 3,	1,	LSB },
+	{ "x86_64",	62,	2,	LSB },
+	{ "arm",	40,	1,	LSB },
+	{ "armhf",	40,	1,	LSB },
+	{ "armeb",	40,	1,	MSB },
+	{ "aarch64",	183,	2,	LSB },
+	{ "aarch64_be",	183,	2,	MSB },
+	{ "riscv32",	243,	1,	LSB },
+	{ "riscv64",	243,	2,	LSB },
+	{ "ppc",	20,	1,	MSB },
+	{ "ppc64",	21,	2,	MSB },
+	{ "ppc64le",	21,	2,	LSB },
+	{ "mips",	8,	1,	MSB },
+	{ "mipsel",	8,	1,	LSB },
+	{ "mips64",	8,	2,	MSB },
+	{ "mips64el",	8,	2,	LSB },
+	{ "s390x",	22,	2,	MSB },
+	{ "sparc",	2,	1,	MSB },
+	{ "sparc64",	43,	2,	MSB },
+	{ "sh4",	42,	1,	LSB },
+	{ "sh4eb",	42,	1,	MSB },
+	{ "m68k",	4,	1,	MSB },
+	{ "loongarch64", 258,	2,	LSB },
+	{ NULL,		0,	0,	0 },
+};
+
+/**
+ * Split @value into a NULL-terminated array of space-separated
+ * arguments, allocated in the given @context.  This function returns
+ * NULL if an error occurred.
+ */
+char **parse_runner_command(TALLOC_CTX *context, const char *value)
+{
+	const char *ptr;
+	char **command;
+	size_t nb_args;
+	bool last;
+	size_t i;
+
+	nb_args = 0;
+	ptr = value;
+	while (1) {
+		nb_args++;
+
+		/* Keep consecutive non-space characters.  */
+		while (*ptr != ' ' && *ptr != '\0')
+			ptr++;
+
+		/* End-of-string ?  */
+		if (*ptr == '\0')
+			break;
+
+		/* Skip consecutive space separators.  */
+		while (*ptr == ' ' && *ptr != '\0')
+			ptr++;
+
+		/* End-of-string ?  */
+		if (*ptr == '\0')
+			break;
+	}
+
+	command = talloc_zero_array(context, char *, nb_args + 1);
+	if (command == NULL)
+		return NULL;
+
+	i = 0;
+	ptr = value;
+	do {
+		const void *start;
+		const void *end;
+		last = true;
+
+		/* Keep consecutive non-space characters.  */
+		start = ptr;
+		while (*ptr != ' ' && *ptr != '\0')
+			ptr++;
+		end = ptr;
+
+		/* End-of-string ?  */
+		if (*ptr == '\0')
+			goto next;
+
+		/* Remove consecutive space separators.  */
+		while (*ptr == ' ' && *ptr != '\0')
+			ptr++;
+
+		/* End-of-string ?  */
+		if (*ptr == '\0')
+			goto next;
+
+		last = false;
+	next:
+		command[i] = talloc_strndup(command, start, end - start);
+		if (command[i] == NULL)
+			return NULL;
+		i++;
+	} while (!last);
+	assert(i == nb_args);
+
+	return command;
+}
+
+/**
+ * Add to @tracee->runners the runner specified by @value, with the
+ * syntax "machine:command".  The machine is either a well-known name
+ * -- "aarch64" for instance -- or the numerical value of "e_machine"
+ * optionally followed by "/32" or "/64".  This function returns -1
+ * if an error occurred, otherwise 0.
+ */
+int new_runner(Tracee *tracee, const char *value)
+{
+	const char *separator;
+	Runner *runners;
+	Runner *runner;
+	size_t length;
+	size_t i;
+
+	separator = strchr(value, ':');
+	if (separator == NULL || separator == value || separator[1] == '\0') {
+		note(tracee, ERROR, USER, "runner '%s' is not of the form \"machine:command\"", value);
+		return -1;
+	}
+	length = talloc_array_length(tracee->runners);
+	runners = talloc_realloc(tracee, tracee->runners, Runner, length + 1);
+	if (runners == NULL) {
+		note(tracee, ERROR, INTERNAL, "can't allocate memory");
+		return -1;
+	}
+	talloc_set_name_const(runners, "@runners");
+	tracee->runners = runners;
+
+	runner = &runners[length];
+	runner->machine = 0;
+	runner->class = 0;
+	runner->data = 0;
+
+	for (i = 0; machines[i].name != NULL; i++) {
+		if (strncmp(machines[i].name, value, separator - value) == 0
+		    && machines[i].name[separator - value] == '\0') {
+			runner->machine = machines[i].machine;
+			runner->class   = machines[i].class;
+			runner->data    = machines[i].data;
+			break;
+		}
+	}
+
+	if (machines[i].name == NULL) {
+		char *end;
+
+		runner->machine = strtoul(value, &end, 0);
+		if (end != separator && strncmp(end, "/32:", 4) == 0)
+			runner->class = 1;
+		else if (end != separator && strncmp(end, "/64:", 4) == 0)
+			runner->class = 2;
+		else if (end != separator || runner->machine == 0) {
+			note(tracee, ERROR, USER, "unknown machine in runner '%s'", value);
+			return -1;
+		}
+	}
+
+	runner->command = parse_runner_command(runners, separator + 1);
+	if (runner->command == NULL) {
+		note(tracee, ERROR, INTERNAL, "can't allocate memory");
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Identity of an ELF file, as cached by get_elf_identity().  */
+typedef struct {
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+
+	/* Either 0 for non-ELF files, or the value of "e_machine".  */
+	uint16_t machine;
+	uint8_t class;
+	uint8_t data;
+} ElfIdentity;
+
+#define ELF_IDENTITY_CACHE_SIZE 64
+
+/**
+ * Get the ELF machine, class and data encoding of @host_path, for
+ * @tracee.  This information is cached per file identity, that way a
+ * file that is executed several times is opened only once.  This
+ * function returns NULL if @host_path doesn't exist.
+ */
+static const ElfIdentity *get_elf_identity(const Tracee *tracee, const char *host_path)
+{
+	static ElfIdentity cache[ELF_IDENTITY_CACHE_SIZE];
+	ElfIdentity *identity;
+	ElfHeader elf_header;
+	struct stat statl;
+	int status;
+	int fd;
+
+	status = stat(host_path, &statl);
+	if (status < 0)
+		return NULL;
+
+	identity = &cache[(statl.st_ino ^ statl.st_dev) % ELF_IDENTITY_CACHE_SIZE];
+	if (   identity->dev == statl.st_dev
+	    && identity->ino == statl.st_ino
+	    && identity->size == statl.st_size
+	    && identity->mtime.tv_sec  == statl.st_mtim.tv_sec
+	    && identity->mtime.tv_nsec == statl.st_mtim.tv_nsec)
+		return identity;
+
+	identity->dev   = statl.st_dev;
+	identity->ino   = statl.st_ino;
+	identity->size  = statl.st_size;
+	identity->mtime = statl.st_mtim;
+
+	fd = open_elf(host_path, &elf_header);
+	if (fd < 0) {
+		identity->machine = 0;
+		identity->class   = 0;
+		identity->data    = 0;
+	}
+	else {
+		identity->machine = ELF_FIELD(elf_header, machine);
+		identity->class   = ELF_CLASS(elf_header);
+		identity->data    = ELF_DATA(elf_header);
+		close(fd);
+
+		/* "e_machine" is encoded like the rest of the file.  */
+		if (identity->data != HOST_ELF_DATA)
+			identity->machine = bswap_16(identity->machine);
+	}
+
+	VERBOSE(tracee, 2, "'%s' is an ELF file for the machine %d/%d/%d",
+		host_path, identity->machine, identity->class, identity->data);
+
+	return identity;
+}
+
+/**
+ * Get the runner command-line for @host_path, according to its ELF
+ * machine, class and data encoding: the first matching runner from
+ * @tracee->runners is selected, otherwise it is NULL if @host_path is
+ * a host ELF file, otherwise it is the default runner @tracee->qemu.
+ */
+char **get_runner(const Tracee *tracee, const char *host_path)
+{
+	int host_elf_machine[] = HOST_ELF_MACHINE;
+	const ElfIdentity *identity;
+	static int force_foreign = -1;
+	size_t i;
+
+	if (force_foreign < 0)
+		force_foreign = (getenv("PROOT_FORCE_FOREIGN_BINARY") != NULL);
+
+	identity = get_elf_identity(tracee, host_path);
+	if (identity == NULL || identity->machine == 0)
+		return tracee->qemu;
+
+	for (i = 0; i < talloc_array_length(tracee->runners); i++) {
+		const Runner *runner = &tracee->runners[i];
+
+		if (runner->machine == identity->machine
+		    && (runner->class == 0 || runner->class == identity->class)
+		    && (runner->data == 0 || runner->data == identity->data)) {
+			VERBOSE(tracee, 1, "'%s' is run by '%s'", host_path, runner->command[0]);
+			return runner->command;
+		}
+	}
+
+	if (force_foreign > 0)
+		return tracee->qemu;
+
+	for (i = 0; host_elf_machine[i] != 0 && identity->data == HOST_ELF_DATA; i++) {
+		if (host_elf_machine[i] == identity->machine) {
+			VERBOSE(tracee, 1, "'%s' is a host ELF", host_path);
+			return NULL;
+		}
+	}
+
+	return tracee->qemu;
+}
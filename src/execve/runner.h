@@ -0,0 +1,55 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <stdint.h>  /* uint16_t, */
+#include <talloc.h>  /* TALLOC_CTX, */
+
+#include "tracee/tracee.h"
+
+/* Runner for the ELF files of a given machine.  */
+typedef struct runner {
+	/* Value of "e_machine" in the ELF header.  */
+	uint16_t machine;
+
+	/* Value of "e_ident[EI_CLASS]" in the ELF header, or 0 for
+	 * any class.  */
+	uint8_t class;
+
+	/* Value of "e_ident[EI_DATA]" in the ELF header, or 0 for any
+	 * data encoding.  */
+	uint8_t data;
+
+	/* Runner command-line.  */
+	char **command;
+} Runner;
+
+/* Either a runner was specified with -q or with --runner.  */
+#define HAS_RUNNERS(tracee) ((tracee)->qemu != NULL || (tracee)->runners != NULL)
+
+extern char **parse_runner_command(TALLOC_CTX *context, const char *value);
+extern int new_runner(Tracee *tracee, const char *value);
+extern char **get_runner(const Tracee *tracee, const char *host_path);
+
+#endif /* RUNNER_H */
@@ -34,6 +34,7 @@
 #include <archive_entry.h> /* archive_entry*(3), */
 
 #include "extension/care/archive.h"
+#include "extension/fake_id0/xattr.h"
 #include "tracee/tracee.h"
 #include "cli/note.h"
 
@@ -454,6 +455,17 @@ int finalize_archive(Archive *archive)
 	return 0;
 }
 
+/**
+ * Add the virtual extended attribute @name of @value and @size to the
+ * archive @entry pointed to by @data.
+ *
+ * Note: this is a callback for foreach_virtual_xattr().
+ */
+static void add_virtual_xattr(void *data, const char *name, const void *value, size_t size)
+{
+	archive_entry_xattr_add_entry((struct archive_entry *) data, name, value, size);
+}
+
 /**
  * Put the content of @path into @archive, with the specified @statl
  * status, at the given @alternate_path (NULL if unchanged).  This
@@ -483,6 +495,10 @@ int archive(const Tracee* tracee, Archive *archive,
 	archive_entry_set_pathname(entry, alternate_path ?: path);
 	archive_entry_copy_stat(entry, statl);
 
+	/* Attributes that were emulated by "fake_id0" -- file
+	 * capabilities for instance -- have to be carried too.  */
+	foreach_virtual_xattr(statl, add_virtual_xattr, entry);
+
 	if (archive->hardlink_resolver != NULL) {
 		struct archive_entry *unused;
 		archive_entry_linkify(archive->hardlink_resolver, &entry, &unused);
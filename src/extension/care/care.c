@@ -33,6 +33,7 @@
 #include <sys/queue.h>    /* STAILQ_*, */
 #include <inttypes.h>     /* PRI*, */
 #include <linux/auxvec.h> /* AT_*, */
+#include <fcntl.h>        /* O_*, */
 
 #include "extension/care/care.h"
 #include "extension/care/final.h"
@@ -40,6 +41,7 @@
 #include "extension/extension.h"
 #include "tracee/tracee.h"
 #include "tracee/mem.h"
+#include "syscall/syscall.h"
 #include "execve/auxv.h"
 #include "path/canon.h"
 #include "path/path.h"
@@ -408,6 +410,114 @@ static void handle_host_path(Extension *extension, const char *path)
 		VERBOSE(tracee, 1, "archived: %s", path);
 }
 
+/**
+ * Remember @path -- a host path -- was written during the original
+ * execution.  Its content is hashed only once the execution is over,
+ * c.f. archive_outputs_sha256(), this way recording isn't slowed
+ * down.
+ */
+static void register_written_path(const Tracee *tracee, Care *care, const char *path)
+{
+	Entry *entry;
+	Item *item;
+
+	/* Pipes, sockets, anonymous inodes, ...  */
+	if (path[0] != '/')
+		return;
+
+	HASH_FIND_STR(care->outputs, path, entry);
+	if (entry != NULL)
+		return;
+
+	entry = talloc_zero(care, Entry);
+	if (entry == NULL)
+		return;
+
+	entry->path = talloc_strdup(entry, path);
+	if (entry->path == NULL)
+		return;
+
+	HASH_ADD_KEYPTR(hh, care->outputs, entry->path, strlen(entry->path), entry);
+
+	item = queue_item(care, &care->written_paths, path);
+	if (item == NULL) {
+		note(tracee, WARNING, INTERNAL, "can't remember '%s' was written", path);
+		return;
+	}
+
+	VERBOSE(tracee, 1, "written: %s", path);
+}
+
+/**
+ * Register the file the current open(2), openat(2), openat2(2), or
+ * creat(2) is about to open for writing.  Only its path is recorded
+ * here, it is checked and hashed once the execution is over, c.f.
+ * archive_outputs_sha256(); this way the exit of these syscalls isn't
+ * traced.
+ */
+static void handle_open_enter(Tracee *tracee, Care *care)
+{
+	char path[PATH_MAX];
+	word_t flags;
+	OpenHow how;
+	Reg sysarg;
+	int status;
+
+	switch (get_sysnum(tracee, ORIGINAL)) {
+	case PR_open:
+		sysarg = SYSARG_1;
+		flags  = peek_reg(tracee, ORIGINAL, SYSARG_2);
+		break;
+
+	case PR_openat:
+		sysarg = SYSARG_2;
+		flags  = peek_reg(tracee, ORIGINAL, SYSARG_3);
+		break;
+
+	case PR_openat2:
+		sysarg = SYSARG_2;
+		flags  = (get_sysarg_open_how(tracee, ORIGINAL, &how) < 0
+			? O_WRONLY : how.flags);
+		break;
+
+	default:
+		sysarg = SYSARG_1;
+		flags  = O_WRONLY | O_CREAT | O_TRUNC;
+		break;
+	}
+
+	if ((flags & O_ACCMODE) == O_RDONLY)
+		return;
+
+	/* The path argument was already translated into an absolute
+	 * host path by PRoot.  */
+	status = read_path(tracee, path, peek_reg(tracee, CURRENT, sysarg));
+	if (status < 0)
+		return;
+
+	register_written_path(tracee, care, path);
+}
+
+/**
+ * Register the new path of the file the current rename(2),
+ * renameat(2), or renameat2(2) is about to rename, c.f.
+ * handle_open_enter().
+ */
+static void handle_rename_enter(Tracee *tracee, Care *care)
+{
+	char path[PATH_MAX];
+	int status;
+
+	/* The new path was already translated into an absolute host
+	 * path by PRoot.  */
+	status = read_path(tracee, path, peek_reg(tracee, CURRENT,
+			get_sysnum(tracee, ORIGINAL) == PR_rename ? SYSARG_2 : SYSARG_4));
+	if (status < 0)
+		return;
+
+	register_written_path(tracee, care, path);
+}
+
 typedef struct {
 	uint32_t d_ino;
 	uint32_t next;
@@ -541,6 +651,13 @@ static int adjust_elf_auxv(Tracee *tracee)
 static FilteredSysnum filtered_sysnums[] = {
 	{ PR_getdents,		FILTER_SYSEXIT },
 	{ PR_getdents64,	FILTER_SYSEXIT },
+	{ PR_creat,		0 },
+	{ PR_open,		0 },
+	{ PR_openat,		0 },
+	{ PR_openat2,		0 },
+	{ PR_rename,		0 },
+	{ PR_renameat,		0 },
+	{ PR_renameat2,		0 },
 	FILTERED_SYSNUM_END,
 };
 
@@ -552,6 +669,7 @@ int care_callback(Extension *extension, ExtensionEvent event,
 		intptr_t data1, intptr_t data2 UNUSED)
 {
 	Tracee *tracee;
+	Care *care;
 
 	switch (event) {
 	case INITIALIZATION:
@@ -571,6 +689,33 @@ int care_callback(Extension *extension, ExtensionEvent event,
 		handle_host_path(extension, (const char *) data1);
 		return 0;
 
+	case SYSCALL_ENTER_END:
+		/* The syscall will fail anyway.  */
+		if ((int) data1 < 0)
+			return 0;
+
+		tracee = TRACEE(extension);
+		care = talloc_get_type_abort(extension->config, Care);
+
+		switch (get_sysnum(tracee, ORIGINAL)) {
+		case PR_creat:
+		case PR_open:
+		case PR_openat:
+		case PR_openat2:
+			handle_open_enter(tracee, care);
+			break;
+
+		case PR_rename:
+		case PR_renameat:
+		case PR_renameat2:
+			handle_rename_enter(tracee, care);
+			break;
+
+		default:
+			break;
+		}
+		return 0;
+
 	case SYSCALL_EXIT_START:
 		tracee = TRACEE(extension);
 
@@ -583,7 +728,8 @@ int care_callback(Extension *extension, ExtensionEvent event,
 			handle_getdents(tracee, true);
 			break;
 
-		case PR_execve: {
+		case PR_execve:
+		case PR_execveat: {
 			word_t result = peek_reg(tracee, CURRENT, SYSARG_RESULT);
 
 			/* Note: this can be done only before PRoot pushes the
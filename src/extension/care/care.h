@@ -55,11 +55,13 @@ typedef struct {
 typedef struct {
 	struct Entry *entries;
 	struct Entry *dentries;
+	struct Entry *outputs;
 
 	char *const *command;
 	List *volatile_paths;
 	List *volatile_envars;
 	List *concealed_accesses;
+	List *written_paths;
 
 	const char *prefix;
 	const char *output;
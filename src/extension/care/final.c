@@ -34,6 +34,7 @@
 #include "extension/care/final.h"
 #include "extension/care/care.h"
 #include "extension/care/extract.h"
+#include "extension/care/sha256.h"
 #include "execve/ldso.h"
 #include "path/path.h"
 #include "path/temp.h"
@@ -94,9 +95,11 @@ static int archive_close_file(const Care *care, FILE *file, const char *name)
 		goto end;
 	}
 
-	status = readlink_proc_pid_fd(getpid(), fd, path);
-	if (status < 0) {
-		note(NULL, ERROR, INTERNAL, "can't readlink(/proc/self/fd/%d)", fd);
+	/* This file has no name, c.f. open_temp_file().  */
+	status = snprintf(path, PATH_MAX, "/proc/self/fd/%d", fd);
+	if (status < 0 || status >= PATH_MAX) {
+		note(NULL, ERROR, INTERNAL, "can't get path to file descriptor %d", fd);
+		status = -1;
 		goto end;
 	}
 
@@ -264,6 +267,40 @@ static int archive_re_execute_sh(Care *care)
 	N("");
 
 	N("status=$?");
+	N("");
+
+	/* Verify mode: compare the exit status and the written files
+	 * against the original execution, c.f. "outputs.sha256".  */
+	N("if [ -n \"$CARE_VERIFY\" ] && [ $nbargs -eq 0 ]; then");
+	N("    divergences=0");
+	N("    if [ $status -ne %d ]; then", care->last_exit_status);
+	N("        echo \"care: verify: exit status is $status instead of %d\"", care->last_exit_status);
+	N("        divergences=$((divergences + 1))");
+	N("    fi");
+	N("    if [ -e \"$(dirname $0)/outputs.sha256\" ]; then");
+	N("        if [ -z \"$(which sha256sum)\" ]; then");
+	N("            echo 'care: verify: \"sha256sum\" command not found'");
+	N("            exit 1");
+	N("        fi");
+	N("        while read -r checksum path; do");
+	N("            if [ ! -f \"$(dirname $0)/rootfs$path\" ]; then");
+	N("                echo \"care: verify: '$path' is missing\"");
+	N("                divergences=$((divergences + 1))");
+	N("            elif [ \"$(sha256sum < \"$(dirname $0)/rootfs$path\" | cut -d ' ' -f 1)\" != $checksum ]; then");
+	N("                echo \"care: verify: '$path' differs\"");
+	N("                divergences=$((divergences + 1))");
+	N("            fi");
+	N("        done < \"$(dirname $0)/outputs.sha256\"");
+	N("    fi");
+	N("    if [ $divergences -ne 0 ]; then");
+	N("        echo \"care: verify: $divergences divergence(s) from the original execution\"");
+	N("        exit 1");
+	N("    fi");
+	N("    echo 'care: verify: the reproduced execution matches the original execution'");
+	N("    exit 0");
+	N("fi");
+	N("");
+
 	N("if [ $status -ne %d ] && [ $nbargs -eq 0 ]; then", care->last_exit_status);
 	N("echo \"care: The reproduced execution didn't return the same exit status as the\"");
 	N("echo \"care: original execution.  If it is unexpected, please report this bug\"");
@@ -305,6 +342,80 @@ static int archive_concealed_accesses_txt(const Care *care)
 	return archive_close_file(care, file, "concealed-accesses.txt");
 }
 
+/**
+ * Check whether @path is -- or is under -- a path from
+ * @care->volatile_paths, its content is then not reproducible.
+ */
+static bool is_volatile_path(const Care *care, const char *path)
+{
+	const Item *item;
+
+	if (care->volatile_paths == NULL)
+		return false;
+
+	STAILQ_FOREACH(item, care->volatile_paths, link) {
+		switch (compare_paths(item->load, path)) {
+		case PATHS_ARE_EQUAL:
+		case PATH1_IS_PREFIX:
+			return true;
+
+		default:
+			break;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Archive the "outputs.sha256" file in @care->archive, that is, the
+ * SHA-256 digest of the final content of each regular file written
+ * during the original execution, in the format of sha256sum(1).
+ * This function returns < 0 if an error occured, 0 otherwise.  Note:
+ * this function is called in @care's destructor.
+ */
+static int archive_outputs_sha256(const Care *care)
+{
+	char checksum[SHA256_STRING_LENGTH];
+	const Item *item;
+	struct stat statl;
+	FILE *file;
+	int status;
+
+	if (care->written_paths == NULL)
+		return 0;
+
+	file = open_temp_file(NULL, "care");
+	if (file == NULL) {
+		note(NULL, WARNING, INTERNAL, "can't create temporary file for 'outputs.sha256'");
+		return -1;
+	}
+
+	STAILQ_FOREACH(item, care->written_paths, link) {
+		const char *path = item->load;
+
+		/* Temporary files were removed, and devices like
+		 * /dev/null have no meaningful content.  */
+		status = lstat(path, &statl);
+		if (status < 0 || !S_ISREG(statl.st_mode))
+			continue;
+
+		/* sha256sum(1) would escape these characters.  */
+		if (strpbrk(path, "\\\n") != NULL || is_volatile_path(care, path))
+			continue;
+
+		status = sha256_file(path, checksum);
+		if (status < 0) {
+			note(NULL, WARNING, INTERNAL, "can't compute the checksum of '%s'", path);
+			continue;
+		}
+
+		N("%s  %s", checksum, path);
+	}
+
+	return archive_close_file(care, file, "outputs.sha256");
+}
+
 /**
  * Archive the "README.txt" file in @care->archive.  This function
  * returns < 0 if an error occured, 0 otherwise.  Note: this function
@@ -351,6 +462,14 @@ static int archive_readme_txt(const Care *care)
 	N("    should be revealed if the the original execution didn't go as");
 	N("    expected.  It is absolutely useless for the reproduced execution.");
 	N("");
+	N("outputs.sha256");
+	N("    checksums of the files written during the original execution.");
+	N("    When CARE_VERIFY is set, re-execute.sh compares them -- and the");
+	N("    exit status -- with the reproduced execution, and reports each");
+	N("    divergence:");
+	N("");
+	N("        $ CARE_VERIFY=1 ./re-execute.sh");
+	N("");
 
 	return archive_close_file(care, file, "README.txt");
 }
@@ -419,6 +538,11 @@ int finalize_care(Care *care)
 	if (status < 0)
 		note(NULL, WARNING, INTERNAL, "can't archive 'concealed-accesses.txt'");
 
+	/* Generate & archive the "outputs.sha256" file. */
+	status = archive_outputs_sha256(care);
+	if (status < 0)
+		note(NULL, WARNING, INTERNAL, "can't archive 'outputs.sha256'");
+
 	/* Generate & archive the "README.txt" file. */
 	status = archive_readme_txt(care);
 	if (status < 0)
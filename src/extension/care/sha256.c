@@ -0,0 +1,199 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <sys/types.h> /* open(2), */
+#include <sys/stat.h>  /* open(2), */
+#include <fcntl.h>     /* open(2), O_*, */
+#include <unistd.h>    /* read(2), close(2), */
+#include <string.h>    /* memcpy(3), memset(3), */
+#include <stdio.h>     /* sprintf(3), */
+#include <errno.h>     /* errno, E*, */
+
+#include "extension/care/sha256.h"
+
+/* SHA-256 as specified in FIPS 180-4.  */
+
+static const uint32_t constants[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+/**
+ * Process the 64-byte @sha256->block.
+ */
+static void process_block(Sha256 *sha256)
+{
+	uint32_t w[64];
+	uint32_t s[8];
+	int i;
+
+	for (i = 0; i < 16; i++)
+		w[i] = (uint32_t) sha256->block[4 * i] << 24
+			| (uint32_t) sha256->block[4 * i + 1] << 16
+			| (uint32_t) sha256->block[4 * i + 2] << 8
+			| (uint32_t) sha256->block[4 * i + 3];
+
+	for (i = 16; i < 64; i++) {
+		uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+		uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	memcpy(s, sha256->state, sizeof(s));
+
+	for (i = 0; i < 64; i++) {
+		uint32_t s1  = ROTR(s[4], 6) ^ ROTR(s[4], 11) ^ ROTR(s[4], 25);
+		uint32_t ch  = (s[4] & s[5]) ^ (~s[4] & s[6]);
+		uint32_t t1  = s[7] + s1 + ch + constants[i] + w[i];
+		uint32_t s0  = ROTR(s[0], 2) ^ ROTR(s[0], 13) ^ ROTR(s[0], 22);
+		uint32_t maj = (s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]);
+		uint32_t t2  = s0 + maj;
+
+		s[7] = s[6];
+		s[6] = s[5];
+		s[5] = s[4];
+		s[4] = s[3] + t1;
+		s[3] = s[2];
+		s[2] = s[1];
+		s[1] = s[0];
+		s[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8; i++)
+		sha256->state[i] += s[i];
+}
+
+void sha256_init(Sha256 *sha256)
+{
+	static const uint32_t initial_state[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+	};
+
+	memcpy(sha256->state, initial_state, sizeof(initial_state));
+	sha256->length = 0;
+	sha256->block_length = 0;
+}
+
+void sha256_update(Sha256 *sha256, const void *data, size_t length)
+{
+	const uint8_t *cursor = data;
+
+	sha256->length += length;
+
+	while (length > 0) {
+		size_t size = sizeof(sha256->block) - sha256->block_length;
+		if (size > length)
+			size = length;
+
+		memcpy(sha256->block + sha256->block_length, cursor, size);
+		sha256->block_length += size;
+		cursor += size;
+		length -= size;
+
+		if (sha256->block_length == sizeof(sha256->block)) {
+			process_block(sha256);
+			sha256->block_length = 0;
+		}
+	}
+}
+
+void sha256_final(Sha256 *sha256, uint8_t digest[SHA256_DIGEST_LENGTH])
+{
+	uint64_t nb_bits = sha256->length * 8;
+	int i;
+
+	/* Padding: a "1" bit, zeros, then the length in bits on 64
+	 * bits, big endian.  */
+	sha256->block[sha256->block_length++] = 0x80;
+	if (sha256->block_length > sizeof(sha256->block) - 8) {
+		memset(sha256->block + sha256->block_length, 0,
+			sizeof(sha256->block) - sha256->block_length);
+		process_block(sha256);
+		sha256->block_length = 0;
+	}
+
+	memset(sha256->block + sha256->block_length, 0,
+		sizeof(sha256->block) - 8 - sha256->block_length);
+	for (i = 0; i < 8; i++)
+		sha256->block[56 + i] = (uint8_t) (nb_bits >> (56 - 8 * i));
+	process_block(sha256);
+
+	for (i = 0; i < 8; i++) {
+		digest[4 * i]     = (uint8_t) (sha256->state[i] >> 24);
+		digest[4 * i + 1] = (uint8_t) (sha256->state[i] >> 16);
+		digest[4 * i + 2] = (uint8_t) (sha256->state[i] >> 8);
+		digest[4 * i + 3] = (uint8_t) sha256->state[i];
+	}
+}
+
+/**
+ * Compute the SHA-256 digest of the content of @path into @string, in
+ * the same form as sha256sum(1).  This function returns -errno if an
+ * error occured, otherwise 0.
+ */
+int sha256_file(const char *path, char string[SHA256_STRING_LENGTH])
+{
+	uint8_t digest[SHA256_DIGEST_LENGTH];
+	uint8_t buffer[64 * 1024];
+	Sha256 sha256;
+	ssize_t size;
+	int fd;
+	int i;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+
+	sha256_init(&sha256);
+
+	while (1) {
+		size = read(fd, buffer, sizeof(buffer));
+		if (size == 0)
+			break;
+
+		if (size < 0) {
+			if (errno == EINTR)
+				continue;
+
+			size = -errno;
+			(void) close(fd);
+			return size;
+		}
+
+		sha256_update(&sha256, buffer, size);
+	}
+
+	(void) close(fd);
+
+	sha256_final(&sha256, digest);
+	for (i = 0; i < SHA256_DIGEST_LENGTH; i++)
+		sprintf(string + 2 * i, "%02x", digest[i]);
+
+	return 0;
+}
@@ -0,0 +1,44 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SHA256_DIGEST_LENGTH 32
+
+/* Hexadecimal form, as printed by sha256sum(1).  */
+#define SHA256_STRING_LENGTH (2 * SHA256_DIGEST_LENGTH + 1)
+
+typedef struct {
+	uint32_t state[8];
+	uint64_t length;
+	uint8_t block[64];
+	size_t block_length;
+} Sha256;
+
+extern void sha256_init(Sha256 *sha256);
+extern void sha256_update(Sha256 *sha256, const void *data, size_t length);
+extern void sha256_final(Sha256 *sha256, uint8_t digest[SHA256_DIGEST_LENGTH]);
+extern int sha256_file(const char *path, char string[SHA256_STRING_LENGTH]);
+
+#endif /* SHA256_H */
@@ -0,0 +1,699 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <stdint.h>        /* uint*_t, */
+#include <stdlib.h>        /* qsort(3), */
+#include <stdio.h>         /* fopen(3), fprintf(3), */
+#include <string.h>        /* str*(3), */
+#include <inttypes.h>      /* PRI*, */
+#include <errno.h>         /* E*, */
+#include <limits.h>        /* PATH_MAX, */
+#include <fcntl.h>         /* O_*, */
+#include <sched.h>         /* CLONE_THREAD, */
+#include <talloc.h>        /* talloc_*, */
+
+#include "extension/extension.h"
+#include "extension/deps/deps.h"
+#include "syscall/syscall.h"
+#include "syscall/sysnum.h"
+#include "tracee/tracee.h"
+#include "tracee/reg.h"
+#include "path/path.h"
+#include "cli/note.h"
+#include "arch.h"
+
+#include "attribute.h"
+
+typedef enum {
+	ACCESS_READ    = 1 << 0,
+	ACCESS_WRITTEN = 1 << 1,
+	ACCESS_CREATED = 1 << 2,
+	ACCESS_DELETED = 1 << 3,
+	ACCESS_MISSING = 1 << 4,
+} Accesses;
+
+static const struct {
+	Accesses access;
+	const char *name;
+} access_names[] = {
+	{ ACCESS_READ,    "read" },
+	{ ACCESS_WRITTEN, "written" },
+	{ ACCESS_CREATED, "created" },
+	{ ACCESS_DELETED, "deleted" },
+	{ ACCESS_MISSING, "missing" },
+};
+
+/* Guest path accessed by a process.  */
+typedef struct entry {
+	struct entry *next;
+	Accesses accesses;
+	char *path;
+} Entry;
+
+/* Accesses of a process, from its creation or its last execve.  */
+typedef struct {
+	uint64_t id;
+	uint64_t parent;
+	uint64_t vpid;
+	char *command;
+
+	/* Hash table of the accessed paths.  */
+	Entry **buckets;
+	size_t nb_entries;
+} Process;
+
+/* State shared by all tracees.  */
+typedef struct {
+	char *output;
+	Process **processes;
+} Tracker;
+
+typedef struct {
+	Tracker *tracker;
+	Process *process;
+
+	/* Host paths translated during the current syscall, and the
+	 * guest path being translated.  */
+	TALLOC_CTX *paths_context;
+	char **paths;
+	char *guest_path;
+} Config;
+
+#define NB_BUCKETS_MIN 64
+
+/* Records of this session, written by write_deps().  */
+static Tracker *tracker = NULL;
+
+/* List of syscalls that use paths, their accesses are recorded once
+ * their result is known.  */
+static FilteredSysnum filtered_sysnums[] = {
+	{ PR_access,		FILTER_SYSEXIT },
+	{ PR_acct,		FILTER_SYSEXIT },
+	{ PR_bind,		FILTER_SYSEXIT },
+	{ PR_chdir,		FILTER_SYSEXIT },
+	{ PR_chmod,		FILTER_SYSEXIT },
+	{ PR_chown,		FILTER_SYSEXIT },
+	{ PR_chown32,		FILTER_SYSEXIT },
+	{ PR_chroot,		FILTER_SYSEXIT },
+	{ PR_connect,		FILTER_SYSEXIT },
+	{ PR_creat,		FILTER_SYSEXIT },
+	{ PR_execve,		FILTER_SYSEXIT },
+	{ PR_execveat,		FILTER_SYSEXIT },
+	{ PR_faccessat,		FILTER_SYSEXIT },
+	{ PR_faccessat2,	FILTER_SYSEXIT },
+	{ PR_fchmodat,		FILTER_SYSEXIT },
+	{ PR_fchmodat2,		FILTER_SYSEXIT },
+	{ PR_fchownat,		FILTER_SYSEXIT },
+	{ PR_fstatat64,		FILTER_SYSEXIT },
+	{ PR_futimesat,		FILTER_SYSEXIT },
+	{ PR_getxattr,		FILTER_SYSEXIT },
+	{ PR_inotify_add_watch,	FILTER_SYSEXIT },
+	{ PR_lchown,		FILTER_SYSEXIT },
+	{ PR_lchown32,		FILTER_SYSEXIT },
+	{ PR_lgetxattr,		FILTER_SYSEXIT },
+	{ PR_link,		FILTER_SYSEXIT },
+	{ PR_linkat,		FILTER_SYSEXIT },
+	{ PR_listxattr,		FILTER_SYSEXIT },
+	{ PR_llistxattr,	FILTER_SYSEXIT },
+	{ PR_lremovexattr,	FILTER_SYSEXIT },
+	{ PR_lsetxattr,		FILTER_SYSEXIT },
+	{ PR_lstat,		FILTER_SYSEXIT },
+	{ PR_lstat64,		FILTER_SYSEXIT },
+	{ PR_mkdir,		FILTER_SYSEXIT },
+	{ PR_mkdirat,		FILTER_SYSEXIT },
+	{ PR_mknod,		FILTER_SYSEXIT },
+	{ PR_mknodat,		FILTER_SYSEXIT },
+	{ PR_mount,		FILTER_SYSEXIT },
+	{ PR_name_to_handle_at,	FILTER_SYSEXIT },
+	{ PR_newfstatat,	FILTER_SYSEXIT },
+	{ PR_oldlstat,		FILTER_SYSEXIT },
+	{ PR_oldstat,		FILTER_SYSEXIT },
+	{ PR_open,		FILTER_SYSEXIT },
+	{ PR_openat,		FILTER_SYSEXIT },
+	{ PR_openat2,		FILTER_SYSEXIT },
+	{ PR_pivot_root,	FILTER_SYSEXIT },
+	{ PR_readlink,		FILTER_SYSEXIT },
+	{ PR_readlinkat,	FILTER_SYSEXIT },
+	{ PR_removexattr,	FILTER_SYSEXIT },
+	{ PR_rename,		FILTER_SYSEXIT },
+	{ PR_renameat,		FILTER_SYSEXIT },
+	{ PR_renameat2,		FILTER_SYSEXIT },
+	{ PR_rmdir,		FILTER_SYSEXIT },
+	{ PR_setxattr,		FILTER_SYSEXIT },
+	{ PR_stat,		FILTER_SYSEXIT },
+	{ PR_stat64,		FILTER_SYSEXIT },
+	{ PR_statfs,		FILTER_SYSEXIT },
+	{ PR_statfs64,		FILTER_SYSEXIT },
+	{ PR_statx,		FILTER_SYSEXIT },
+	{ PR_swapoff,		FILTER_SYSEXIT },
+	{ PR_swapon,		FILTER_SYSEXIT },
+	{ PR_symlink,		FILTER_SYSEXIT },
+	{ PR_symlinkat,		FILTER_SYSEXIT },
+	{ PR_truncate,		FILTER_SYSEXIT },
+	{ PR_truncate64,	FILTER_SYSEXIT },
+	{ PR_umount,		FILTER_SYSEXIT },
+	{ PR_umount2,		FILTER_SYSEXIT },
+	{ PR_unlink,		FILTER_SYSEXIT },
+	{ PR_unlinkat,		FILTER_SYSEXIT },
+	{ PR_uselib,		FILTER_SYSEXIT },
+	{ PR_utime,		FILTER_SYSEXIT },
+	{ PR_utimensat,		FILTER_SYSEXIT },
+	{ PR_utimensat_time64,	FILTER_SYSEXIT },
+	{ PR_utimes,		FILTER_SYSEXIT },
+	FILTERED_SYSNUM_END,
+};
+
+static uint64_t hash_path(const char *path)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (; *path != '\0'; path++)
+		hash = (hash ^ (uint8_t) *path) * 0x100000001b3ULL;
+	return hash;
+}
+
+/**
+ * Add @accesses to the entry for @path in @process, once.
+ */
+static void record_access(Process *process, const char *path, Accesses accesses)
+{
+	size_t nb_buckets;
+	Entry *entry;
+	size_t i;
+
+	nb_buckets = talloc_array_length(process->buckets);
+
+	for (entry = process->buckets[hash_path(path) % nb_buckets]; entry != NULL; entry = entry->next) {
+		if (strcmp(entry->path, path) == 0) {
+			entry->accesses |= accesses;
+			return;
+		}
+	}
+
+	/* Grow the hash table to keep chains short.  */
+	if (process->nb_entries >= 2 * nb_buckets) {
+		Entry **buckets;
+
+		buckets = talloc_zero_array(process, Entry *, 2 * nb_buckets);
+		if (buckets == NULL)
+			return;
+
+		for (i = 0; i < nb_buckets; i++) {
+			Entry *next;
+
+			for (entry = process->buckets[i]; entry != NULL; entry = next) {
+				size_t index = hash_path(entry->path) % (2 * nb_buckets);
+
+				next = entry->next;
+				entry->next = buckets[index];
+				buckets[index] = entry;
+			}
+		}
+
+		TALLOC_FREE(process->buckets);
+		process->buckets = buckets;
+		nb_buckets *= 2;
+	}
+
+	entry = talloc(process, Entry);
+	if (entry == NULL)
+		return;
+
+	entry->path = talloc_strdup(entry, path);
+	if (entry->path == NULL) {
+		TALLOC_FREE(entry);
+		return;
+	}
+	entry->accesses = accesses;
+
+	i = hash_path(path) % nb_buckets;
+	entry->next = process->buckets[i];
+	process->buckets[i] = entry;
+	process->nb_entries++;
+}
+
+/**
+ * Return the accesses already recorded for @path in @process and in
+ * its ancestors from @tracker.
+ */
+static Accesses get_accesses(const Tracker *tracker, const Process *process, const char *path)
+{
+	Accesses accesses = 0;
+	size_t nb_buckets;
+	Entry *entry;
+
+	while (process != NULL) {
+		nb_buckets = talloc_array_length(process->buckets);
+
+		for (entry = process->buckets[hash_path(path) % nb_buckets]; entry != NULL; entry = entry->next) {
+			if (strcmp(entry->path, path) == 0) {
+				accesses |= entry->accesses;
+				break;
+			}
+		}
+
+		process = (process->parent != 0 ? tracker->processes[process->parent - 1] : NULL);
+	}
+
+	return accesses;
+}
+
+/**
+ * Start a new process record in @tracker for @tracee, with the given
+ * @parent record and @command.  This function returns NULL if an
+ * error occured, otherwise the new record.
+ */
+static Process *new_process(Tracker *tracker, const Tracee *tracee,
+			const Process *parent, const char *command)
+{
+	Process *process;
+	size_t nb_processes;
+
+	nb_processes = talloc_array_length(tracker->processes);
+	tracker->processes = talloc_realloc(tracker, tracker->processes, Process *, nb_processes + 1);
+	if (tracker->processes == NULL)
+		return NULL;
+
+	process = talloc_zero(tracker->processes, Process);
+	if (process == NULL)
+		return NULL;
+	tracker->processes[nb_processes] = process;
+
+	process->id      = nb_processes + 1;
+	process->parent  = (parent != NULL ? parent->id : 0);
+	process->vpid    = tracee->vpid;
+	process->command = talloc_strdup(process, command != NULL ? command : "");
+	process->buckets = talloc_zero_array(process, Entry *, NB_BUCKETS_MIN);
+	if (process->command == NULL || process->buckets == NULL)
+		return NULL;
+
+	return process;
+}
+
+/**
+ * Print @string as a JSON string to @file.
+ */
+static void print_json_string(FILE *file, const char *string)
+{
+	fputc('"', file);
+	for (; *string != '\0'; string++) {
+		unsigned char c = *string;
+
+		if (c == '"' || c == '\\')
+			fprintf(file, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(file, "\\u%04x", c);
+		else
+			fputc(c, file);
+	}
+	fputc('"', file);
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+	return strcmp((*(const Entry **) a)->path, (*(const Entry **) b)->path);
+}
+
+/**
+ * Print the record of @process to @file.
+ */
+static void print_process(FILE *file, const Process *process)
+{
+	Entry **entries;
+	size_t nb_entries = 0;
+	size_t i, j;
+
+	fprintf(file, "{\"id\": %" PRIu64 ", \"parent\": %" PRIu64 ", \"pid\": %" PRIu64 ", \"command\": ",
+		process->id, process->parent, process->vpid);
+	print_json_string(file, process->command);
+
+	/* Sort entries to get a stable output.  */
+	entries = talloc_array(NULL, Entry *, process->nb_entries);
+	if (entries != NULL) {
+		for (i = 0; i < talloc_array_length(process->buckets); i++) {
+			Entry *entry;
+
+			for (entry = process->buckets[i]; entry != NULL; entry = entry->next)
+				entries[nb_entries++] = entry;
+		}
+		qsort(entries, nb_entries, sizeof(Entry *), compare_entries);
+	}
+
+	for (i = 0; i < sizeof(access_names) / sizeof(access_names[0]); i++) {
+		bool first = true;
+
+		fprintf(file, ",\n  \"%s\": [", access_names[i].name);
+		for (j = 0; j < nb_entries; j++) {
+			if ((entries[j]->accesses & access_names[i].access) == 0)
+				continue;
+
+			fprintf(file, first ? "" : ", ");
+			print_json_string(file, entries[j]->path);
+			first = false;
+		}
+		fprintf(file, "]");
+	}
+
+	fprintf(file, "}");
+	TALLOC_FREE(entries);
+}
+
+/**
+ * Write all the records of this session to the file given to --deps,
+ * as JSON.  This function returns -1 if an error occurred, otherwise
+ * 0.  It is called once all tracees have terminated.
+ */
+int write_deps(void)
+{
+	FILE *file;
+	size_t i;
+
+	if (tracker == NULL)
+		return 0;
+
+	file = fopen(tracker->output, "w");
+	if (file == NULL) {
+		note(NULL, ERROR, SYSTEM, "can't open '%s'", tracker->output);
+		return -1;
+	}
+
+	fprintf(file, "{\"processes\": [\n");
+	for (i = 0; i < talloc_array_length(tracker->processes); i++) {
+		if (i > 0)
+			fprintf(file, ",\n");
+		print_process(file, tracker->processes[i]);
+	}
+	fprintf(file, "\n]}\n");
+
+	if (fclose(file) != 0) {
+		note(NULL, ERROR, SYSTEM, "can't write '%s'", tracker->output);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Return the flags of the current open-like syscall @sysnum of
+ * @tracee.
+ */
+static word_t get_open_flags(const Tracee *tracee, Sysnum sysnum)
+{
+	OpenHow how;
+
+	switch (sysnum) {
+	case PR_creat:
+		return O_CREAT | O_WRONLY | O_TRUNC;
+
+	case PR_open:
+		return peek_reg(tracee, ORIGINAL, SYSARG_2);
+
+	case PR_openat:
+		return peek_reg(tracee, ORIGINAL, SYSARG_3);
+
+	case PR_openat2:
+		return (get_sysarg_open_how(tracee, ORIGINAL, &how) < 0 ? O_WRONLY : how.flags);
+
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Record the accesses of the current syscall of @tracee, now that
+ * its result is known.
+ */
+static void handle_sysexit_end(Tracee *tracee, Config *config)
+{
+	char path[PATH_MAX];
+	size_t nb_paths;
+	word_t result;
+	word_t flags;
+	Sysnum sysnum;
+	size_t i;
+
+	result = peek_reg(tracee, CURRENT, SYSARG_RESULT);
+	sysnum = get_sysnum(tracee, ORIGINAL);
+	nb_paths = talloc_array_length(config->paths);
+
+	/* Paths probed but missing.  The guest path is recorded as
+	 * is when its translation has failed.  */
+	if ((int) result == -ENOENT || (int) result == -ENOTDIR) {
+		if (config->guest_path != NULL)
+			record_access(config->process, config->guest_path, ACCESS_MISSING);
+		else if (nb_paths > 0) {
+			strcpy(path, config->paths[0]);
+			if (detranslate_path(tracee, path, NULL) >= 0)
+				record_access(config->process, path, ACCESS_MISSING);
+		}
+		return;
+	}
+
+	if ((int) result < 0)
+		return;
+
+	/* A new image starts a new record.  */
+	if (sysnum == PR_execve || sysnum == PR_execveat) {
+		Process *process;
+
+		process = new_process(config->tracker, tracee, config->process, tracee->exe);
+		if (process != NULL)
+			config->process = process;
+	}
+
+	for (i = 0; i < nb_paths; i++) {
+		Accesses accesses;
+
+		strcpy(path, config->paths[i]);
+		if (detranslate_path(tracee, path, NULL) < 0)
+			continue;
+
+		switch (sysnum) {
+		case PR_open:
+		case PR_openat:
+		case PR_openat2:
+		case PR_creat:
+			/* The kernel doesn't tell whether the file was
+			 * created, unless O_EXCL was specified.
+			 * Otherwise, it is assumed so only if it was
+			 * known to be missing by this process or by
+			 * one of its ancestors.  */
+			flags = get_open_flags(tracee, sysnum);
+			if ((flags & O_CREAT) != 0
+			    && (   (flags & O_EXCL) != 0
+				|| (get_accesses(config->tracker, config->process, path) & (ACCESS_MISSING | ACCESS_DELETED)) != 0))
+				accesses = ACCESS_CREATED;
+			else if ((flags & O_ACCMODE) != O_RDONLY || (flags & O_TRUNC) != 0)
+				accesses = ACCESS_WRITTEN;
+			else
+				accesses = ACCESS_READ;
+			break;
+
+		case PR_mkdir:
+		case PR_mkdirat:
+		case PR_mknod:
+		case PR_mknodat:
+		case PR_symlink:
+		case PR_symlinkat:
+			accesses = ACCESS_CREATED;
+			break;
+
+		case PR_link:
+		case PR_linkat:
+			accesses = (i == 0 ? ACCESS_READ : ACCESS_CREATED);
+			break;
+
+		case PR_rename:
+		case PR_renameat:
+		case PR_renameat2:
+			accesses = (i == 0 ? ACCESS_DELETED : ACCESS_CREATED);
+			break;
+
+		case PR_rmdir:
+		case PR_unlink:
+		case PR_unlinkat:
+			accesses = ACCESS_DELETED;
+			break;
+
+		case PR_chmod:
+		case PR_chown:
+		case PR_chown32:
+		case PR_fchmodat:
+		case PR_fchownat:
+		case PR_futimesat:
+		case PR_lchown:
+		case PR_lchown32:
+		case PR_lremovexattr:
+		case PR_lsetxattr:
+		case PR_removexattr:
+		case PR_setxattr:
+		case PR_truncate:
+		case PR_truncate64:
+		case PR_utime:
+		case PR_utimensat:
+		case PR_utimensat_time64:
+		case PR_utimes:
+			accesses = ACCESS_WRITTEN;
+			break;
+
+		default:
+			accesses = ACCESS_READ;
+			break;
+		}
+
+		record_access(config->process, path, accesses);
+	}
+}
+
+/**
+ * Handler for this @extension.  It is triggered each time an @event
+ * occured.  See ExtensionEvent for the meaning of @data1 and @data2.
+ */
+int deps_callback(Extension *extension, ExtensionEvent event,
+		intptr_t data1, intptr_t data2)
+{
+	switch (event) {
+	case INITIALIZATION: {
+		Tracee *tracee = TRACEE(extension);
+		Config *config;
+
+		extension->config = talloc_zero(extension, Config);
+		if (extension->config == NULL)
+			return -1;
+		config = extension->config;
+
+		/* The records outlive the tracees, c.f. write_deps().  */
+		tracker = talloc_zero(talloc_autofree_context(), Tracker);
+		if (tracker == NULL)
+			return -1;
+
+		tracker->output = talloc_strdup(tracker, (const char *) data1);
+		if (tracker->output == NULL) {
+			TALLOC_FREE(tracker);
+			return -1;
+		}
+
+		config->tracker = tracker;
+		config->process = new_process(config->tracker, tracee, NULL, NULL);
+		if (config->process == NULL) {
+			TALLOC_FREE(tracker);
+			return -1;
+		}
+
+		extension->filtered_sysnums = filtered_sysnums;
+		return 0;
+	}
+
+	case INHERIT_PARENT: /* Inheritable for sub reconfiguration ...  */
+		return 1;
+
+	case INHERIT_CHILD: {
+		Extension *parent = (Extension *) data1;
+		Config *parent_config = talloc_get_type_abort(parent->config, Config);
+		word_t clone_flags = (word_t) data2;
+		Config *config;
+
+		extension->config = talloc_zero(extension, Config);
+		if (extension->config == NULL)
+			return -1;
+		config = extension->config;
+
+		config->tracker = parent_config->tracker;
+
+		/* Threads share the record of their process.  */
+		if (clone_flags == CLONE_RECONF || (clone_flags & CLONE_THREAD) != 0)
+			config->process = parent_config->process;
+		else
+			config->process = new_process(config->tracker, TRACEE(extension),
+						parent_config->process, parent_config->process->command);
+		if (config->process == NULL)
+			return -1;
+
+		return 0;
+	}
+
+	case SYSCALL_ENTER_START: {
+		Config *config = talloc_get_type_abort(extension->config, Config);
+
+		TALLOC_FREE(config->paths_context);
+		config->paths = NULL;
+		config->guest_path = NULL;
+		return 0;
+	}
+
+	case GUEST_PATH: {
+		Tracee *tracee = TRACEE(extension);
+		Config *config = talloc_get_type_abort(extension->config, Config);
+		char path[PATH_MAX];
+
+		/* Paths translated by PRoot at the exit stage, for
+		 * its own use, are not tracked.  */
+		if (!IS_IN_SYSENTER(tracee))
+			return 0;
+
+		if (config->paths_context == NULL) {
+			config->paths_context = talloc_new(config);
+			if (config->paths_context == NULL)
+				return 0;
+		}
+
+		if (join_paths(2, path, (const char *) data1, (const char *) data2) < 0)
+			return 0;
+
+		config->guest_path = talloc_strdup(config->paths_context, path);
+		return 0;
+	}
+
+	case TRANSLATED_PATH: {
+		Config *config = talloc_get_type_abort(extension->config, Config);
+		size_t nb_paths;
+
+		if (config->paths_context == NULL)
+			return 0;
+
+		nb_paths = talloc_array_length(config->paths);
+		config->paths = talloc_realloc(config->paths_context, config->paths, char *, nb_paths + 1);
+		if (config->paths == NULL)
+			return 0;
+
+		config->paths[nb_paths] = talloc_strdup(config->paths, (const char *) data1);
+		config->guest_path = NULL;
+		return 0;
+	}
+
+	case SYSCALL_EXIT_END: {
+		Tracee *tracee = TRACEE(extension);
+		Config *config = talloc_get_type_abort(extension->config, Config);
+
+		if (config->paths_context == NULL)
+			return 0;
+
+		handle_sysexit_end(tracee, config);
+
+		TALLOC_FREE(config->paths_context);
+		config->paths = NULL;
+		config->guest_path = NULL;
+		return 0;
+	}
+
+	default:
+		return 0;
+	}
+}
@@ -168,3 +168,29 @@ void inherit_extensions(Tracee *child, Tracee *parent, word_t clone_flags)
 		}
 	}
 }
+
+/**
+ * Check if any extension of @tracee requested the exit stage of the
+ * syscall @sysnum, see FILTER_SYSEXIT.
+ */
+bool extensions_filter_sysexit(const Tracee *tracee, Sysnum sysnum)
+{
+	const Extension *extension;
+	size_t i;
+
+	if (tracee->extensions == NULL)
+		return false;
+
+	LIST_FOREACH(extension, tracee->extensions, link) {
+		if (extension->filtered_sysnums == NULL)
+			continue;
+
+		for (i = 0; extension->filtered_sysnums[i].value != PR_void; i++) {
+			if (   extension->filtered_sysnums[i].value == sysnum
+			    && (extension->filtered_sysnums[i].flags & FILTER_SYSEXIT) != 0)
+				return true;
+		}
+	}
+
+	return false;
+}
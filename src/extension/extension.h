@@ -164,6 +164,7 @@ typedef LIST_HEAD(extensions, extension) Extensions;
 extern int initialize_extension(Tracee *tracee, extension_callback_t callback, const char *cli);
 extern void inherit_extensions(Tracee *child, Tracee *parent, word_t clone_flags);
 extern Extension *get_extension(Tracee *tracee, extension_callback_t callback);
+extern bool extensions_filter_sysexit(const Tracee *tracee, Sysnum sysnum);
 
 /**
  * Notify all extensions of @tracee that the given @event occured.
@@ -192,6 +193,8 @@ extern int fake_id0_callback(Extension *extension, ExtensionEvent event, intptr_
 extern int care_callback(Extension *extension, ExtensionEvent event, intptr_t d1, intptr_t d2);
 extern int python_callback(Extension *extension, ExtensionEvent event, intptr_t d1, intptr_t d2);
 extern int link2symlink_callback(Extension *extension, ExtensionEvent event, intptr_t d1, intptr_t d2);
+extern int deps_callback(Extension *extension, ExtensionEvent event, intptr_t d1, intptr_t d2);
+extern int reproducible_callback(Extension *extension, ExtensionEvent event, intptr_t d1, intptr_t d2);
 
 /* Added extensions.  */
 /**
@@ -31,6 +31,10 @@
 #include <string.h>      /* memcpy(3), */
 #include <stdlib.h>      /* strtol(3), */
 #include <linux/auxvec.h>/* AT_,  */
+#include <sys/mount.h>   /* MS_*, */
+#include <fcntl.h>       /* AT_FDCWD, */
+#include <sys/xattr.h>   /* *xattr(2), */
+#include <linux/limits.h>/* XATTR_*, */
 
 #include "extension/extension.h"
 #include "syscall/syscall.h"
@@ -42,7 +46,12 @@
 #include "tracee/mem.h"
 #include "execve/auxv.h"
 #include "path/binding.h"
+#include "path/path.h"
+#include "path/temp.h"
+#include "extension/fake_id0/xattr.h"
+#include "cli/note.h"
 #include "arch.h"
+#include "compat.h"
 
 typedef struct {
 	uid_t ruid;
@@ -54,6 +63,13 @@ typedef struct {
 	gid_t egid;
 	gid_t sgid;
 	gid_t fsgid;
+
+	/* File whose virtual extended attributes are dropped if the
+	 * current unlink(2) & co. succeeds, c.f. xattr.c.  */
+	struct {
+		bool pending;
+		struct stat statl;
+	} removed;
 } Config;
 
 typedef struct {
@@ -69,11 +85,15 @@ static FilteredSysnum filtered_sysnums[] = {
 	{ PR_chown32,		FILTER_SYSEXIT },
 	{ PR_chroot,		FILTER_SYSEXIT },
 	{ PR_execve,		FILTER_SYSEXIT },
+	{ PR_execveat,		FILTER_SYSEXIT },
 	{ PR_fchmod,		FILTER_SYSEXIT },
 	{ PR_fchmodat,		FILTER_SYSEXIT },
 	{ PR_fchown,		FILTER_SYSEXIT },
 	{ PR_fchown32,		FILTER_SYSEXIT },
 	{ PR_fchownat,		FILTER_SYSEXIT },
+	{ PR_fgetxattr,		FILTER_SYSEXIT },
+	{ PR_flistxattr,	FILTER_SYSEXIT },
+	{ PR_fremovexattr,	FILTER_SYSEXIT },
 	{ PR_fstat,		FILTER_SYSEXIT },
 	{ PR_fstat,		FILTER_SYSEXIT },
 	{ PR_fstat64,		FILTER_SYSEXIT },
@@ -92,15 +112,26 @@ static FilteredSysnum filtered_sysnums[] = {
 	{ PR_getresuid32,	FILTER_SYSEXIT },
 	{ PR_getuid,		FILTER_SYSEXIT },
 	{ PR_getuid32,		FILTER_SYSEXIT },
+	{ PR_getxattr,		FILTER_SYSEXIT },
 	{ PR_lchown,		FILTER_SYSEXIT },
 	{ PR_lchown32,		FILTER_SYSEXIT },
+	{ PR_lgetxattr,		FILTER_SYSEXIT },
+	{ PR_listxattr,		FILTER_SYSEXIT },
+	{ PR_llistxattr,	FILTER_SYSEXIT },
+	{ PR_lremovexattr,	FILTER_SYSEXIT },
 	{ PR_lstat,		FILTER_SYSEXIT },
 	{ PR_lstat64,		FILTER_SYSEXIT },
 	{ PR_mknod,		FILTER_SYSEXIT },
 	{ PR_mknodat,		FILTER_SYSEXIT },
+	{ PR_mount,		FILTER_SYSEXIT },
 	{ PR_newfstatat,	FILTER_SYSEXIT },
 	{ PR_oldlstat,		FILTER_SYSEXIT },
 	{ PR_oldstat,		FILTER_SYSEXIT },
+	{ PR_removexattr,	FILTER_SYSEXIT },
+	{ PR_rename,		0 },
+	{ PR_renameat,		0 },
+	{ PR_renameat2,		0 },
+	{ PR_rmdir,		0 },
 	{ PR_setfsgid,		FILTER_SYSEXIT },
 	{ PR_setfsgid32,	FILTER_SYSEXIT },
 	{ PR_setfsuid,		FILTER_SYSEXIT },
@@ -129,6 +160,10 @@ static FilteredSysnum filtered_sysnums[] = {
 	{ PR_stat64,		FILTER_SYSEXIT },
 	{ PR_statfs,		FILTER_SYSEXIT },
 	{ PR_statfs64,		FILTER_SYSEXIT },
+	{ PR_umount,		FILTER_SYSEXIT },
+	{ PR_umount2,		FILTER_SYSEXIT },
+	{ PR_unlink,		0 },
+	{ PR_unlinkat,		0 },
 	FILTERED_SYSNUM_END,
 };
 
@@ -231,11 +266,96 @@ static void override_permissions(const Tracee *tracee, const char *path, bool is
 	return;
 }
 
+/**
+ * Remember in @config the file about to be removed by the current
+ * unlink(2), rmdir(2), or rename(2) of @tracee -- if this is its
+ * last link and it has virtual extended attributes -- so that these
+ * latter are dropped if the syscall succeeds.  Otherwise, a new file
+ * might inherit them once its inode number is reused.  The exit
+ * stage of this syscall is requested only in this case.
+ */
+static void prepare_virtual_xattrs_removal(Tracee *tracee, Config *config, word_t sysnum)
+{
+	char path[PATH_MAX];
+	struct stat statl;
+	Reg sysarg;
+	int status;
+
+	config->removed.pending = false;
+
+	/* Don't pay for an lstat(2) if this session never got any
+	 * virtual extended attribute.  */
+	if (!has_any_virtual_xattr())
+		return;
+
+	switch (sysnum) {
+	case PR_unlink:
+	case PR_rmdir:
+		sysarg = SYSARG_1;
+		break;
+
+	case PR_unlinkat:
+	case PR_rename:
+		sysarg = SYSARG_2;
+		break;
+
+	case PR_renameat2:
+		/* Both files are kept alive.  */
+		if ((peek_reg(tracee, ORIGINAL, SYSARG_5) & RENAME_EXCHANGE) != 0)
+			return;
+		/* Fall through.  */
+	case PR_renameat:
+		sysarg = SYSARG_4;
+		break;
+
+	default:
+		assert(0);
+	}
+
+	status = read_path(tracee, path, peek_reg(tracee, CURRENT, sysarg));
+	if (status < 0)
+		return;
+
+	status = lstat(path, &config->removed.statl);
+	if (status < 0)
+		return;
+
+	/* The file is kept alive by its other links.  */
+	if (!S_ISDIR(config->removed.statl.st_mode) && config->removed.statl.st_nlink > 1)
+		return;
+
+	/* Renaming a file onto itself has no effect.  */
+	if (sysnum == PR_rename || sysnum == PR_renameat || sysnum == PR_renameat2) {
+		sysarg = (sysnum == PR_rename ? SYSARG_1 : SYSARG_2);
+
+		status = read_path(tracee, path, peek_reg(tracee, CURRENT, sysarg));
+		if (status < 0)
+			return;
+
+		status = lstat(path, &statl);
+		if (status < 0
+		    || (   statl.st_dev == config->removed.statl.st_dev
+			&& statl.st_ino == config->removed.statl.st_ino))
+			return;
+	}
+
+	config->removed.pending = has_virtual_xattrs(&config->removed.statl);
+	if (!config->removed.pending)
+		return;
+
+	/* These syscalls are not filtered at the exit stage, c.f.
+	 * filtered_sysnums, so ask for it explicitly.  */
+	if (tracee->seccomp == ENABLED) {
+		tracee->restart_how = PTRACE_SYSCALL;
+		tracee->sysexit_pending = true;
+	}
+}
+
 /**
  * Adjust current @tracee's syscall parameters according to @config.
  * This function always returns 0.
  */
-static int handle_sysenter_end(Tracee *tracee, const Config *config)
+static int handle_sysenter_end(Tracee *tracee, Config *config)
 {
 	word_t sysnum;
 
@@ -295,6 +415,33 @@ static int handle_sysenter_end(Tracee *tracee, const Config *config)
 		return 0;
 	}
 
+	case PR_chroot:
+		/* This syscall is fully emulated if the tracee was
+		 * supposed to have the capability, see
+		 * handle_sysexit_end().  */
+		if (config->euid == 0) /* TODO: || HAS_CAP(SYS_CHROOT) */
+			set_sysnum(tracee, PR_void);
+		return 0;
+
+	case PR_mount:
+	case PR_umount:
+	case PR_umount2:
+		/* These syscalls are emulated with bindings if the
+		 * tracee was supposed to have the capability, see
+		 * handle_sysexit_end().  */
+		if (config->euid == 0) /* TODO: || HAS_CAP(SYS_ADMIN) */
+			set_sysnum(tracee, PR_void);
+		return 0;
+
+	case PR_unlink:
+	case PR_unlinkat:
+	case PR_rmdir:
+	case PR_rename:
+	case PR_renameat:
+	case PR_renameat2:
+		prepare_virtual_xattrs_removal(tracee, config, sysnum);
+		return 0;
+
 	case PR_setgroups:
 	case PR_setgroups32:
 	case PR_getgroups:
@@ -501,6 +648,397 @@ static int handle_sysenter_end(Tracee *tracee, const Config *config)
 	return 0;							\
 } while (0)
 
+/**
+ * Emulate mount(2) for the current @tracee with bindings: bind
+ * mounts, tmpfs (backed by a temporary directory) and pseudo
+ * file-systems (backed by their host counterpart) are supported,
+ * whereas remounts and changes of the propagation type are accepted
+ * without any effect.  This function returns -errno if an error
+ * occured, otherwise 0.
+ */
+static int emulate_mount(Tracee *tracee)
+{
+	char source[PATH_MAX];
+	char target[PATH_MAX];
+	char path[PATH_MAX];
+	const char *fstype = NULL;
+	const char *temp_directory = NULL;
+	struct stat statl;
+	Binding *binding;
+	word_t flags;
+	int status;
+
+	flags = peek_reg(tracee, ORIGINAL, SYSARG_4);
+	if ((flags & (MS_REMOUNT | MS_SHARED | MS_PRIVATE | MS_SLAVE | MS_UNBINDABLE)) != 0)
+		return 0;
+
+	status = read_path(tracee, target, peek_reg(tracee, MODIFIED, SYSARG_2));
+	if (status < 0)
+		return status;
+
+	status = stat(target, &statl);
+	if (status < 0)
+		return -errno;
+
+	if ((flags & MS_BIND) != 0) {
+		bool is_directory = S_ISDIR(statl.st_mode);
+
+		fstype = "none";
+
+		/* The source was not translated by
+		 * translate_syscall_enter() if it is a relative path
+		 * that doesn't start with '.'.  */
+		status = read_path(tracee, path, peek_reg(tracee, ORIGINAL, SYSARG_1));
+		if (status < 0)
+			return status;
+
+		status = translate_path(tracee, source, AT_FDCWD, path, true);
+		if (status < 0)
+			return status;
+
+		status = stat(source, &statl);
+		if (status < 0)
+			return -errno;
+
+		if (S_ISDIR(statl.st_mode) != is_directory)
+			return -ENOTDIR;
+	}
+	else {
+		status = read_string(tracee, path, peek_reg(tracee, ORIGINAL, SYSARG_3), NAME_MAX);
+		if (status < 0)
+			return status;
+		if (status >= NAME_MAX)
+			return -ENODEV;
+
+		if (!S_ISDIR(statl.st_mode))
+			return -ENOTDIR;
+
+		if (strcmp(path, "tmpfs") == 0) {
+			fstype = "tmpfs";
+			temp_directory = create_temp_directory(tracee->ctx, "proot-tmpfs");
+			if (temp_directory == NULL)
+				return -ENOMEM;
+			strcpy(source, temp_directory);
+
+			/* Default mode of a tmpfs root.  */
+			(void) chmod(source, 01777);
+		}
+		else if (strcmp(path, "proc") == 0) {
+			fstype = "proc";
+			strcpy(source, "/proc");
+		}
+		else if (strcmp(path, "sysfs") == 0) {
+			fstype = "sysfs";
+			strcpy(source, "/sys");
+		}
+		else
+			return -ENODEV;
+	}
+
+	/* The target is expressed from the guest point-of-view
+	 * since bindings are.  */
+	chop_finality(target);
+	status = detranslate_path(tracee, target, NULL);
+	if (status < 0)
+		return status;
+
+	/* The rootfs can't be covered since it is used as a
+	 * reference by all other bindings.  */
+	if (compare_paths(target, "/") == PATHS_ARE_EQUAL)
+		return -EBUSY;
+
+	/* Like any other bindings, this one is visible to all
+	 * processes that share the same lists of bindings, that is,
+	 * all processes that didn't call chroot(2) in the meantime.  */
+	binding = insort_binding3(tracee, tracee->ctx, source, target);
+	if (binding == NULL)
+		return -ENOMEM;
+	binding->fstype = fstype;
+
+	/* The temporary directory is removed once unmounted.  */
+	if (temp_directory != NULL)
+		talloc_reparent(tracee->ctx, binding, temp_directory);
+
+	VERBOSE(tracee, 1, "mount: %s:%s", source, target);
+
+	return 0;
+}
+
+/**
+ * Emulate umount(2) for the current @tracee, only emulated mounts
+ * and bindings can be unmounted.  This function returns -errno if an
+ * error occured, otherwise 0.
+ */
+static int emulate_umount(Tracee *tracee)
+{
+	char path[PATH_MAX];
+	Binding *binding;
+	int status;
+
+	status = read_path(tracee, path, peek_reg(tracee, MODIFIED, SYSARG_1));
+	if (status < 0)
+		return status;
+
+	chop_finality(path);
+	status = detranslate_path(tracee, path, NULL);
+	if (status < 0)
+		return status;
+
+	if (compare_paths(path, "/") == PATHS_ARE_EQUAL)
+		return -EBUSY;
+
+	binding = get_binding(tracee, GUEST, path);
+	if (binding == NULL || compare_paths(binding->guest.path, path) != PATHS_ARE_EQUAL)
+		return -EINVAL;
+
+	VERBOSE(tracee, 1, "umount: %s:%s", binding->host.path, binding->guest.path);
+
+	/* The binding is released once it doesn't belong to any
+	 * list anymore.  */
+	remove_binding_from_all_lists(tracee, binding);
+
+	return 0;
+}
+
+/* List of extended attribute names, as returned by list*xattr(2).  */
+typedef struct {
+	char *names;
+	size_t length;
+} XattrList;
+
+/**
+ * Add @name to the list of extended attributes pointed to by @data
+ * if it is not there yet.  This list is freed -- and its names set to
+ * NULL -- if an error occurred.
+ *
+ * Note: this is a callback for foreach_virtual_xattr().
+ */
+static void append_xattr_name(void *data, const char *name,
+			const void *value UNUSED, size_t size UNUSED)
+{
+	XattrList *list = data;
+	size_t name_size = strlen(name) + 1;
+	char *names;
+	size_t i;
+
+	if (list->names == NULL)
+		return;
+
+	for (i = 0; i < list->length; i += strlen(list->names + i) + 1) {
+		if (strcmp(list->names + i, name) == 0)
+			return;
+	}
+
+	names = talloc_realloc_size(talloc_parent(list->names), list->names,
+				list->length + name_size);
+	if (names == NULL) {
+		TALLOC_FREE(list->names);
+		return;
+	}
+
+	memcpy(names + list->length, name, name_size);
+	list->names = names;
+	list->length += name_size;
+}
+
+/**
+ * Merge the virtual extended attributes of the file described by
+ * @statl -- and whose host path is @path -- into the result of
+ * list*xattr(2).  This function returns -errno if an error occurred,
+ * otherwise 0.
+ */
+static int emulate_listxattr(Tracee *tracee, word_t sysnum, const char path[PATH_MAX],
+			const struct stat *statl)
+{
+	XattrList list;
+	word_t address;
+	word_t size;
+	ssize_t length;
+
+	address = peek_reg(tracee, ORIGINAL, SYSARG_2);
+	size    = peek_reg(tracee, ORIGINAL, SYSARG_3);
+
+	/* Get the actual list of attributes, it might be empty.  */
+	length = (sysnum == PR_llistxattr ? llistxattr(path, NULL, 0) : listxattr(path, NULL, 0));
+	if (length < 0)
+		return 0;
+
+	list.names = talloc_size(tracee->ctx, length + 1);
+	if (list.names == NULL)
+		return -ENOMEM;
+
+	length = (sysnum == PR_llistxattr
+		? llistxattr(path, list.names, length)
+		: listxattr(path, list.names, length));
+	if (length < 0)
+		return 0;
+	list.length = length;
+
+	foreach_virtual_xattr(statl, append_xattr_name, &list);
+	if (list.names == NULL)
+		return -ENOMEM;
+
+	if (size != 0) {
+		if (size < list.length)
+			return -ERANGE;
+
+		if (write_data(tracee, address, list.names, list.length) < 0)
+			return -EFAULT;
+	}
+
+	poke_reg(tracee, SYSARG_RESULT, list.length);
+	return 0;
+}
+
+/**
+ * Emulate the extended attributes that require privileges -- file
+ * capabilities for instance -- since they can't be set for real by
+ * unprivileged users.  They are stored on the side, c.f. xattr.c.
+ * This function returns -errno if an error occurred, otherwise 0.
+ */
+static int emulate_xattr(Tracee *tracee, const Config *config, word_t sysnum)
+{
+	char name[XATTR_NAME_MAX + 1];
+	char path[PATH_MAX];
+	struct stat statl;
+	const void *value;
+	word_t result;
+	word_t address;
+	word_t size;
+	int status;
+
+	/* An error was reported during the translation.  */
+	if (tracee->status < 0)
+		return 0;
+
+	result = peek_reg(tracee, CURRENT, SYSARG_RESULT);
+
+	/* Get the identity of the host file.  */
+	switch (sysnum) {
+	case PR_fsetxattr:
+	case PR_fgetxattr:
+	case PR_flistxattr:
+	case PR_fremovexattr:
+		status = snprintf(path, PATH_MAX, "/proc/%d/fd/%d", tracee->pid,
+				(int) peek_reg(tracee, ORIGINAL, SYSARG_1));
+		if (status < 0 || status >= PATH_MAX)
+			return 0;
+		status = stat(path, &statl);
+		break;
+
+	case PR_lsetxattr:
+	case PR_lgetxattr:
+	case PR_llistxattr:
+	case PR_lremovexattr:
+		status = read_path(tracee, path, peek_reg(tracee, MODIFIED, SYSARG_1));
+		if (status < 0)
+			return 0;
+		status = lstat(path, &statl);
+		break;
+
+	default:
+		status = read_path(tracee, path, peek_reg(tracee, MODIFIED, SYSARG_1));
+		if (status < 0)
+			return 0;
+		status = stat(path, &statl);
+		break;
+	}
+	if (status < 0)
+		return 0;
+
+	if (sysnum == PR_listxattr || sysnum == PR_llistxattr || sysnum == PR_flistxattr)
+		return emulate_listxattr(tracee, sysnum, path, &statl);
+
+	status = read_string(tracee, name, peek_reg(tracee, ORIGINAL, SYSARG_2), sizeof(name));
+	if (status < 0 || (size_t) status > sizeof(name))
+		return 0;
+	name[sizeof(name) - 1] = '\0';
+
+	switch (sysnum) {
+	case PR_setxattr:
+	case PR_lsetxattr:
+	case PR_fsetxattr: {
+		void *buffer;
+
+		/* Override only permission errors.  */
+		if ((int) result != -EPERM)
+			return 0;
+
+		/* The tracee was not supposed to have the
+		 * capability.  */
+		if (config->euid != 0) /* TODO: || HAS_CAP(...) */
+			return 0;
+
+		/* Other attributes are silently dropped.  */
+		if (!is_virtual_xattr(name)) {
+			poke_reg(tracee, SYSARG_RESULT, 0);
+			return 0;
+		}
+
+		size = peek_reg(tracee, ORIGINAL, SYSARG_4);
+		if (size > XATTR_SIZE_MAX)
+			return -E2BIG;
+
+		buffer = talloc_size(tracee->ctx, size ?: 1);
+		if (buffer == NULL)
+			return -ENOMEM;
+
+		status = read_data(tracee, buffer, peek_reg(tracee, ORIGINAL, SYSARG_3), size);
+		if (status < 0)
+			return status;
+
+		status = set_virtual_xattr(&statl, name, buffer, size,
+					peek_reg(tracee, ORIGINAL, SYSARG_5));
+		if (status < 0)
+			return status;
+
+		poke_reg(tracee, SYSARG_RESULT, 0);
+		return 0;
+	}
+
+	case PR_getxattr:
+	case PR_lgetxattr:
+	case PR_fgetxattr:
+		if (!is_virtual_xattr(name))
+			return 0;
+
+		status = get_virtual_xattr(&statl, name, &value, &size);
+		if (status < 0)
+			return 0;
+
+		address = peek_reg(tracee, ORIGINAL, SYSARG_3);
+		if (peek_reg(tracee, ORIGINAL, SYSARG_4) != 0) {
+			if (peek_reg(tracee, ORIGINAL, SYSARG_4) < size)
+				return -ERANGE;
+
+			status = write_data(tracee, address, value, size);
+			if (status < 0)
+				return status;
+		}
+
+		poke_reg(tracee, SYSARG_RESULT, size);
+		return 0;
+
+	case PR_removexattr:
+	case PR_lremovexattr:
+	case PR_fremovexattr:
+		if (!is_virtual_xattr(name))
+			return 0;
+
+		status = remove_virtual_xattr(&statl, name);
+		if (status == -ENODATA)
+			return 0;
+		if (status < 0)
+			return status;
+
+		poke_reg(tracee, SYSARG_RESULT, 0);
+		return 0;
+
+	default:
+		assert(0);
+	}
+}
+
 /**
  * Adjust current @tracee's syscall result according to @config.  This
  * function returns -errno if an error occured, otherwise 0.
@@ -586,9 +1124,6 @@ static int handle_sysexit_end(Tracee *tracee, Config *config)
 	case PR_mknod:
 	case PR_mknodat:
 	case PR_capset:
-	case PR_setxattr:
-	case PR_lsetxattr:
-	case PR_fsetxattr:
 	case PR_chmod:
 	case PR_chown:
 	case PR_fchmod:
@@ -614,6 +1149,37 @@ static int handle_sysexit_end(Tracee *tracee, Config *config)
 		return 0;
 	}
 
+	case PR_setxattr:
+	case PR_lsetxattr:
+	case PR_fsetxattr:
+	case PR_getxattr:
+	case PR_lgetxattr:
+	case PR_fgetxattr:
+	case PR_listxattr:
+	case PR_llistxattr:
+	case PR_flistxattr:
+	case PR_removexattr:
+	case PR_lremovexattr:
+	case PR_fremovexattr:
+		return emulate_xattr(tracee, config, sysnum);
+
+	case PR_unlink:
+	case PR_unlinkat:
+	case PR_rmdir:
+	case PR_rename:
+	case PR_renameat:
+	case PR_renameat2:
+		if (!config->removed.pending)
+			return 0;
+		config->removed.pending = false;
+
+		result = peek_reg(tracee, CURRENT, SYSARG_RESULT);
+		if ((int) result < 0)
+			return 0;
+
+		(void) remove_virtual_xattrs(&config->removed.statl);
+		return 0;
+
 	case PR_fstatat64:
 	case PR_newfstatat:
 	case PR_stat64:
@@ -678,16 +1244,15 @@ static int handle_sysexit_end(Tracee *tracee, Config *config)
 
 	case PR_chroot: {
 		char path[PATH_MAX];
-		char abspath[PATH_MAX];
+		struct stat statl;
 		word_t input;
 		int status;
 
 		if (config->euid != 0) /* TODO: && !HAS_CAP(SYS_CHROOT) */
 			return 0;
 
-		/* Override only permission errors.  */
-		result = peek_reg(tracee, CURRENT, SYSARG_RESULT);
-		if ((int) result != -EPERM)
+		/* An error was reported during the translation.  */
+		if (tracee->status < 0)
 			return 0;
 
 		input = peek_reg(tracee, MODIFIED, SYSARG_1);
@@ -696,16 +1261,46 @@ static int handle_sysexit_end(Tracee *tracee, Config *config)
 		if (status < 0)
 			return status;
 
-		/* Resolve relative path segments. */
-		if (!realpath(path, abspath))
+		status = stat(path, &statl);
+		if (status < 0)
+			return -errno;
+
+		if (!S_ISDIR(statl.st_mode))
+			return -ENOTDIR;
+
+		/* Remove the trailing "/" or "/." as expected by
+		 * change_root().  */
+		chop_finality(path);
+
+		/* The new root applies to this tracee and to its
+		 * future children.  */
+		status = change_root(tracee, path);
+		if (status < 0)
+			return status;
+
+		poke_reg(tracee, SYSARG_RESULT, 0);
+		return 0;
+	}
+
+	case PR_mount:
+	case PR_umount:
+	case PR_umount2: {
+		int status;
+
+		if (config->euid != 0) /* TODO: && !HAS_CAP(SYS_ADMIN) */
 			return 0;
 
-		/* Only "new rootfs == current rootfs" is supported yet.  */
-		status = compare_paths(get_root(tracee), abspath);
-		if (status != PATHS_ARE_EQUAL)
+		/* An error was reported during the translation.  */
+		if (tracee->status < 0)
 			return 0;
 
-		/* Force success.  */
+		if (sysnum == PR_mount)
+			status = emulate_mount(tracee);
+		else
+			status = emulate_umount(tracee);
+		if (status < 0)
+			return status;
+
 		poke_reg(tracee, SYSARG_RESULT, 0);
 		return 0;
 	}
@@ -877,7 +1472,7 @@ int fake_id0_callback(Extension *extension, ExtensionEvent event, intptr_t data1
 		struct stat mode;
 		int status;
 
-		if ((int) result < 0 || sysnum != PR_execve)
+		if ((int) result < 0 || (sysnum != PR_execve && sysnum != PR_execveat))
 			return 0;
 
 		/* This has to be done before PRoot pushes the load
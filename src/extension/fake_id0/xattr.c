@@ -0,0 +1,390 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <sys/types.h>   /* dev_t, ino_t, */
+#include <sys/stat.h>    /* struct stat, */
+#include <sys/xattr.h>   /* XATTR_*, */
+#include <stdio.h>       /* fopen(3), fprintf(3), getline(3), */
+#include <stdlib.h>      /* getenv(3), mkstemp(3), */
+#include <string.h>      /* str*(3), mem*(3), */
+#include <unistd.h>      /* close(2), */
+#include <errno.h>       /* E*, */
+#include <ctype.h>       /* isspace(3), isxdigit(3), */
+#include <talloc.h>      /* talloc*, */
+
+#include "extension/fake_id0/xattr.h"
+#include "cli/note.h"
+
+/* Extended attribute that can't be set by unprivileged users, hence
+ * stored by PRoot on behalf of the tracees.  */
+typedef struct virtual_xattr {
+	/* Identity of the host file it is attached to.  */
+	dev_t dev;
+	ino_t ino;
+
+	char *name;
+	void *value;
+	size_t size;
+
+	struct virtual_xattr *next;
+} VirtualXattr;
+
+static struct {
+	VirtualXattr *head;
+	const char *path;
+	bool loaded;
+} store = { NULL, NULL, false };
+
+/**
+ * Check whether the extended attribute @name requires privileges
+ * that unprivileged users don't have, namely CAP_SETFCAP or
+ * CAP_SYS_ADMIN.
+ */
+bool is_virtual_xattr(const char *name)
+{
+	const char *cursor;
+
+	if (   strncmp(name, "security.", strlen("security.")) != 0
+	    && strncmp(name, "trusted.", strlen("trusted.")) != 0)
+		return false;
+
+	/* Such names couldn't be saved, c.f. save_store().  */
+	for (cursor = name; *cursor != '\0'; cursor++) {
+		if (isspace((unsigned char) *cursor))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Add a new entry to the store, or return NULL if an error occurred.
+ */
+static VirtualXattr *new_virtual_xattr(dev_t dev, ino_t ino, const char *name,
+				const void *value, size_t size)
+{
+	VirtualXattr *xattr;
+
+	xattr = talloc_zero(talloc_autofree_context(), VirtualXattr);
+	if (xattr == NULL)
+		return NULL;
+
+	xattr->dev  = dev;
+	xattr->ino  = ino;
+	xattr->name = talloc_strdup(xattr, name);
+	xattr->value = talloc_memdup(xattr, value, size ?: 1);
+	xattr->size = size;
+	if (xattr->name == NULL || xattr->value == NULL) {
+		TALLOC_FREE(xattr);
+		return NULL;
+	}
+
+	xattr->next = store.head;
+	store.head = xattr;
+
+	return xattr;
+}
+
+/**
+ * Load the store from the file pointed to by the PROOT_XATTR_STORE
+ * environment variable, if any.  Each line of this file describes an
+ * attribute: "<dev> <inode> <name> 0x<hexadecimal value>".
+ */
+static void load_store()
+{
+	unsigned long long dev;
+	unsigned long long ino;
+	char name[256];
+	char *line = NULL;
+	size_t line_size = 0;
+	unsigned char *value;
+	size_t size;
+	FILE *file;
+	int offset;
+	size_t i;
+
+	if (store.loaded)
+		return;
+	store.loaded = true;
+
+	store.path = getenv("PROOT_XATTR_STORE");
+	if (store.path == NULL)
+		return;
+
+	file = fopen(store.path, "r");
+	if (file == NULL) {
+		if (errno != ENOENT)
+			note(NULL, WARNING, SYSTEM, "can't open '%s'", store.path);
+		return;
+	}
+
+	while (getline(&line, &line_size, file) > 0) {
+		offset = -1;
+		(void) sscanf(line, "%llu %llu %255s 0x%n", &dev, &ino, name, &offset);
+		if (offset < 0) {
+			note(NULL, WARNING, USER, "%s: malformed line '%s'", store.path, line);
+			continue;
+		}
+
+		for (size = 0; isxdigit((unsigned char) line[offset + 2 * size])
+			     && isxdigit((unsigned char) line[offset + 2 * size + 1]); size++)
+			;
+
+		value = talloc_size(NULL, size ?: 1);
+		if (value == NULL)
+			break;
+
+		for (i = 0; i < size; i++)
+			(void) sscanf(line + offset + 2 * i, "%2hhx", &value[i]);
+
+		if (new_virtual_xattr(dev, ino, name, value, size) == NULL)
+			note(NULL, WARNING, INTERNAL, "can't allocate memory");
+
+		TALLOC_FREE(value);
+	}
+
+	free(line);
+	(void) fclose(file);
+}
+
+/**
+ * Save the store into the file pointed to by the PROOT_XATTR_STORE
+ * environment variable, if any.  This file is replaced atomically.
+ * This function returns -errno if an error occurred, otherwise 0.
+ */
+static int save_store()
+{
+	const VirtualXattr *xattr;
+	char *temp_path;
+	FILE *file;
+	size_t i;
+	int fd;
+
+	if (store.path == NULL)
+		return 0;
+
+	temp_path = talloc_asprintf(NULL, "%s.XXXXXX", store.path);
+	if (temp_path == NULL)
+		return -ENOMEM;
+
+	fd = mkstemp(temp_path);
+	if (fd < 0)
+		goto error;
+
+	file = fdopen(fd, "w");
+	if (file == NULL) {
+		close(fd);
+		goto error;
+	}
+
+	for (xattr = store.head; xattr != NULL; xattr = xattr->next) {
+		fprintf(file, "%llu %llu %s 0x", (unsigned long long) xattr->dev,
+			(unsigned long long) xattr->ino, xattr->name);
+		for (i = 0; i < xattr->size; i++)
+			fprintf(file, "%02x", ((unsigned char *) xattr->value)[i]);
+		fprintf(file, "\n");
+	}
+
+	if (fclose(file) != 0 || rename(temp_path, store.path) != 0)
+		goto error;
+
+	TALLOC_FREE(temp_path);
+	return 0;
+
+error:
+	note(NULL, ERROR, SYSTEM, "can't save extended attributes into '%s'", store.path);
+	(void) unlink(temp_path);
+	TALLOC_FREE(temp_path);
+	return -EIO;
+}
+
+/**
+ * Return the pointer to the pointer to the attribute @name of the file
+ * described by @statl, or to the NULL pointer that ends the store.
+ */
+static VirtualXattr **find_virtual_xattr(const struct stat *statl, const char *name)
+{
+	VirtualXattr **xattr;
+
+	load_store();
+
+	for (xattr = &store.head; *xattr != NULL; xattr = &(*xattr)->next) {
+		if (   (*xattr)->ino == statl->st_ino
+		    && (*xattr)->dev == statl->st_dev
+		    && strcmp((*xattr)->name, name) == 0)
+			break;
+	}
+
+	return xattr;
+}
+
+/**
+ * Make *@value point to the value of the attribute @name of the file
+ * described by @statl, and put its size into *@size.  This function
+ * returns -ENODATA if there's no such attribute, otherwise 0.
+ */
+int get_virtual_xattr(const struct stat *statl, const char *name,
+		const void **value, size_t *size)
+{
+	const VirtualXattr *xattr;
+
+	xattr = *find_virtual_xattr(statl, name);
+	if (xattr == NULL)
+		return -ENODATA;
+
+	*value = xattr->value;
+	*size  = xattr->size;
+	return 0;
+}
+
+/**
+ * Set the attribute @name of the file described by @statl to @value
+ * (@size bytes), with respect to @flags, as setxattr(2) does.  This
+ * function returns -errno if an error occurred, otherwise 0.
+ */
+int set_virtual_xattr(const struct stat *statl, const char *name,
+		const void *value, size_t size, int flags)
+{
+	VirtualXattr **xattr;
+	void *new_value;
+
+	xattr = find_virtual_xattr(statl, name);
+
+	if (*xattr == NULL) {
+		if ((flags & XATTR_REPLACE) != 0)
+			return -ENODATA;
+
+		if (new_virtual_xattr(statl->st_dev, statl->st_ino, name, value, size) == NULL)
+			return -ENOMEM;
+	}
+	else {
+		if ((flags & XATTR_CREATE) != 0)
+			return -EEXIST;
+
+		new_value = talloc_memdup(*xattr, value, size ?: 1);
+		if (new_value == NULL)
+			return -ENOMEM;
+
+		TALLOC_FREE((*xattr)->value);
+		(*xattr)->value = new_value;
+		(*xattr)->size  = size;
+	}
+
+	return save_store();
+}
+
+/**
+ * Remove the attribute @name of the file described by @statl.  This
+ * function returns -ENODATA if there's no such attribute, -errno if
+ * an error occurred, otherwise 0.
+ */
+int remove_virtual_xattr(const struct stat *statl, const char *name)
+{
+	VirtualXattr **xattr;
+	VirtualXattr *next;
+
+	xattr = find_virtual_xattr(statl, name);
+	if (*xattr == NULL)
+		return -ENODATA;
+
+	next = (*xattr)->next;
+	TALLOC_FREE(*xattr);
+	*xattr = next;
+
+	return save_store();
+}
+
+/**
+ * Check whether at least one attribute was stored, either by this
+ * session or by a previous one.
+ */
+bool has_any_virtual_xattr(void)
+{
+	load_store();
+	return store.head != NULL;
+}
+
+/**
+ * Check whether the file described by @statl has at least one
+ * attribute.
+ */
+bool has_virtual_xattrs(const struct stat *statl)
+{
+	const VirtualXattr *xattr;
+
+	load_store();
+
+	for (xattr = store.head; xattr != NULL; xattr = xattr->next) {
+		if (xattr->ino == statl->st_ino && xattr->dev == statl->st_dev)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Remove all the attributes of the file described by @statl.  This
+ * function returns -ENODATA if there's no such attribute, -errno if
+ * an error occurred, otherwise 0.
+ */
+int remove_virtual_xattrs(const struct stat *statl)
+{
+	VirtualXattr **xattr;
+	VirtualXattr *next;
+	bool removed = false;
+
+	load_store();
+
+	xattr = &store.head;
+	while (*xattr != NULL) {
+		if ((*xattr)->ino != statl->st_ino || (*xattr)->dev != statl->st_dev) {
+			xattr = &(*xattr)->next;
+			continue;
+		}
+
+		next = (*xattr)->next;
+		TALLOC_FREE(*xattr);
+		*xattr = next;
+		removed = true;
+	}
+
+	if (!removed)
+		return -ENODATA;
+
+	return save_store();
+}
+
+/**
+ * Call @callback for each attribute of the file described by
+ * @statl, with @data as first argument.
+ */
+void foreach_virtual_xattr(const struct stat *statl, VirtualXattrCallback callback, void *data)
+{
+	const VirtualXattr *xattr;
+
+	load_store();
+
+	for (xattr = store.head; xattr != NULL; xattr = xattr->next) {
+		if (xattr->ino == statl->st_ino && xattr->dev == statl->st_dev)
+			callback(data, xattr->name, xattr->value, xattr->size);
+	}
+}
@@ -0,0 +1,44 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef FAKE_ID0_XATTR_H
+#define FAKE_ID0_XATTR_H
+
+#include <sys/stat.h>  /* struct stat, */
+#include <stdbool.h>   /* bool, */
+
+typedef void (*VirtualXattrCallback)(void *data, const char *name,
+				const void *value, size_t size);
+
+extern bool is_virtual_xattr(const char *name);
+extern int get_virtual_xattr(const struct stat *statl, const char *name,
+			const void **value, size_t *size);
+extern int set_virtual_xattr(const struct stat *statl, const char *name,
+			const void *value, size_t size, int flags);
+extern int remove_virtual_xattr(const struct stat *statl, const char *name);
+extern bool has_any_virtual_xattr(void);
+extern bool has_virtual_xattrs(const struct stat *statl);
+extern int remove_virtual_xattrs(const struct stat *statl);
+extern void foreach_virtual_xattr(const struct stat *statl,
+				VirtualXattrCallback callback, void *data);
+
+#endif /* FAKE_ID0_XATTR_H */
@@ -42,6 +42,7 @@
 #include "tracee/reg.h"
 #include "tracee/abi.h"
 #include "tracee/mem.h"
+#include "tracee/features.h"
 #include "execve/auxv.h"
 #include "cli/note.h"
 #include "arch.h"
@@ -116,31 +117,6 @@ static bool modify_syscall(Tracee *tracee, const Config *config, const Modif *mo
 	return true;
 }
 
-/**
- * Return the numeric value for the given kernel @release.
- */
-static int parse_kernel_release(const char *release)
-{
-	unsigned long major = 0;
-	unsigned long minor = 0;
-	unsigned long revision = 0;
-	char *cursor = (char *)release;
-
-	major = strtoul(cursor, &cursor, 10);
-
-	if (*cursor == '.') {
-		cursor++;
-		minor = strtoul(cursor, &cursor, 10);
-	}
-
-	if (*cursor == '.') {
-		cursor++;
-		revision = strtoul(cursor, &cursor, 10);
-	}
-
-	return KERNEL_VERSION(major, minor, revision);
-}
-
 /**
  * Remove @discarded_flags from the given @tracee's @sysarg register
  * if the actual kernel release is not compatible with the
@@ -894,16 +870,12 @@ static int handle_sysexit_end(Tracee *tracee, Config *config)
  */
 static int parse_utsname(Config *config, const char *string)
 {
-	struct utsname utsname;
-	int status;
-
 	assert(string != NULL);
 
-	status = uname(&utsname);
-	if (status < 0 || getenv("PROOT_FORCE_KOMPAT") != NULL)
+	if (getenv("PROOT_FORCE_KOMPAT") != NULL)
 		config->actual_release = 0;
 	else
-		config->actual_release = parse_kernel_release(utsname.release);
+		config->actual_release = kernel_profile.release;
 
 	/* Check whether it is the simple format (ie. release number),
 	 * or the complex one:
@@ -955,8 +927,14 @@ static int parse_utsname(Config *config, const char *string)
 		}
 	}
 	else {
+		struct utsname utsname;
 		size_t length;
 
+		if (uname(&utsname) < 0) {
+			note(NULL, ERROR, SYSTEM, "can't get the kernel release");
+			return -1;
+		}
+
 		memcpy(&config->utsname, &utsname, sizeof(config->utsname));
 
 		length = MIN(strlen(string), sizeof(config->utsname.release) - 1);
@@ -979,6 +957,7 @@ static FilteredSysnum filtered_sysnums[] = {
 	{ PR_epoll_pwait, 	0 },
 	{ PR_eventfd2, 		FILTER_SYSEXIT },
 	{ PR_execve, 		FILTER_SYSEXIT },
+	{ PR_execveat,		FILTER_SYSEXIT },
 	{ PR_faccessat, 	0 },
 	{ PR_fchmodat, 		0 },
 	{ PR_fchownat, 		0 },
@@ -1063,7 +1042,7 @@ int kompat_callback(Extension *extension, ExtensionEvent event,
 
 		/* Note: this can be done only before PRoot pushes the
 		 * load script into tracee's stack.  */
-		if ((int) result >= 0 && sysnum == PR_execve)
+		if ((int) result >= 0 && (sysnum == PR_execve || sysnum == PR_execveat))
 			adjust_elf_auxv(tracee, config);
 		return 0;
 	}
@@ -82,7 +82,6 @@ uint16_t get_index(PortMap *portmap, uint16_t key)
  */
 int add_entry(PortMap *portmap, uint16_t port_in, uint16_t port_out)
 {
-	Tracee *tracee = TRACEE(global_portmap_extension);
 	uint16_t index = get_index(portmap, port_in);
 
 	/* no available entry has been found */
@@ -92,8 +91,6 @@ int add_entry(PortMap *portmap, uint16_t port_in, uint16_t port_out)
 	portmap->map[index].port_in = port_in;
 	portmap->map[index].port_out = port_out;
 
-	VERBOSE(tracee, PORTMAP_VERBOSITY, "new port mapping entry: %d -> %d", ntohs(port_in), ntohs(port_out));
-
 	return 0;
 }
 
@@ -5,10 +5,14 @@
 #include <stdint.h>         /* intptr_t, */
 #include <stdlib.h>         /* strtoul(3), */
 #include <string.h>			/* memset */
+#include <stddef.h>         /* offsetof, */
 #include <sys/un.h>         /* strncpy */
 #include <sys/socket.h>	    /* AF_UNIX, AF_INET */
 #include <arpa/inet.h>      /* inet_ntop */
 #include <linux/net.h>   	/* SYS_*, */
+#include <unistd.h>         /* close(2), getpid(2), */
+#include <stdio.h>          /* fopen(3), fprintf(3), rename(2), */
+#include <talloc.h>         /* talloc_*, */
 #include "cli/note.h"
 #include "extension/extension.h"
 #include "tracee/mem.h"     /* read_data */
@@ -19,12 +23,89 @@ Extension *global_portmap_extension = NULL;
 
 typedef struct Config {
 	PortMap portmap;
+	PortMap reverse_portmap;  /* port_out -> port_in */
 	bool netcoop_mode;
+	bool auto_mode;
+	uint16_t auto_first_port;  /* host byte order */
+	uint16_t auto_last_port;   /* host byte order */
+	const char *portmap_file;
 	bool need_to_check_new_port;
 	uint16_t old_port;
 	word_t sockfd;
 } Config;
 
+/**
+ * Let the system pick a port of the given address @family that is
+ * currently free for both TCP and UDP.  Return this port in network
+ * byte order, or PORTMAP_DEFAULT_VALUE if none was found.
+ */
+static uint16_t allocate_port(int family)
+{
+	struct sockaddr_storage sockaddr;
+	uint16_t port = PORTMAP_DEFAULT_VALUE;
+	socklen_t size;
+	int stream_fd;
+	int dgram_fd;
+	int i;
+
+	for (i = 0; i < 8 && port == PORTMAP_DEFAULT_VALUE; i++) {
+		memset(&sockaddr, '\0', sizeof(sockaddr));
+		sockaddr.ss_family = family;
+		size = (family == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
+
+		stream_fd = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (stream_fd < 0)
+			break;
+
+		if (   bind(stream_fd, (struct sockaddr *) &sockaddr, size) < 0
+		    || getsockname(stream_fd, (struct sockaddr *) &sockaddr, &size) < 0) {
+			close(stream_fd);
+			break;
+		}
+
+		dgram_fd = socket(family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+		if (dgram_fd >= 0 && bind(dgram_fd, (struct sockaddr *) &sockaddr, size) == 0)
+			port = (family == AF_INET6
+				? ((struct sockaddr_in6 *) &sockaddr)->sin6_port
+				: ((struct sockaddr_in *) &sockaddr)->sin_port);
+
+		if (dgram_fd >= 0)
+			close(dgram_fd);
+		close(stream_fd);
+	}
+
+	return port;
+}
+
+/**
+ * Return the port mapped to @port_in, both in network byte order.  In
+ * automatic mode, a new mapping is created the first time a port in
+ * the configured range is bound.
+ */
+static uint16_t get_or_allocate_port(Tracee *tracee, Config *config, uint16_t port_in, int family, bool bind_mode)
+{
+	uint16_t port_out;
+
+	port_out = get_port(&config->portmap, port_in);
+	if (port_out != PORTMAP_DEFAULT_VALUE
+	    || !bind_mode
+	    || !config->auto_mode
+	    || ntohs(port_in) < config->auto_first_port
+	    || ntohs(port_in) > config->auto_last_port)
+		return port_out;
+
+	port_out = allocate_port(family);
+	if (port_out == PORTMAP_DEFAULT_VALUE) {
+		VERBOSE(tracee, PORTMAP_VERBOSITY, "can't allocate a port for %d", ntohs(port_in));
+		return port_out;
+	}
+
+	if (add_portmap_entry(ntohs(port_in), ntohs(port_out)) < 0)
+		return PORTMAP_DEFAULT_VALUE;
+
+	return port_out;
+}
+
 /**
  * Change the port of the socket address, if it maps with an entry.
  * Return 0 if no relevant entry is found, and 1 if the port has been changed.
@@ -33,7 +114,7 @@ int change_inet_socket_port(Tracee *tracee, Config *config, word_t sockfd, struc
 	uint16_t port_in, port_out;
 
 	port_in = sockaddr->sin_port;
-	port_out = get_port(&config->portmap, port_in);
+	port_out = get_or_allocate_port(tracee, config, port_in, AF_INET, bind_mode);
 
 	if(port_out == PORTMAP_DEFAULT_VALUE) {
 		if (bind_mode && config->netcoop_mode && !config->need_to_check_new_port) {
@@ -63,7 +144,7 @@ int change_inet6_socket_port(Tracee *tracee, Config *config, word_t sockfd, stru
 	uint16_t port_in, port_out;
 
 	port_in = sockaddr->sin6_port;
-	port_out = get_port(&config->portmap, port_in);
+	port_out = get_or_allocate_port(tracee, config, port_in, AF_INET6, bind_mode);
 
 	if(port_out == PORTMAP_DEFAULT_VALUE) {
 		if (bind_mode && config->netcoop_mode && !config->need_to_check_new_port) {
@@ -464,6 +545,138 @@ static int handle_syschained_exit(Tracee *tracee, Config *config)
 	}
 }
 
+/**
+ * Replace the port of the socket address returned at @sock_addr --
+ * its size is at @size_addr -- with the one used by the guest, if
+ * this is the host side of a mapping.
+ */
+static int detranslate_port(Tracee *tracee, Config *config, word_t sock_addr, word_t size_addr)
+{
+	struct sockaddr_in sockaddr;
+	socklen_t size;
+	uint16_t port_in;
+	int status;
+
+	if (sock_addr == 0 || size_addr == 0)
+		return 0;
+
+	status = read_data(tracee, &size, size_addr, sizeof(size));
+	if (status < 0)
+		return status;
+
+	/* Only the family and the port are needed, they lie at the
+	 * same offsets in sockaddr_in and sockaddr_in6.  */
+	if (size < offsetof(struct sockaddr_in, sin_addr))
+		return 0;
+
+	status = read_data(tracee, &sockaddr, sock_addr, offsetof(struct sockaddr_in, sin_addr));
+	if (status < 0)
+		return status;
+
+	if (sockaddr.sin_family != AF_INET && sockaddr.sin_family != AF_INET6)
+		return 0;
+
+	port_in = get_port(&config->reverse_portmap, sockaddr.sin_port);
+	if (port_in == PORTMAP_DEFAULT_VALUE)
+		return 0;
+
+	VERBOSE(tracee, PORTMAP_VERBOSITY, "port detranslation: %d -> %d", ntohs(sockaddr.sin_port), ntohs(port_in));
+
+	return write_data(tracee, sock_addr + offsetof(struct sockaddr_in, sin_port), &port_in, sizeof(port_in));
+}
+
+/**
+ * Make the addresses returned by accept(), getsockname(), and
+ * getpeername() report the ports as seen by the guest, this is only
+ * required in automatic mode since the guest can't know the ports
+ * allocated for it.
+ */
+static int handle_sysexit_end(Tracee *tracee, Config *config)
+{
+	word_t args_addr;
+	word_t call;
+
+	if ((int) peek_reg(tracee, CURRENT, SYSARG_RESULT) < 0)
+		return 0;
+
+	switch (get_sysnum(tracee, ORIGINAL)) {
+	case PR_accept:
+	case PR_accept4:
+	case PR_getsockname:
+	case PR_getpeername:
+		return detranslate_port(tracee, config,
+					peek_reg(tracee, ORIGINAL, SYSARG_2),
+					peek_reg(tracee, ORIGINAL, SYSARG_3));
+
+	case PR_socketcall: {
+		word_t sock_addr;
+		word_t size_addr;
+
+		call = peek_reg(tracee, ORIGINAL, SYSARG_1);
+		if (call != SYS_ACCEPT && call != SYS_ACCEPT4
+		    && call != SYS_GETSOCKNAME && call != SYS_GETPEERNAME)
+			return 0;
+
+		args_addr = peek_reg(tracee, ORIGINAL, SYSARG_2);
+
+		sock_addr = peek_word(tracee, args_addr + 1 * sizeof_word(tracee));
+		if (errno != 0)
+			return 0;
+
+		size_addr = peek_word(tracee, args_addr + 2 * sizeof_word(tracee));
+		if (errno != 0)
+			return 0;
+
+		return detranslate_port(tracee, config, sock_addr, size_addr);
+	}
+
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Write the port map into the file specified by the user, one
+ * "port_in port_out" entry per line, so that programs running outside
+ * of PRoot can reach the services of the guest.
+ */
+static void write_portmap_file(const Config *config)
+{
+	char *tmp_path;
+	FILE *file;
+	int i;
+
+	if (config->portmap_file == NULL)
+		return;
+
+	tmp_path = talloc_asprintf(NULL, "%s.%d", config->portmap_file, getpid());
+	if (tmp_path == NULL)
+		return;
+
+	file = fopen(tmp_path, "w");
+	if (file == NULL)
+		goto error;
+
+	for (i = 0; i < PORTMAP_SIZE; i++) {
+		const PortMapEntry *entry = &config->portmap.map[i];
+
+		if (entry->port_in != PORTMAP_DEFAULT_VALUE)
+			fprintf(file, "%d %d\n", ntohs(entry->port_in), ntohs(entry->port_out));
+	}
+
+	/* Replace the file atomically, readers never see a partial map.  */
+	if (fclose(file) != 0 || rename(tmp_path, config->portmap_file) < 0)
+		goto error;
+
+	talloc_free(tmp_path);
+	return;
+
+error:
+	note(TRACEE(global_portmap_extension), WARNING, SYSTEM, "can't write '%s'", config->portmap_file);
+	(void) unlink(tmp_path);
+	talloc_free(tmp_path);
+}
+
 /* List of syscalls handled by this extension.  */
 static FilteredSysnum filtered_sysnums[] = {
 	{ PR_bind,         0 },
@@ -474,13 +687,40 @@ static FilteredSysnum filtered_sysnums[] = {
 	FILTERED_SYSNUM_END,
 };
 
+/* List of syscalls handled by this extension in automatic mode.  */
+static FilteredSysnum auto_filtered_sysnums[] = {
+	{ PR_accept,       FILTER_SYSEXIT },
+	{ PR_accept4,      FILTER_SYSEXIT },
+	{ PR_bind,         0 },
+	{ PR_connect,      0 },
+	{ PR_getpeername,  FILTER_SYSEXIT },
+	{ PR_getsockname,  FILTER_SYSEXIT },
+	{ PR_listen,       FILTER_SYSEXIT },
+	{ PR_socketcall,   FILTER_SYSEXIT },
+	FILTERED_SYSNUM_END,
+};
+
 int add_portmap_entry(uint16_t port_in, uint16_t port_out) {
 	if(global_portmap_extension == NULL)
 		return 0;
 	else {
 		Config *config = talloc_get_type_abort(global_portmap_extension->config, Config);
+		int status;
+
 		/* careful with little/big endian numbers */
-		return add_entry(&config->portmap, ntohs(port_in), ntohs(port_out));
+		status = add_entry(&config->portmap, htons(port_in), htons(port_out));
+		if (status < 0)
+			return status;
+
+		status = add_entry(&config->reverse_portmap, htons(port_out), htons(port_in));
+		if (status < 0)
+			return status;
+
+		VERBOSE(TRACEE(global_portmap_extension), PORTMAP_VERBOSITY,
+			"new port mapping entry: %d -> %d", port_in, port_out);
+
+		write_portmap_file(config);
+		return 0;
 	}
 }
 
@@ -493,6 +733,37 @@ int activate_netcoop_mode() {
 	return 0;
 }
 
+/**
+ * Map automatically the ports from @first_port to @last_port -- in
+ * host byte order -- to free ports, the first time they are bound.
+ */
+int activate_auto_mode(uint16_t first_port, uint16_t last_port) {
+	if(global_portmap_extension != NULL) {
+		Config *config = talloc_get_type_abort(global_portmap_extension->config, Config);
+		config->auto_mode = true;
+		config->auto_first_port = first_port;
+		config->auto_last_port = last_port;
+		global_portmap_extension->filtered_sysnums = auto_filtered_sysnums;
+	}
+
+	return 0;
+}
+
+/**
+ * Keep the port map written in the file at @path.
+ */
+int set_portmap_file(const char *path) {
+	if(global_portmap_extension != NULL) {
+		Config *config = talloc_get_type_abort(global_portmap_extension->config, Config);
+		config->portmap_file = talloc_strdup(config, path);
+		if (config->portmap_file == NULL)
+			return -1;
+		write_portmap_file(config);
+	}
+
+	return 0;
+}
+
 /**
  * Handler for this @extension.  It is triggered each time an @event
  * occured.  See ExtensionEvent for the meaning of @data1 and @data2.
@@ -513,6 +784,7 @@ int portmap_callback(Extension *extension, ExtensionEvent event,
 
 		config = talloc_get_type_abort(extension->config, Config);
 		initialize_portmap(&config->portmap);
+		initialize_portmap(&config->reverse_portmap);
 		config->netcoop_mode = false;
 		config->need_to_check_new_port = false;
 		config->sockfd = 0;
@@ -530,6 +802,15 @@ int portmap_callback(Extension *extension, ExtensionEvent event,
 		Config *config = talloc_get_type_abort(extension->config, Config);
 		return handle_sysenter_end(tracee, config);
 	}
+	case SYSCALL_EXIT_END: {
+		Tracee *tracee = TRACEE(extension);
+		Config *config = talloc_get_type_abort(extension->config, Config);
+
+		if (!config->auto_mode)
+			return 0;
+
+		return handle_sysexit_end(tracee, config);
+	}
 	case SYSCALL_CHAINED_EXIT: {
 		Tracee *tracee = TRACEE(extension);
 		Config *config = talloc_get_type_abort(extension->config, Config);
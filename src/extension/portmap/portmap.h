@@ -28,5 +28,7 @@ uint16_t get_port(PortMap *portmap, uint16_t port_in);
 
 int add_portmap_entry(uint16_t port_in, uint16_t port_out);
 int activate_netcoop_mode();
+int activate_auto_mode(uint16_t first_port, uint16_t last_port);
+int set_portmap_file(const char *path);
 
 #endif /* PORTMAP_H */
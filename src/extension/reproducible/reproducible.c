@@ -0,0 +1,627 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <stdint.h>        /* uint*_t, */
+#include <stdlib.h>        /* getenv(3), strtoll(3), qsort(3), */
+#include <stdio.h>         /* fopen(3), fgets(3), sscanf(3), */
+#include <string.h>        /* str*(3), memcpy(3), */
+#include <stddef.h>        /* offsetof, */
+#include <time.h>          /* time(2), */
+#include <errno.h>         /* E*, */
+#include <limits.h>        /* PATH_MAX, */
+#include <dirent.h>        /* opendir(3), readdir(3), */
+#include <sys/stat.h>      /* struct stat, */
+#include <sys/utsname.h>   /* struct utsname, */
+#include <linux/auxvec.h>  /* AT_*, */
+#include <talloc.h>        /* talloc_*, */
+
+#include "extension/extension.h"
+#include "syscall/syscall.h"
+#include "syscall/sysnum.h"
+#include "tracee/tracee.h"
+#include "tracee/reg.h"
+#include "tracee/abi.h"
+#include "tracee/mem.h"
+#include "execve/auxv.h"
+#include "cli/note.h"
+#include "arch.h"
+
+#include "attribute.h"
+#include "compat.h"
+
+/* Size of the buffer pointed to by AT_RANDOM.  */
+#define AT_RANDOM_SIZE 16
+
+typedef struct {
+	char *name;
+	uint64_t inode;
+	int64_t offset;
+	uint8_t type;
+} Entry;
+
+/* Sorted entries of a directory opened by the tracee.  */
+typedef struct {
+	int fd;
+	size_t cursor;
+	size_t nb_entries;
+	Entry *entries;
+
+	/* Kernel position of the file descriptor after the last
+	 * getdents64 on this directory.  */
+	int64_t position;
+} Directory;
+
+/* Layout of "struct linux_dirent64", it doesn't depend on the ABI.  */
+typedef struct {
+	uint64_t inode;
+	int64_t  next;
+	uint16_t size;
+	uint8_t  type;
+	char name[];
+} Dirent64;
+
+typedef struct {
+	/* State of the pseudo-random generator of this tracee.  */
+	uint64_t random;
+
+	/* Number of children this tracee has created so far.  */
+	uint64_t nb_children;
+
+	/* Timestamps newer than the start of the session are
+	 * reported as @epoch, if @pin_timestamps is true.  */
+	bool pin_timestamps;
+	time_t epoch;
+	time_t start;
+
+	/* Directories read by this tracee.  */
+	Directory **directories;
+
+	/* Kernel position of the file descriptor when the current
+	 * getdents64 started.  */
+	int64_t position;
+} Config;
+
+/**
+ * Return the next pseudo-random number from @state (SplitMix64).
+ */
+static uint64_t next_random(uint64_t *state)
+{
+	uint64_t value;
+
+	value = (*state += 0x9e3779b97f4a7c15ULL);
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+/**
+ * Overwrite the @size bytes at @address in @tracee's memory with the
+ * next pseudo-random bytes from @config.  This function returns
+ * -errno if an error occured, otherwise 0.
+ */
+static int write_random(Tracee *tracee, Config *config, word_t address, size_t size)
+{
+	uint8_t *buffer;
+	uint64_t value = 0;
+	size_t i;
+
+	buffer = talloc_size(tracee->ctx, size);
+	if (buffer == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i < size; i++) {
+		if (i % sizeof(value) == 0)
+			value = next_random(&config->random);
+		buffer[i] = value >> (8 * (i % sizeof(value)));
+	}
+
+	return write_data(tracee, address, buffer, size);
+}
+
+/**
+ * Overwrite the bytes pointed to by the AT_RANDOM auxiliary vector
+ * of @tracee, as expected right after a successful call to execve(2).
+ */
+static void adjust_at_random(Tracee *tracee, Config *config)
+{
+	ElfAuxVector *vectors;
+	ElfAuxVector *vector;
+	word_t vectors_address;
+	int status;
+
+	vectors_address = get_elf_aux_vectors_address(tracee);
+	if (vectors_address == 0)
+		return;
+
+	vectors = fetch_elf_aux_vectors(tracee, vectors_address);
+	if (vectors == NULL)
+		return;
+
+	for (vector = vectors; vector->type != AT_NULL; vector++) {
+		if (vector->type != AT_RANDOM || vector->value == 0)
+			continue;
+
+		status = write_random(tracee, config, vector->value, AT_RANDOM_SIZE);
+		if (status < 0)
+			note(tracee, WARNING, INTERNAL, "can't seed AT_RANDOM");
+		break;
+	}
+}
+
+/**
+ * Replace the host-specific fields of the utsname structure pointed
+ * to by the first argument of @tracee's current syscall.
+ */
+static int adjust_utsname(Tracee *tracee)
+{
+	struct utsname utsname;
+	word_t address;
+	int status;
+
+	address = peek_reg(tracee, ORIGINAL, SYSARG_1);
+
+	/* The layout of struct utsname doesn't depend on the ABI.  */
+	status = read_data(tracee, &utsname, address, sizeof(utsname));
+	if (status < 0)
+		return status;
+
+	strcpy(utsname.nodename, "localhost");
+	strcpy(utsname.version, "#1 SMP");
+	strcpy(utsname.domainname, "(none)");
+
+	return write_data(tracee, address, &utsname, sizeof(utsname));
+}
+
+/**
+ * Pin the "struct statx_timestamp" at @address in @tracee's memory if
+ * it is newer than the start of the session.
+ */
+static void pin_statx_timestamp(Tracee *tracee, const Config *config, word_t address)
+{
+	int64_t seconds;
+
+	seconds = peek_int64(tracee, address);
+	if (errno != 0 || seconds < config->start)
+		return;
+
+	poke_int64(tracee, address, config->epoch);
+	poke_uint32(tracee, address + sizeof(int64_t), 0);
+}
+
+/**
+ * Pin the native "struct timespec" at @address in @tracee's memory
+ * if it is newer than the start of the session.
+ */
+static void pin_stat_timestamp(Tracee *tracee, const Config *config, word_t address)
+{
+	struct timespec timestamp;
+	int status;
+
+	status = read_data(tracee, &timestamp, address, sizeof(timestamp));
+	if (status < 0 || timestamp.tv_sec < config->start)
+		return;
+
+	timestamp.tv_sec  = config->epoch;
+	timestamp.tv_nsec = 0;
+	(void) write_data(tracee, address, &timestamp, sizeof(timestamp));
+}
+
+/**
+ * Pin the timestamps of the stat/statx structure filled by @tracee's
+ * current syscall.
+ */
+static void adjust_stat(Tracee *tracee, const Config *config, Sysnum sysnum)
+{
+	word_t address;
+
+	/* Only the native layout of the 'stat' structure is
+	 * supported.  */
+	if (sysnum != PR_statx && is_32on64_mode(tracee))
+		return;
+
+	switch (sysnum) {
+	case PR_statx:
+		address = peek_reg(tracee, ORIGINAL, SYSARG_5);
+		pin_statx_timestamp(tracee, config, address + OFFSETOF_STATX_ATIME);
+		pin_statx_timestamp(tracee, config, address + OFFSETOF_STATX_BTIME);
+		pin_statx_timestamp(tracee, config, address + OFFSETOF_STATX_CTIME);
+		pin_statx_timestamp(tracee, config, address + OFFSETOF_STATX_MTIME);
+		return;
+
+	case PR_newfstatat:
+		address = peek_reg(tracee, ORIGINAL, SYSARG_3);
+		break;
+
+	default:
+		address = peek_reg(tracee, ORIGINAL, SYSARG_2);
+		break;
+	}
+
+	pin_stat_timestamp(tracee, config, address + offsetof(struct stat, st_atim));
+	pin_stat_timestamp(tracee, config, address + offsetof(struct stat, st_mtim));
+	pin_stat_timestamp(tracee, config, address + offsetof(struct stat, st_ctim));
+}
+
+/**
+ * Return the position of @tracee's file descriptor @fd, or -1 if
+ * it is unknown.
+ */
+static int64_t get_fd_position(const Tracee *tracee, word_t fd)
+{
+	char path[64];
+	char line[64];
+	long long position = -1;
+	FILE *file;
+
+	snprintf(path, sizeof(path), "/proc/%d/fdinfo/%d", tracee->pid, (int) fd);
+	file = fopen(path, "r");
+	if (file == NULL)
+		return -1;
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (sscanf(line, "pos: %lld", &position) == 1)
+			break;
+	}
+
+	fclose(file);
+	return position;
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+	return strcmp(((const Entry *) a)->name, ((const Entry *) b)->name);
+}
+
+/**
+ * Read and sort all the entries of the directory opened by @tracee
+ * as @fd into @directory.  This function returns -errno if an error
+ * occured, otherwise 0.
+ */
+static int load_directory(const Tracee *tracee, Directory *directory, word_t fd)
+{
+	char path[64];
+	struct dirent *dirent;
+	size_t nb_allocated = 0;
+	DIR *dir;
+
+	snprintf(path, sizeof(path), "/proc/%d/fd/%d", tracee->pid, (int) fd);
+	dir = opendir(path);
+	if (dir == NULL)
+		return -errno;
+
+	TALLOC_FREE(directory->entries);
+	directory->nb_entries = 0;
+	directory->cursor = 0;
+	directory->fd = fd;
+
+	while ((dirent = readdir(dir)) != NULL) {
+		Entry *entry;
+
+		if (directory->nb_entries == nb_allocated) {
+			nb_allocated = 2 * nb_allocated + 16;
+			directory->entries = talloc_realloc(directory, directory->entries,
+							Entry, nb_allocated);
+			if (directory->entries == NULL)
+				goto error;
+		}
+
+		entry = &directory->entries[directory->nb_entries];
+		entry->name  = talloc_strdup(directory->entries, dirent->d_name);
+		entry->inode  = dirent->d_ino;
+		entry->offset = dirent->d_off;
+		entry->type   = dirent->d_type;
+		if (entry->name == NULL)
+			goto error;
+
+		directory->nb_entries++;
+	}
+
+	closedir(dir);
+
+	if (directory->nb_entries > 0)
+		qsort(directory->entries, directory->nb_entries, sizeof(Entry), compare_entries);
+	return 0;
+
+error:
+	closedir(dir);
+	TALLOC_FREE(directory->entries);
+	directory->nb_entries = 0;
+	return -ENOMEM;
+}
+
+/**
+ * Return the directory of @config that was opened as @fd, or create
+ * a new one if @create is true.  This function returns NULL if none
+ * was found or if an error occured.
+ */
+static Directory *get_directory(Config *config, word_t fd, bool create)
+{
+	size_t nb_directories;
+	size_t i;
+
+	nb_directories = talloc_array_length(config->directories);
+	for (i = 0; i < nb_directories; i++) {
+		if (config->directories[i]->fd == (int) fd)
+			return config->directories[i];
+	}
+
+	if (!create)
+		return NULL;
+
+	config->directories = talloc_realloc(config, config->directories,
+					Directory *, nb_directories + 1);
+	if (config->directories == NULL)
+		return NULL;
+
+	config->directories[nb_directories] = talloc_zero(config->directories, Directory);
+	return config->directories[nb_directories];
+}
+
+/**
+ * Replace the entries returned by getdents64(2) with the sorted
+ * entries of the same directory.  The whole directory is read by
+ * PRoot when the tracee starts reading it from the beginning.  Each
+ * entry keeps the offset reported by the kernel, so when the tracee
+ * moves to one of these offsets -- with seekdir(3) for instance --
+ * the reading resumes right after this entry in the sorted order.
+ * This function returns -errno if an error occured, otherwise 0.
+ */
+static int sort_getdents64(Tracee *tracee, Config *config)
+{
+	Directory *directory;
+	word_t address;
+	word_t size;
+	word_t fd;
+	uint8_t *buffer;
+	size_t offset;
+	size_t i;
+	int status;
+
+	fd      = peek_reg(tracee, ORIGINAL, SYSARG_1);
+	address = peek_reg(tracee, ORIGINAL, SYSARG_2);
+	size    = peek_reg(tracee, ORIGINAL, SYSARG_3);
+
+	directory = get_directory(config, fd, config->position == 0);
+	if (directory == NULL)
+		return 0; /* Started before this extension, left as-is.  */
+
+	if (config->position == 0) {
+		status = load_directory(tracee, directory, fd);
+		if (status < 0)
+			return 0; /* Not fatal.  */
+	}
+	else if (config->position != directory->position) {
+		/* The tracee moved the position since the last
+		 * getdents64.  */
+		for (i = 0; i < directory->nb_entries; i++) {
+			if (directory->entries[i].offset == config->position) {
+				directory->cursor = i + 1;
+				break;
+			}
+		}
+	}
+
+	buffer = talloc_size(tracee->ctx, size);
+	if (buffer == NULL)
+		return -ENOMEM;
+
+	offset = 0;
+	while (directory->cursor < directory->nb_entries) {
+		const Entry *entry = &directory->entries[directory->cursor];
+		Dirent64 *dirent;
+		size_t length;
+
+		length = offsetof(Dirent64, name) + strlen(entry->name) + 1;
+		length = (length + 7) & ~7;
+		if (offset + length > size)
+			break;
+
+		dirent = (Dirent64 *) (buffer + offset);
+		memset(dirent, 0, length);
+		dirent->inode = entry->inode;
+		dirent->next  = entry->offset;
+		dirent->size  = length;
+		dirent->type  = entry->type;
+		strcpy(dirent->name, entry->name);
+
+		offset += length;
+		directory->cursor++;
+	}
+
+	if (offset == 0 && directory->cursor < directory->nb_entries)
+		return -EINVAL;
+
+	status = write_data(tracee, address, buffer, offset);
+	if (status < 0)
+		return status;
+
+	poke_reg(tracee, SYSARG_RESULT, offset);
+
+	directory->position = get_fd_position(tracee, fd);
+	return 0;
+}
+
+/* List of syscalls handled by this extensions.  */
+static FilteredSysnum filtered_sysnums[] = {
+	{ PR_getdents64,	FILTER_SYSEXIT },
+	{ PR_getrandom,		FILTER_SYSEXIT },
+	{ PR_uname,		FILTER_SYSEXIT },
+	FILTERED_SYSNUM_END,
+};
+
+/* Same as above, plus the syscalls used to get timestamps.  */
+static FilteredSysnum filtered_sysnums_timestamps[] = {
+	{ PR_fstat,		FILTER_SYSEXIT },
+	{ PR_getdents64,	FILTER_SYSEXIT },
+	{ PR_getrandom,		FILTER_SYSEXIT },
+	{ PR_lstat,		FILTER_SYSEXIT },
+	{ PR_newfstatat,	FILTER_SYSEXIT },
+	{ PR_stat,		FILTER_SYSEXIT },
+	{ PR_statx,		FILTER_SYSEXIT },
+	{ PR_uname,		FILTER_SYSEXIT },
+	FILTERED_SYSNUM_END,
+};
+
+/**
+ * Adjust the results of the syscalls handled by this extension.
+ * This function returns -errno if an error occured, otherwise 0.
+ */
+static int handle_sysexit_end(Tracee *tracee, Config *config)
+{
+	word_t result;
+	Sysnum sysnum;
+
+	result = peek_reg(tracee, CURRENT, SYSARG_RESULT);
+	sysnum = get_sysnum(tracee, ORIGINAL);
+
+	/* Error reported by the kernel.  */
+	if ((int) result < 0)
+		return 0;
+
+	switch (sysnum) {
+	case PR_getrandom:
+		if (result == 0)
+			return 0;
+		return write_random(tracee, config, peek_reg(tracee, ORIGINAL, SYSARG_1), result);
+
+	case PR_uname:
+		return adjust_utsname(tracee);
+
+	case PR_getdents64:
+		return sort_getdents64(tracee, config);
+
+	case PR_fstat:
+	case PR_lstat:
+	case PR_newfstatat:
+	case PR_stat:
+	case PR_statx:
+		if (config->pin_timestamps)
+			adjust_stat(tracee, config, sysnum);
+		return 0;
+
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Handler for this @extension.  It is triggered each time an @event
+ * occured.  See ExtensionEvent for the meaning of @data1 and @data2.
+ */
+int reproducible_callback(Extension *extension, ExtensionEvent event,
+			intptr_t data1, intptr_t data2 UNUSED)
+{
+	switch (event) {
+	case INITIALIZATION: {
+		const char *seed = (const char *) data1;
+		const char *epoch;
+		Config *config;
+		char *end;
+
+		extension->config = talloc_zero(extension, Config);
+		if (extension->config == NULL)
+			return -1;
+		config = extension->config;
+
+		/* FNV-1a hash of the seed.  */
+		config->random = 0xcbf29ce484222325ULL;
+		for (; *seed != '\0'; seed++)
+			config->random = (config->random ^ (uint8_t) *seed) * 0x100000001b3ULL;
+
+		epoch = getenv("SOURCE_DATE_EPOCH");
+		if (epoch != NULL && *epoch != '\0') {
+			errno = 0;
+			config->epoch = strtoll(epoch, &end, 10);
+			if (errno != 0 || *end != '\0') {
+				note(NULL, ERROR, USER, "invalid SOURCE_DATE_EPOCH: %s", epoch);
+				return -1;
+			}
+			config->pin_timestamps = true;
+			config->start = time(NULL);
+		}
+
+		extension->filtered_sysnums = (config->pin_timestamps
+					? filtered_sysnums_timestamps
+					: filtered_sysnums);
+		return 0;
+	}
+
+	case INHERIT_PARENT: /* Inheritable for sub reconfiguration ...  */
+		return 1;
+
+	case INHERIT_CHILD: {
+		/* Each child gets its own pseudo-random generator,
+		 * derived from its parent's one in the order of
+		 * creation, so it doesn't depend on scheduling.  */
+		Extension *parent = (Extension *) data1;
+		Config *parent_config = talloc_get_type_abort(parent->config, Config);
+		Config *config;
+
+		extension->config = talloc_zero(extension, Config);
+		if (extension->config == NULL)
+			return -1;
+		config = extension->config;
+
+		config->random = parent_config->random ^ ++parent_config->nb_children;
+		config->random = next_random(&config->random);
+
+		config->pin_timestamps = parent_config->pin_timestamps;
+		config->epoch = parent_config->epoch;
+		config->start = parent_config->start;
+
+		extension->filtered_sysnums = parent->filtered_sysnums;
+		return 0;
+	}
+
+	case SYSCALL_ENTER_START: {
+		Tracee *tracee = TRACEE(extension);
+		Config *config = talloc_get_type_abort(extension->config, Config);
+
+		if (get_sysnum(tracee, ORIGINAL) != PR_getdents64)
+			return 0;
+
+		config->position = get_fd_position(tracee, peek_reg(tracee, CURRENT, SYSARG_1));
+		return 0;
+	}
+
+	case SYSCALL_EXIT_START: {
+		Tracee *tracee = TRACEE(extension);
+		Config *config = talloc_get_type_abort(extension->config, Config);
+		word_t result = peek_reg(tracee, CURRENT, SYSARG_RESULT);
+		word_t sysnum = get_sysnum(tracee, ORIGINAL);
+
+		/* Note: this can be done only before PRoot pushes the
+		 * load script into tracee's stack.  */
+		if ((int) result >= 0 && (sysnum == PR_execve || sysnum == PR_execveat))
+			adjust_at_random(tracee, config);
+		return 0;
+	}
+
+	case SYSCALL_EXIT_END: {
+		Tracee *tracee = TRACEE(extension);
+		Config *config = talloc_get_type_abort(extension->config, Config);
+
+		return handle_sysexit_end(tracee, config);
+	}
+
+	default:
+		return 0;
+	}
+}
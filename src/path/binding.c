@@ -29,14 +29,18 @@
 #include <errno.h>    /* E* */
 #include <sys/queue.h> /* CIRCLEQ_*, */
 #include <talloc.h>   /* talloc_*, */
+#include <stdlib.h>   /* qsort(3), */
 
 #include "path/binding.h"
 #include "path/path.h"
+#include "path/cwd.h"
 #include "path/canon.h"
 #include "cli/note.h"
 
 #include "compat.h"
 
+bool profile_bindings = false;
+
 #define HEAD(tracee, side)						\
 	(side == GUEST							\
 		? (tracee)->fs->bindings.guest				\
@@ -158,6 +162,9 @@ Binding *get_binding(const Tracee *tracee, Side side, const char path[PATH_MAX])
 		    && belongs_to_guestfs(tracee, path))
 				continue;
 
+		if (profile_bindings)
+			binding->stats.nb_hits++;
+
 		return binding;
 	}
 
@@ -225,40 +232,32 @@ const char *get_root(const Tracee* tracee)
 }
 
 /**
- * Substitute the guest path (if any) with the host path in @path.
- * This function returns:
- *
- *     * -errno if an error occured
- *
- *     * 0 if it is a binding location but no substitution is needed
- *       ("symetric" binding)
- *
- *     * 1 if it is a binding location and a substitution was performed
- *       ("asymmetric" binding)
+ * Substitute the guest path (if any) with the host path in @path, as
+ * substitute_binding() does, and make *@binding point to the binding
+ * that was used, if any.
  */
-int substitute_binding(const Tracee *tracee, Side side, char path[PATH_MAX])
+int substitute_binding2(const Tracee *tracee, Side side, char path[PATH_MAX], Binding **binding)
 {
 	const Path *reverse_ref;
 	const Path *ref;
-	const Binding *binding;
 
-	binding = get_binding(tracee, side, path);
-	if (!binding)
+	*binding = get_binding(tracee, side, path);
+	if (!*binding)
 		return -ENOENT;
 
 	/* Is it a "symetric" binding?  */
-	if (!binding->need_substitution)
+	if (!(*binding)->need_substitution)
 		return 0;
 
 	switch (side) {
 	case GUEST:
-		ref = &binding->guest;
-		reverse_ref = &binding->host;
+		ref = &(*binding)->guest;
+		reverse_ref = &(*binding)->host;
 		break;
 
 	case HOST:
-		ref = &binding->host;
-		reverse_ref = &binding->guest;
+		ref = &(*binding)->host;
+		reverse_ref = &(*binding)->guest;
 		break;
 
 	default:
@@ -271,11 +270,44 @@ int substitute_binding(const Tracee *tracee, Side side, char path[PATH_MAX])
 	return 1;
 }
 
+/**
+ * Substitute the guest path (if any) with the host path in @path.
+ * This function returns:
+ *
+ *     * -errno if an error occured
+ *
+ *     * 0 if it is a binding location but no substitution is needed
+ *       ("symetric" binding)
+ *
+ *     * 1 if it is a binding location and a substitution was performed
+ *       ("asymmetric" binding)
+ */
+int substitute_binding(const Tracee *tracee, Side side, char path[PATH_MAX])
+{
+	Binding *binding;
+
+	return substitute_binding2(tracee, side, path, &binding);
+}
+
+/* Incremented each time a list of bindings is modified.  */
+static unsigned long bindings_generation = 0;
+
+/**
+ * Return a number that changes each time a list of bindings is
+ * modified, this is used to invalidate what was computed from them.
+ */
+unsigned long get_bindings_generation(void)
+{
+	return bindings_generation;
+}
+
 /**
  * Remove @binding from all the @tracee's lists of bindings it belongs to.
  */
 void remove_binding_from_all_lists(const Tracee *tracee, Binding *binding)
 {
+       bindings_generation++;
+
        if (IS_LINKED(binding, link.pending))
 	       CIRCLEQ_REMOVE_(tracee, binding, pending);
 
@@ -383,6 +415,8 @@ static void insort_binding2(const Tracee *tracee, Binding *binding)
 	binding->need_substitution =
 		compare_paths(binding->host.path, binding->guest.path) != PATHS_ARE_EQUAL;
 
+	bindings_generation++;
+
 	insort_binding(tracee, GUEST, binding);
 	insort_binding(tracee, HOST, binding);
 }
@@ -414,6 +448,83 @@ Binding *insort_binding3(const Tracee *tracee, const TALLOC_CTX *context,
 	return binding;
 }
 
+/**
+ * Rank bindings by decreasing canonicalization time, then by
+ * decreasing number of hits.
+ */
+static int compare_binding_costs(const void *a, const void *b)
+{
+	const Binding *binding_a = *(const Binding **) a;
+	const Binding *binding_b = *(const Binding **) b;
+
+	if (binding_a->stats.canonicalization_time != binding_b->stats.canonicalization_time)
+		return (binding_a->stats.canonicalization_time
+			> binding_b->stats.canonicalization_time ? -1 : 1);
+
+	if (binding_a->stats.nb_hits != binding_b->stats.nb_hits)
+		return (binding_a->stats.nb_hits > binding_b->stats.nb_hits ? -1 : 1);
+
+	return 0;
+}
+
+/**
+ * Print the statistics of @bindings ranked by cost, then the bindings
+ * that were never used -- candidates to be dropped.
+ */
+static void print_bindings_profile(const Tracee *tracee, Bindings *bindings)
+{
+	Binding **ranking;
+	Binding *binding;
+	size_t nb_bindings = 0;
+	size_t nb_unused = 0;
+	size_t i;
+
+	CIRCLEQ_FOREACH(binding, bindings, link.guest)
+		nb_bindings++;
+
+	ranking = talloc_array(NULL, Binding *, nb_bindings);
+	if (ranking == NULL)
+		return;
+
+	i = 0;
+	CIRCLEQ_FOREACH(binding, bindings, link.guest)
+		ranking[i++] = binding;
+
+	qsort(ranking, nb_bindings, sizeof(Binding *), compare_binding_costs);
+
+	note(tracee, INFO, USER, "bindings profile (time in canonicalize, lstats, hits):");
+	for (i = 0; i < nb_bindings; i++) {
+		binding = ranking[i];
+
+		if (binding->stats.nb_hits == 0) {
+			nb_unused++;
+			continue;
+		}
+
+		note(tracee, INFO, USER, "%10.3f ms %10lu %10lu  %s%s%s",
+			binding->stats.canonicalization_time / 1e6,
+			binding->stats.nb_lstats, binding->stats.nb_hits,
+			binding->host.path,
+			binding->need_substitution ? ":" : "",
+			binding->need_substitution ? binding->guest.path : "");
+	}
+
+	if (nb_unused > 0) {
+		note(tracee, INFO, USER, "unused bindings:");
+		for (i = 0; i < nb_bindings; i++) {
+			binding = ranking[i];
+			if (binding->stats.nb_hits != 0)
+				continue;
+
+			note(tracee, INFO, USER, "%s%s%s", binding->host.path,
+				binding->need_substitution ? ":" : "",
+				binding->need_substitution ? binding->guest.path : "");
+		}
+	}
+
+	talloc_free(ranking);
+}
+
 /**
  * Free all bindings from @bindings.
  *
@@ -438,8 +549,11 @@ static int remove_bindings(Bindings *bindings)
 	tracee = TRACEE(bindings);
 	if (bindings == tracee->fs->bindings.pending)
 		CIRCLEQ_REMOVE_ALL(pending);
-	else if (bindings == tracee->fs->bindings.guest)
+	else if (bindings == tracee->fs->bindings.guest) {
+		if (profile_bindings)
+			print_bindings_profile(tracee, bindings);
 		CIRCLEQ_REMOVE_ALL(guest);
+	}
 	else if (bindings == tracee->fs->bindings.host)
 		CIRCLEQ_REMOVE_ALL(host);
 
@@ -448,6 +562,131 @@ static int remove_bindings(Bindings *bindings)
 	return 0;
 }
 
+/**
+ * Make @host_path the new root of @tracee's file-system name-space,
+ * as chroot(2) does.  Bindings located under the new root are kept
+ * relatively to it, whereas all the others become unreachable.  This
+ * function returns -errno if an error occured, otherwise 0.
+ */
+int change_root(Tracee *tracee, const char host_path[PATH_MAX])
+{
+	char guest_root[PATH_MAX];
+	char path[PATH_MAX];
+	Bindings *old_guest;
+	Bindings *old_host;
+	Bindings *new_guest;
+	Bindings *new_host;
+	Binding *binding;
+	Binding *copy;
+	Comparison comparison;
+	size_t prefix_length;
+	int status;
+
+	/* Get the new root from the current guest point-of-view.  */
+	strcpy(guest_root, host_path);
+	status = detranslate_path(tracee, guest_root, NULL);
+	if (status < 0)
+		return status;
+
+	/* Nothing to do if "new rootfs == current rootfs".  */
+	if (compare_paths(guest_root, "/") == PATHS_ARE_EQUAL)
+		return 0;
+
+	prefix_length = strlen(guest_root);
+
+	/* Lists of bindings are shared across file-system name-spaces
+	 * (c.f. new_child()), that's why new ones are allocated for
+	 * this name-space only.  */
+	old_guest = tracee->fs->bindings.guest;
+	old_host  = tracee->fs->bindings.host;
+
+	tracee->fs->bindings.guest = talloc_zero(tracee->fs, Bindings);
+	tracee->fs->bindings.host  = talloc_zero(tracee->fs, Bindings);
+	if (tracee->fs->bindings.guest == NULL || tracee->fs->bindings.host == NULL) {
+		status = -ENOMEM;
+		goto end;
+	}
+
+	CIRCLEQ_INIT(tracee->fs->bindings.guest);
+	CIRCLEQ_INIT(tracee->fs->bindings.host);
+
+	talloc_set_destructor(tracee->fs->bindings.guest, remove_bindings);
+	talloc_set_destructor(tracee->fs->bindings.host, remove_bindings);
+
+	strcpy(path, "/");
+	binding = insort_binding3(tracee, tracee->ctx, host_path, path);
+	if (binding == NULL) {
+		status = -ENOMEM;
+		goto end;
+	}
+
+	/* Keep the bindings located under the new root, for instance
+	 * "-b /proc:/newroot/proc" becomes "-b /proc:/proc" once
+	 * chroot("/newroot") is done.  */
+	for (binding = CIRCLEQ_FIRST(old_guest);
+	     binding != (void *) old_guest;
+	     binding = CIRCLEQ_NEXT(binding, link.guest)) {
+		comparison = compare_paths(guest_root, binding->guest.path);
+		if (comparison != PATH1_IS_PREFIX)
+			continue;
+
+		strcpy(path, binding->guest.path + prefix_length);
+
+		VERBOSE(tracee, 2, "chroot binding: %s:%s -> %s:%s",
+			binding->host.path, binding->guest.path, binding->host.path, path);
+
+		copy = insort_binding3(tracee, tracee->ctx, binding->host.path, path);
+		if (copy == NULL) {
+			status = -ENOMEM;
+			goto end;
+		}
+
+		/* Keep alive the resources owned by the original
+		 * binding, like the content of an emulated tmpfs.  */
+		copy->fstype = binding->fstype;
+		(void) talloc_reference(copy, binding);
+	}
+
+	/* The current working directory isn't changed by chroot(2)
+	 * but it can be expressed from the new root point-of-view
+	 * only if it is located under this latter.  */
+	comparison = compare_paths(guest_root, tracee->fs->cwd);
+	if (comparison == PATH1_IS_PREFIX)
+		strcpy(path, tracee->fs->cwd + prefix_length);
+	else
+		strcpy(path, "/");
+
+	status = set_cwd(tracee->fs, path);
+end:
+	/* Note: remove_bindings() expects the lists being released
+	 * are referenced by tracee->fs->bindings.  */
+	if (status < 0) {
+		TALLOC_FREE(tracee->fs->bindings.guest);
+		TALLOC_FREE(tracee->fs->bindings.host);
+
+		tracee->fs->bindings.guest = old_guest;
+		tracee->fs->bindings.host  = old_host;
+		return status;
+	}
+
+	new_guest = tracee->fs->bindings.guest;
+	new_host  = tracee->fs->bindings.host;
+
+	tracee->fs->bindings.guest = old_guest;
+	tracee->fs->bindings.host  = old_host;
+
+	(void) talloc_unlink(tracee->fs, old_guest);
+	(void) talloc_unlink(tracee->fs, old_host);
+
+	tracee->fs->bindings.guest = new_guest;
+	tracee->fs->bindings.host  = new_host;
+
+	if (tracee->verbose > 0)
+		print_bindings(tracee);
+
+	return 0;
+}
+
 /**
  * Allocate a new binding "@host:@guest" and attach it to
  * @tracee->fs->bindings.pending.  This function complains about
@@ -25,6 +25,7 @@
 
 #include <limits.h> /* PATH_MAX, */
 #include <stdbool.h>
+#include <stdint.h> /* uint64_t, */
 
 #include "tracee/tracee.h"
 #include "path.h"
@@ -36,6 +37,18 @@ typedef struct binding {
 	bool need_substitution;
 	bool must_exist;
 
+	/* Type of the emulated file-system, as reported in
+	 * "/proc/<PID>/mountinfo" (NULL for bindings that are not
+	 * emulated mounts).  */
+	const char *fstype;
+
+	/* Usage statistics, c.f. profile_bindings.  */
+	struct {
+		unsigned long nb_hits;
+		unsigned long nb_lstats;
+		uint64_t canonicalization_time;  /* In nanoseconds.  */
+	} stats;
+
 	struct {
 		CIRCLEQ_ENTRY(binding) pending;
 		CIRCLEQ_ENTRY(binding) guest;
@@ -45,6 +58,9 @@ typedef struct binding {
 
 typedef CIRCLEQ_HEAD(bindings, binding) Bindings;
 
+/* Collect Binding.stats and report them once bindings are freed.  */
+extern bool profile_bindings;
+
 extern Binding *insort_binding3(const Tracee *tracee, const TALLOC_CTX *context,
 				const char host_path[PATH_MAX], const char guest_path[PATH_MAX]);
 extern Binding *new_binding(Tracee *tracee, const char *host, const char *guest, bool must_exist);
@@ -53,6 +69,9 @@ extern const char *get_path_binding(const Tracee* tracee, Side side, const char
 extern Binding *get_binding(const Tracee *tracee, Side side, const char path[PATH_MAX]);
 extern const char *get_root(const Tracee* tracee);
 extern int substitute_binding(const Tracee* tracee, Side side, char path[PATH_MAX]);
+extern int substitute_binding2(const Tracee* tracee, Side side, char path[PATH_MAX], Binding **binding);
 extern void remove_binding_from_all_lists(const Tracee *tracee, Binding *binding);
+extern int change_root(Tracee *tracee, const char host_path[PATH_MAX]);
+extern unsigned long get_bindings_generation(void);
 
 #endif /* BINDING_H */
@@ -29,6 +29,8 @@
 #include <string.h>    /* string(3), */
 #include <assert.h>    /* assert(3), */
 #include <stdio.h>     /* sscanf(3), */
+#include <time.h>      /* clock_gettime(2), */
+#include <talloc.h>    /* talloc_*, */
 
 #include "path/canon.h"
 #include "path/path.h"
@@ -36,6 +38,7 @@
 #include "path/glue.h"
 #include "path/proc.h"
 #include "extension/extension.h"
+#include "compat.h"
 
 /**
  * Put an end-of-string ('\0') right before the last component of @path.
@@ -125,6 +128,100 @@ static inline Finality next_component(char component[NAME_MAX], const char **cur
 	return NOT_FINAL;
 }
 
+/**
+ * Start constraining the path resolution of @tracee from the
+ * directory @base, as specified by the RESOLVE_* flags in
+ * @tracee->resolve.flags (c.f. openat2(2)).  This function returns
+ * -errno if an error occured, otherwise 0.
+ */
+int init_resolve_constraints(Tracee *tracee, const char base[PATH_MAX])
+{
+	char host_path[PATH_MAX];
+	Binding *binding;
+	struct stat statl;
+	int status;
+
+	strcpy(host_path, base);
+	status = substitute_binding2(tracee, GUEST, host_path, &binding);
+	if (status < 0)
+		return status;
+
+	status = lstat(host_path, &statl);
+	if (status < 0)
+		return -errno;
+
+	tracee->resolve.base = talloc_strdup(tracee->ctx, base);
+	if (tracee->resolve.base == NULL)
+		return -ENOMEM;
+
+	tracee->resolve.binding = binding;
+	tracee->resolve.dev = statl.st_dev;
+
+	return 0;
+}
+
+/**
+ * Check whether the resolution of @guest_path is subject to the
+ * RESOLVE_* constraints of @tracee, that is, either it is located
+ * under the directory the resolution starts from, or it was reached
+ * through a symlink.
+ */
+static inline bool is_resolve_constrained(const Tracee *tracee, unsigned int recursion_level,
+					const char guest_path[PATH_MAX])
+{
+	Comparison comparison;
+
+	if (tracee->resolve.flags == 0)
+		return false;
+
+	if (recursion_level > 0)
+		return true;
+
+	comparison = compare_paths(tracee->resolve.base, guest_path);
+	return (comparison == PATHS_ARE_EQUAL || comparison == PATH1_IS_PREFIX);
+}
+
+/**
+ * Check whether @guest_path is a "magic link", that is, a link
+ * generated by the kernel under "/proc/<PID>/" that doesn't behave
+ * like a regular symlink.
+ */
+static bool is_magic_link(const char guest_path[PATH_MAX])
+{
+	const char *cursor;
+	const char *slash;
+
+	if (strncmp(guest_path, "/proc/", strlen("/proc/")) != 0)
+		return false;
+
+	/* Skip "<PID>/", "self/", "thread-self/", ...  */
+	cursor = strchr(guest_path + strlen("/proc/"), '/');
+	if (cursor == NULL)
+		return false;
+	cursor++;
+
+	/* ... and "task/<TID>/" if any.  */
+	if (strncmp(cursor, "task/", strlen("task/")) == 0) {
+		cursor = strchr(cursor + strlen("task/"), '/');
+		if (cursor == NULL)
+			return false;
+		cursor++;
+	}
+
+	if (   strcmp(cursor, "exe") == 0
+	    || strcmp(cursor, "cwd") == 0
+	    || strcmp(cursor, "root") == 0)
+		return true;
+
+	slash = strchr(cursor, '/');
+	if (slash == NULL || strchr(slash + 1, '/') != NULL)
+		return false;
+
+	return (   strncmp(cursor, "fd/", strlen("fd/")) == 0
+		|| strncmp(cursor, "map_files/", strlen("map_files/")) == 0
+		|| strncmp(cursor, "ns/", strlen("ns/")) == 0);
+}
+
 /**
  * Resolve bindings (if any) in @guest_path and copy the translated
  * path into @host_path.  Also, this function checks that a non-final
@@ -134,11 +231,17 @@ static inline Finality next_component(char component[NAME_MAX], const char **cur
 static inline int substitute_binding_stat(Tracee *tracee, Finality finality, unsigned int recursion_level,
 					const char guest_path[PATH_MAX], char host_path[PATH_MAX])
 {
+	struct timespec start;
+	struct timespec end;
+	Binding *binding;
 	struct stat statl;
 	int status;
 
+	if (profile_bindings)
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
 	strcpy(host_path, guest_path);
-	status = substitute_binding(tracee, GUEST, host_path);
+	status = substitute_binding2(tracee, GUEST, host_path, &binding);
 	if (status < 0)
 		return status;
 
@@ -153,6 +256,28 @@ static inline int substitute_binding_stat(Tracee *tracee, Finality finality, uns
 	statl.st_mode = 0;
 	status = lstat(host_path, &statl);
 
+	/* Account this lookup to the binding, the time spent in the
+	 * notified extensions included.  */
+	if (profile_bindings) {
+		int errno_saved = errno;
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		binding->stats.nb_lstats++;
+		binding->stats.canonicalization_time +=
+			(end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec;
+
+		errno = errno_saved;
+	}
+
+	/* The resolution isn't allowed to cross a mount point, as
+	 * specified by RESOLVE_NO_XDEV.  From the guest point-of-view,
+	 * bindings are mount points too.  */
+	if (   (tracee->resolve.flags & RESOLVE_NO_XDEV) != 0
+	    && is_resolve_constrained(tracee, recursion_level, guest_path)
+	    && (   binding != tracee->resolve.binding
+		|| (status == 0 && statl.st_dev != tracee->resolve.dev)))
+		return -EXDEV;
+
 	/* Build the glue between the hostfs and the guestfs during
 	 * the initialization of a binding.  */
 	if (status < 0 && tracee->glue_type != 0) {
@@ -208,6 +333,14 @@ int canonicalize(Tracee *tracee, const char *user_path, bool deref_final,
 		if (guest_path[0] != '/')
 			return -EINVAL;
 	}
+	else if (recursion_level > 0 && (tracee->resolve.flags & RESOLVE_BENEATH) != 0) {
+		/* Absolute symlinks are not allowed to escape.  */
+		return -EXDEV;
+	}
+	else if (recursion_level > 0 && (tracee->resolve.flags & RESOLVE_IN_ROOT) != 0) {
+		/* Absolute symlinks are relative to the new "root".  */
+		strcpy(guest_path, tracee->resolve.base);
+	}
 	else
 		strcpy(guest_path, "/");
 
@@ -238,7 +371,25 @@ int canonicalize(Tracee *tracee, const char *user_path, bool deref_final,
 		}
 
 		if (strcmp(component, "..") == 0) {
-			pop_component(guest_path);
+			if (   (tracee->resolve.flags & (RESOLVE_BENEATH | RESOLVE_IN_ROOT)) != 0
+			    && compare_paths(tracee->resolve.base, guest_path) == PATHS_ARE_EQUAL) {
+				/* ".." is not allowed to escape, or
+				 * it is the new "root" itself.  */
+				if ((tracee->resolve.flags & RESOLVE_BENEATH) != 0)
+					return -EXDEV;
+			}
+			else
+				pop_component(guest_path);
+
+			/* Check the mount point the resolution
+			 * goes back to.  */
+			if ((tracee->resolve.flags & RESOLVE_NO_XDEV) != 0) {
+				status = substitute_binding_stat(tracee, finality, recursion_level,
+								guest_path, host_path);
+				if (status < 0)
+					return status;
+			}
+
 			if (IS_FINAL(finality))
 				finality = FINAL_SLASH;
 			continue;
@@ -271,6 +422,14 @@ int canonicalize(Tracee *tracee, const char *user_path, bool deref_final,
 			continue;
 		}
 
+		/* The resolution isn't allowed to follow any link, or
+		 * any magic link, as specified by RESOLVE_NO_SYMLINKS and
+		 * RESOLVE_NO_MAGICLINKS respectively.  */
+		if (   (tracee->resolve.flags & RESOLVE_NO_SYMLINKS) != 0
+		    || (   (tracee->resolve.flags & RESOLVE_NO_MAGICLINKS) != 0
+			&& is_magic_link(scratch_path)))
+			return -ELOOP;
+
 		/* It's a link, so we have to dereference *and*
 		 * canonicalize to ensure we are not going outside the
 		 * new root.  */
@@ -28,6 +28,7 @@
 
 #include "tracee/tracee.h"
 
+extern int init_resolve_constraints(Tracee *tracee, const char base[PATH_MAX]);
 extern int canonicalize(Tracee *tracee, const char *user_path, bool deref_final,
 			char guest_path[PATH_MAX], unsigned int nb_recursion);
 
@@ -0,0 +1,248 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <string.h>  /* strcmp(3), strncmp(3), memmove(3), memcpy(3), */
+#include <errno.h>   /* E*, */
+#include <talloc.h>  /* talloc_*, */
+
+#include "path/cwd.h"
+#include "path/path.h"
+#include "tracee/tracee.h"
+#include "attribute.h"
+
+/* Index of the current working directories of all the file-system
+ * name-spaces, sorted by path so as to find quickly the ones that are
+ * located under a given path (they are contiguous).  */
+static struct {
+	FileSystemNameSpace **fs;
+	size_t length;
+} cwds = { NULL, 0 };
+
+/**
+ * Return the position of the first entry of the index that is not
+ * lesser than @path.
+ */
+static size_t search_cwd(const char *path)
+{
+	size_t low = 0;
+	size_t high = cwds.length;
+
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+
+		if (strcmp(cwds.fs[middle]->cwd, path) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+/**
+ * Remove @cwd from the index.
+ *
+ * Note: this is a Talloc destructor.
+ */
+static int unindex_cwd(char *cwd)
+{
+	size_t i;
+
+	for (i = search_cwd(cwd); i < cwds.length && strcmp(cwds.fs[i]->cwd, cwd) == 0; i++) {
+		if (cwds.fs[i]->cwd != cwd)
+			continue;
+
+		memmove(&cwds.fs[i], &cwds.fs[i + 1],
+			(cwds.length - i - 1) * sizeof(FileSystemNameSpace *));
+		cwds.length--;
+		break;
+	}
+
+	return 0;
+}
+
+/**
+ * Forget the index once it is released at exit.
+ *
+ * Note: this is a Talloc destructor.
+ */
+static int reset_cwds(FileSystemNameSpace **fs UNUSED)
+{
+	cwds.fs = NULL;
+	cwds.length = 0;
+	return 0;
+}
+
+/**
+ * Set the current working directory of @fs to @path and keep the
+ * index up-to-date.  This function returns -errno if an error
+ * occured, otherwise 0.
+ */
+int set_cwd(FileSystemNameSpace *fs, const char *path)
+{
+	FileSystemNameSpace **array;
+	char *cwd;
+	size_t i;
+
+	cwd = talloc_strdup(fs, path);
+	if (cwd == NULL)
+		return -ENOMEM;
+	talloc_set_name_const(cwd, "$cwd");
+
+	/* Make room for the new entry before releasing the previous
+	 * one, so as to never fail in the middle of the update.  */
+	array = talloc_realloc(cwds.fs ?: talloc_autofree_context(), cwds.fs,
+			FileSystemNameSpace *, cwds.length + 1);
+	if (array == NULL) {
+		talloc_free(cwd);
+		return -ENOMEM;
+	}
+	talloc_set_destructor(array, reset_cwds);
+	cwds.fs = array;
+
+	TALLOC_FREE(fs->cwd);
+	fs->cwd = cwd;
+
+	i = search_cwd(cwd);
+	memmove(&cwds.fs[i + 1], &cwds.fs[i], (cwds.length - i) * sizeof(FileSystemNameSpace *));
+	cwds.fs[i] = fs;
+	cwds.length++;
+
+	talloc_set_destructor(cwd, unindex_cwd);
+
+	return 0;
+}
+
+/**
+ * Put in @result the prefix for all the paths located under @path.
+ * This function returns the length of @result.
+ */
+static size_t get_subpath_prefix(char result[PATH_MAX], const char path[PATH_MAX])
+{
+	size_t length = strlen(path);
+
+	strcpy(result, path);
+	if (length > 0 && length < PATH_MAX - 1 && result[length - 1] != '/') {
+		result[length++] = '/';
+		result[length] = '\0';
+	}
+
+	return length;
+}
+
+/**
+ * Check if the current working directory of any file-system
+ * name-space is @path or is located under @path.
+ */
+bool has_cwd_under(const char path[PATH_MAX])
+{
+	char prefix[PATH_MAX];
+	size_t length;
+	size_t i;
+
+	i = search_cwd(path);
+	if (i < cwds.length && strcmp(cwds.fs[i]->cwd, path) == 0)
+		return true;
+
+	length = get_subpath_prefix(prefix, path);
+
+	i = search_cwd(prefix);
+	return (i < cwds.length && strncmp(cwds.fs[i]->cwd, prefix, length) == 0);
+}
+
+/**
+ * Update the current working directory of all the file-system
+ * name-spaces that were located under @old_path -- or were
+ * @old_path itself -- since this latter was renamed to @new_path by
+ * @tracee.  Only the file-system name-spaces that share the bindings
+ * of @tracee are updated since the cwd of the other ones is not
+ * expressed from the same root.  The cost of this function depends
+ * on the number of matching cwds, not on the number of tracees.
+ * This function returns -errno if an error occured, otherwise 0.
+ */
+int rename_cwds(const Tracee *tracee, const char old_path[PATH_MAX], const char new_path[PATH_MAX])
+{
+	FileSystemNameSpace **matches;
+	char prefix[PATH_MAX];
+	char path[PATH_MAX];
+	size_t nb_matches;
+	size_t old_length;
+	size_t new_length;
+	size_t length;
+	size_t first1, last1;
+	size_t first2, last2;
+	size_t i;
+	int status;
+
+	/* Entries equal to "@old_path" are followed -- but not
+	 * necessarily immediately -- by the ones under "@old_path/".  */
+	first1 = search_cwd(old_path);
+	for (last1 = first1; last1 < cwds.length; last1++) {
+		if (strcmp(cwds.fs[last1]->cwd, old_path) != 0)
+			break;
+	}
+
+	length = get_subpath_prefix(prefix, old_path);
+
+	first2 = search_cwd(prefix);
+	for (last2 = first2; last2 < cwds.length; last2++) {
+		if (strncmp(cwds.fs[last2]->cwd, prefix, length) != 0)
+			break;
+	}
+
+	nb_matches = (last1 - first1) + (last2 - first2);
+	if (nb_matches == 0)
+		return 0;
+
+	/* The index is reordered by set_cwd(), that's why matches
+	 * are collected first.  */
+	matches = talloc_array(tracee->ctx, FileSystemNameSpace *, nb_matches);
+	if (matches == NULL)
+		return -ENOMEM;
+
+	memcpy(matches, &cwds.fs[first1], (last1 - first1) * sizeof(FileSystemNameSpace *));
+	memcpy(matches + (last1 - first1), &cwds.fs[first2], (last2 - first2) * sizeof(FileSystemNameSpace *));
+
+	old_length = strlen(old_path);
+	new_length = strlen(new_path);
+
+	status = 0;
+	for (i = 0; i < nb_matches; i++) {
+		if (matches[i]->bindings.guest != tracee->fs->bindings.guest)
+			continue;
+
+		/* Sanity check.  */
+		if (strlen(matches[i]->cwd) >= PATH_MAX)
+			continue;
+		strcpy(path, matches[i]->cwd);
+
+		substitute_path_prefix(path, old_length, new_path, new_length);
+
+		status = set_cwd(matches[i], path);
+		if (status < 0)
+			break;
+	}
+
+	TALLOC_FREE(matches);
+
+	return status;
+}
@@ -0,0 +1,35 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef CWD_H
+#define CWD_H
+
+#include <limits.h>  /* PATH_MAX, */
+#include <stdbool.h>
+
+#include "tracee/tracee.h"
+
+extern int set_cwd(FileSystemNameSpace *fs, const char *path);
+extern bool has_cwd_under(const char path[PATH_MAX]);
+extern int rename_cwds(const Tracee *tracee, const char old_path[PATH_MAX], const char new_path[PATH_MAX]);
+
+#endif /* CWD_H */
@@ -35,6 +35,7 @@
 
 #include "path/path.h"
 #include "path/binding.h"
+#include "path/policy.h"
 #include "path/canon.h"
 #include "path/proc.h"
 #include "extension/extension.h"
@@ -352,6 +353,14 @@ int translate_path(Tracee *tracee, char result[PATH_MAX], int dir_fd,
 			return status;
 	}
 
+	/* The RESOLVE_* constraints of openat2(2) are relative to
+	 * this base.  */
+	if (tracee != NULL && tracee->resolve.flags != 0) {
+		status = init_resolve_constraints(tracee, result);
+		if (status < 0)
+			return status;
+	}
+
 	VERBOSE(tracee, 2, "vpid %" PRIu64 ": translate(\"%s\" + \"%s\")",
 		tracee != NULL ? tracee->vpid : 0, result, user_path);
 
@@ -381,6 +390,10 @@ int translate_path(Tracee *tracee, char result[PATH_MAX], int dir_fd,
 	if (status < 0)
 		return status;
 
+	status = check_policy(tracee, result);
+	if (status < 0)
+		return status;
+
 skip:
 	VERBOSE(tracee, 2, "vpid %" PRIu64 ":          -> \"%s\"",
 		tracee != NULL ? tracee->vpid : 0, result);
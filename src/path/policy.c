@@ -0,0 +1,352 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <string.h>   /* str*(3), */
+#include <stdlib.h>   /* qsort(3), */
+#include <stdio.h>    /* snprintf(3), */
+#include <unistd.h>   /* W_OK, X_OK, readlink(2), */
+#include <fcntl.h>    /* O_*, AT_FDCWD, */
+#include <sys/stat.h> /* stat(2), */
+#include <errno.h>    /* E*, */
+#include <talloc.h>   /* talloc_*, */
+
+#include "path/policy.h"
+#include "path/path.h"
+#include "syscall/sysnum.h"
+#include "syscall/syscall.h"
+#include "tracee/reg.h"
+#include "cli/note.h"
+
+Policy *policies = NULL;
+
+/* Policies specified by the user, with guest paths.  */
+static Policy *pending_policies = NULL;
+
+typedef enum {
+	ACCESS_READ,
+	ACCESS_WRITE,
+	ACCESS_EXEC,
+} Access;
+
+/**
+ * Register the policy described by @value -- "flags:path" -- for
+ * @tracee.  This function returns -1 if an error occured, otherwise
+ * 0.
+ */
+int new_policy(Tracee *tracee, const char *value)
+{
+	const char *separator;
+	const char *cursor;
+	PolicyFlags flags = 0;
+	Policy *policy;
+	size_t length;
+	size_t i;
+
+	separator = strchr(value, ':');
+	if (separator == NULL || separator[1] == '\0') {
+		note(tracee, ERROR, USER, "invalid policy '%s', expected 'flags:path'", value);
+		return -1;
+	}
+
+	for (cursor = value; cursor < separator; cursor += length + 1) {
+		length = strcspn(cursor, ",:");
+
+		if (length == 2 && strncmp(cursor, "ro", length) == 0)
+			flags |= POLICY_RO;
+		else if (length == 2 && strncmp(cursor, "rw", length) == 0)
+			flags &= ~POLICY_RO;
+		else if (length == 4 && strncmp(cursor, "hide", length) == 0)
+			flags |= POLICY_HIDE;
+		else if (length == 4 && strncmp(cursor, "deny", length) == 0)
+			flags |= POLICY_DENY;
+		else if (length == 6 && strncmp(cursor, "noexec", length) == 0)
+			flags |= POLICY_NOEXEC;
+		else {
+			note(tracee, ERROR, USER, "unknown policy flag '%.*s' (expected "
+				"ro, rw, hide, deny, or noexec)", (int) length, cursor);
+			return -1;
+		}
+	}
+
+	/* The last policy specified for a given path wins.  */
+	length = talloc_array_length(pending_policies);
+	for (i = 0; i < length; i++) {
+		if (strcmp(pending_policies[i].path, separator + 1) == 0) {
+			pending_policies[i].flags = flags;
+			return 0;
+		}
+	}
+
+	pending_policies = talloc_realloc(NULL, pending_policies, Policy, length + 1);
+	if (pending_policies == NULL)
+		return -1;
+
+	policy = &pending_policies[length];
+	policy->path = talloc_strdup(pending_policies, separator + 1);
+	if (policy->path == NULL)
+		return -1;
+	policy->length = strlen(policy->path);
+	policy->flags  = flags;
+
+	return 0;
+}
+
+static int compare_policies(const void *a, const void *b)
+{
+	const Policy *policy_a = a;
+	const Policy *policy_b = b;
+
+	/* Longest paths first.  */
+	if (policy_a->length == policy_b->length)
+		return 0;
+	return (policy_a->length > policy_b->length ? -1 : 1);
+}
+
+/**
+ * Canonicalize the guest paths of the policies specified by the user,
+ * now that bindings are installed, then enable them.  This function
+ * returns -1 if an error occured, otherwise 0.
+ */
+int initialize_policies(Tracee *tracee)
+{
+	char path[PATH_MAX];
+	size_t nb_policies;
+	size_t i;
+	int status;
+
+	if (pending_policies == NULL)
+		return 0;
+
+	nb_policies = talloc_array_length(pending_policies);
+	for (i = 0; i < nb_policies; i++) {
+		Policy *policy = &pending_policies[i];
+
+		status = translate_path(tracee, path, AT_FDCWD, policy->path, true);
+		if (status < 0) {
+			note(tracee, ERROR, USER, "can't resolve policy path '%s'", policy->path);
+			return -1;
+		}
+
+		VERBOSE(tracee, 1, "policy: %s -> %s", policy->path, path);
+
+		policy->path = talloc_strdup(pending_policies, path);
+		if (policy->path == NULL)
+			return -1;
+		policy->length = strlen(path);
+	}
+
+	qsort(pending_policies, nb_policies, sizeof(Policy), compare_policies);
+
+	policies = pending_policies;
+	pending_policies = NULL;
+
+	return 0;
+}
+
+/**
+ * Return how the current syscall of @tracee intends to access the
+ * paths it uses.
+ */
+static Access get_access(const Tracee *tracee)
+{
+	OpenHow how;
+	word_t flags;
+	word_t mode;
+
+	switch (get_sysnum(tracee, ORIGINAL)) {
+	case PR_open:
+		flags = peek_reg(tracee, ORIGINAL, SYSARG_2);
+		goto open;
+
+	case PR_openat:
+		flags = peek_reg(tracee, ORIGINAL, SYSARG_3);
+		goto open;
+
+	case PR_openat2:
+		if (get_sysarg_open_how(tracee, ORIGINAL, &how) < 0)
+			return ACCESS_WRITE;
+		flags = how.flags;
+	open:
+		if ((flags & O_ACCMODE) != O_RDONLY || (flags & (O_CREAT | O_TRUNC)) != 0)
+			return ACCESS_WRITE;
+		return ACCESS_READ;
+
+	case PR_access:
+		mode = peek_reg(tracee, ORIGINAL, SYSARG_2);
+		goto access;
+
+	case PR_faccessat:
+	case PR_faccessat2:
+		mode = peek_reg(tracee, ORIGINAL, SYSARG_3);
+	access:
+		if ((mode & W_OK) != 0)
+			return ACCESS_WRITE;
+		if ((mode & X_OK) != 0)
+			return ACCESS_EXEC;
+		return ACCESS_READ;
+
+	case PR_execve:
+	case PR_execveat:
+	case PR_uselib:
+		return ACCESS_EXEC;
+
+	case PR_acct:
+	case PR_bind:
+	case PR_chmod:
+	case PR_chown:
+	case PR_chown32:
+	case PR_creat:
+	case PR_fallocate:
+	case PR_fchmod:
+	case PR_fchmodat:
+	case PR_fchmodat2:
+	case PR_fchown:
+	case PR_fchown32:
+	case PR_fchownat:
+	case PR_fremovexattr:
+	case PR_fsetxattr:
+	case PR_ftruncate:
+	case PR_ftruncate64:
+	case PR_futimesat:
+	case PR_lchown:
+	case PR_lchown32:
+	case PR_link:
+	case PR_linkat:
+	case PR_lremovexattr:
+	case PR_lsetxattr:
+	case PR_mkdir:
+	case PR_mkdirat:
+	case PR_mknod:
+	case PR_mknodat:
+	case PR_removexattr:
+	case PR_rename:
+	case PR_renameat:
+	case PR_renameat2:
+	case PR_rmdir:
+	case PR_setxattr:
+	case PR_swapon:
+	case PR_symlink:
+	case PR_symlinkat:
+	case PR_truncate:
+	case PR_truncate64:
+	case PR_unlink:
+	case PR_unlinkat:
+	case PR_utime:
+	case PR_utimensat:
+	case PR_utimensat_time64:
+	case PR_utimes:
+		return ACCESS_WRITE;
+
+	default:
+		return ACCESS_READ;
+	}
+}
+
+/**
+ * Check the translated @path against the longest matching policy,
+ * regarding the current syscall of @tracee.  This function returns
+ * -errno if the access is not allowed, otherwise 0.
+ */
+int check_policies(const Tracee *tracee, const char path[PATH_MAX])
+{
+	size_t path_length = strlen(path);
+	const Policy *policy = NULL;
+	size_t nb_policies;
+	Access access;
+	size_t i;
+
+	if (tracee == NULL)
+		return 0;
+
+	nb_policies = talloc_array_length(policies);
+	for (i = 0; i < nb_policies; i++) {
+		Comparison comparison;
+
+		comparison = compare_paths2(policies[i].path, policies[i].length, path, path_length);
+		if (   comparison == PATHS_ARE_EQUAL
+		    || comparison == PATH1_IS_PREFIX) {
+			policy = &policies[i];
+			break;
+		}
+	}
+
+	if (policy == NULL || policy->flags == 0)
+		return 0;
+
+	if ((policy->flags & POLICY_HIDE) != 0)
+		return -ENOENT;
+
+	if ((policy->flags & POLICY_DENY) != 0)
+		return -EACCES;
+
+	access = get_access(tracee);
+
+	if ((policy->flags & POLICY_RO) != 0 && access == ACCESS_WRITE)
+		return -EROFS;
+
+	if ((policy->flags & POLICY_NOEXEC) != 0 && access == ACCESS_EXEC)
+		return -EACCES;
+
+	return 0;
+}
+
+/**
+ * Check the file referenced by the file descriptor @fd of @tracee --
+ * or by its current working directory if @fd is AT_FDCWD -- against
+ * the longest matching policy, regarding the current syscall of
+ * @tracee.  This function returns -errno if the access is not
+ * allowed, otherwise 0.
+ */
+int check_fd_policies(const Tracee *tracee, int fd)
+{
+	char path[PATH_MAX];
+	char link[64];
+	struct stat statl;
+	struct stat statl2;
+	ssize_t length;
+	int status;
+
+	if (tracee == NULL)
+		return 0;
+
+	if (fd == AT_FDCWD)
+		status = snprintf(link, sizeof(link), "/proc/%d/cwd", tracee->pid);
+	else
+		status = snprintf(link, sizeof(link), "/proc/%d/fd/%d", tracee->pid, fd);
+	if (status < 0 || (size_t) status >= sizeof(link))
+		return 0;
+
+	/* Invalid file descriptors are reported by the kernel.  */
+	length = readlink(link, path, sizeof(path) - 1);
+	if (length < 0)
+		return 0;
+	path[length] = '\0';
+
+	/* Pipes, sockets, memfds, deleted files, ...  are not
+	 * reachable through the file-system.  */
+	if (   path[0] != '/'
+	    || stat(link, &statl) < 0
+	    || stat(path, &statl2) < 0
+	    || statl.st_dev != statl2.st_dev
+	    || statl.st_ino != statl2.st_ino)
+		return 0;
+
+	return check_policies(tracee, path);
+}
@@ -0,0 +1,75 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef POLICY_H
+#define POLICY_H
+
+#include <limits.h> /* PATH_MAX, */
+#include <stddef.h> /* size_t, */
+
+#include "tracee/tracee.h"
+
+typedef enum {
+	POLICY_RO     = 1 << 0,
+	POLICY_HIDE   = 1 << 1,
+	POLICY_DENY   = 1 << 2,
+	POLICY_NOEXEC = 1 << 3,
+} PolicyFlags;
+
+typedef struct {
+	/* Canonicalized host path, once initialized.  */
+	char *path;
+	size_t length;
+
+	PolicyFlags flags;
+} Policy;
+
+/* Policies sorted by decreasing length, NULL if none.  */
+extern Policy *policies;
+
+extern int new_policy(Tracee *tracee, const char *value);
+extern int initialize_policies(Tracee *tracee);
+extern int check_policies(const Tracee *tracee, const char path[PATH_MAX]);
+extern int check_fd_policies(const Tracee *tracee, int fd);
+
+/**
+ * Check whether the current syscall of @tracee is allowed to access
+ * the translated @path.  This function returns -errno if it is not,
+ * otherwise 0.  It costs nothing when no policies are defined.
+ */
+static inline int check_policy(const Tracee *tracee, const char path[PATH_MAX])
+{
+	if (policies == NULL)
+		return 0;
+	return check_policies(tracee, path);
+}
+
+/**
+ * Same as check_policy() for the file referenced by the file
+ * descriptor @fd of @tracee.
+ */
+static inline int check_fd_policy(const Tracee *tracee, int fd)
+{
+	if (policies == NULL)
+		return 0;
+	return check_fd_policies(tracee, fd);
+}
+
+#endif /* POLICY_H */
@@ -22,134 +22,223 @@
 
 #include <stdio.h>   /* snprintf(3), */
 #include <string.h>  /* strcmp(3), */
-#include <stdlib.h>  /* atoi(3), strtol(3), */
+#include <stdlib.h>  /* strtol(3), */
 #include <errno.h>   /* E*, */
 #include <assert.h>  /* assert(3), */
+#include <limits.h>  /* INT_MAX, */
+#include <fcntl.h>   /* open(2), O_*, */
+#include <unistd.h>  /* read(2), close(2), */
+#include <talloc.h>  /* talloc_*, */
 
 #include "path/proc.h"
 #include "tracee/tracee.h"
 #include "path/path.h"
 #include "path/binding.h"
+#include "path/temp.h"
+#include "attribute.h"
+
+/* Directories in "/proc" where links are emulated.  */
+typedef enum {
+	PROC_ROOT,	/* "/proc"  */
+	PROC_PID,	/* "/proc/<PID>" or "/proc/<PID>/task/<TID>"  */
+	PROC_PID_FD,	/* "/proc/<PID>/fd" or "/proc/<PID>/task/<TID>/fd"  */
+	PROC_OTHER,
+} ProcDirectory;
 
 /**
- * This function emulates the @result of readlink("@base/@component")
- * with respect to @tracee, where @base belongs to "/proc" (according
- * to @comparison).  This function returns -errno on error, an enum
- * @action otherwise (c.f. above).
- *
- * Unlike readlink(), this function includes the nul terminating byte
- * to @result.
+ * Parse the decimal number pointed to by *@cursor, then make
+ * *@cursor point right after it.  This function returns 0 if there's
+ * no valid PID at this place, otherwise this PID.
  */
-Action readlink_proc(const Tracee *tracee, char result[PATH_MAX],
-			const char base[PATH_MAX], const char component[NAME_MAX],
-			Comparison comparison)
+static pid_t parse_pid(const char **cursor)
 {
-	const Tracee *known_tracee;
-	char proc_path[64]; /* 64 > sizeof("/proc//fd/") + 2 * sizeof(#ULONG_MAX) */
-	int status;
-	pid_t pid;
+	const char *start = *cursor;
+	long value = 0;
 
-	assert(comparison == compare_paths("/proc", base));
+	for (; **cursor >= '0' && **cursor <= '9'; (*cursor)++) {
+		value = value * 10 + (**cursor - '0');
+		if (value > INT_MAX)
+			return 0;
+	}
 
-	/* Remember: comparison = compare_paths("/proc", base)  */
-	switch (comparison) {
-	case PATHS_ARE_EQUAL:
-		/* Substitute "/proc/self" with "/proc/<PID>".  */
-		if (strcmp(component, "self") != 0)
-			return DEFAULT;
+	return (*cursor != start ? value : 0);
+}
 
-		status = snprintf(result, PATH_MAX, "/proc/%d", tracee->pid);
-		if (status < 0 || status >= PATH_MAX)
-			return -EPERM;
+/**
+ * Identify in a single pass which directory @base -- a canonicalized
+ * path under "/proc" -- is, and store into @pid the PID (or TID) it
+ * refers to, if any.
+ */
+static ProcDirectory parse_proc_directory(const char base[PATH_MAX], pid_t *pid)
+{
+	const char *cursor = base + strlen("/proc");
 
-		return CANONICALIZE;
+	if (cursor[0] == '\0')
+		return PROC_ROOT;
+	cursor++;
 
-	case PATH1_IS_PREFIX:
-		/* Handle "/proc/<PID>" below, where <PID> is process
-		 * monitored by PRoot.  */
-		break;
+	*pid = parse_pid(&cursor);
+	if (*pid == 0)
+		return PROC_OTHER;
 
-	default:
-		return DEFAULT;
+	/* Links in "/proc/<PID>/task/<TID>/" are those of the
+	 * thread <TID>.  */
+	if (strncmp(cursor, "/task/", strlen("/task/")) == 0) {
+		cursor += strlen("/task/");
+		*pid = parse_pid(&cursor);
+		if (*pid == 0)
+			return PROC_OTHER;
 	}
 
-	pid = atoi(base + strlen("/proc/"));
-	if (pid == 0)
-		return DEFAULT;
+	if (cursor[0] == '\0')
+		return PROC_PID;
+
+	if (strcmp(cursor, "/fd") == 0)
+		return PROC_PID_FD;
 
-	/* Handle links in "/proc/<PID>/".  */
-	status = snprintf(proc_path, sizeof(proc_path), "/proc/%d", pid);
-	if (status < 0 || (size_t) status >= sizeof(proc_path))
+	return PROC_OTHER;
+}
+
+/**
+ * Copy @string into @result.
+ */
+static Action substitute_link(char result[PATH_MAX], const char *string)
+{
+	size_t length;
+
+	length = strlen(string);
+	if (length >= PATH_MAX)
 		return -EPERM;
 
-	comparison = compare_paths(proc_path, base);
-	switch (comparison) {
-	case PATHS_ARE_EQUAL:
-		known_tracee = get_tracee(tracee, pid, false);
-		if (known_tracee == NULL)
-			return DEFAULT;
-
-#define SUBSTITUTE(name, string)				\
-		do {						\
-			if (strcmp(component, #name) != 0)	\
-				break;				\
-								\
-			status = strlen(string);		\
-			if (status >= PATH_MAX)			\
-				return -EPERM;			\
-								\
-			strncpy(result, string, status + 1);	\
-			return CANONICALIZE;			\
-		} while (0)
-
-		/* Substitute link "/proc/<PID>/???" with the content
-		 * of tracee->???.  */
-		SUBSTITUTE(exe, known_tracee->exe);
-		SUBSTITUTE(cwd, known_tracee->fs->cwd);
-		SUBSTITUTE(root, get_root(known_tracee));
-#undef SUBSTITUTE
-		return DEFAULT;
+	memcpy(result, string, length + 1);
+	return CANONICALIZE;
+}
+
+/* Substitute "/proc/self" with "/proc/<PID>".  */
+static Action resolve_self(const Tracee *tracee, pid_t pid UNUSED,
+			const char base[PATH_MAX] UNUSED, const char component[NAME_MAX] UNUSED,
+			char result[PATH_MAX])
+{
+	int status;
 
-	case PATH1_IS_PREFIX:
-		/* Handle "/proc/<PID>/???" below.  */
-		break;
+	status = snprintf(result, PATH_MAX, "/proc/%d", tracee->pid);
+	if (status < 0 || status >= PATH_MAX)
+		return -EPERM;
 
-	default:
-		return DEFAULT;
-	}
+	return CANONICALIZE;
+}
+
+/* Substitute "/proc/thread-self" with "/proc/<TID>/task/<TID>".  */
+static Action resolve_thread_self(const Tracee *tracee, pid_t pid UNUSED,
+				const char base[PATH_MAX] UNUSED, const char component[NAME_MAX] UNUSED,
+				char result[PATH_MAX])
+{
+	int status;
+
+	status = snprintf(result, PATH_MAX, "/proc/%1$d/task/%1$d", tracee->pid);
+	if (status < 0 || status >= PATH_MAX)
+		return -EPERM;
+
+	return CANONICALIZE;
+}
+
+/* Substitute links "/proc/<PID>/???" with the content of
+ * known_tracee->???, where <PID> is a process monitored by PRoot.  */
+#define RESOLVE_TRACEE_LINK(name, string)					\
+static Action resolve_##name(const Tracee *tracee, pid_t pid,			\
+			const char base[PATH_MAX] UNUSED,			\
+			const char component[NAME_MAX] UNUSED,			\
+			char result[PATH_MAX])					\
+{										\
+	const Tracee *known_tracee;						\
+										\
+	known_tracee = get_tracee(tracee, pid, false);				\
+	if (known_tracee == NULL)						\
+		return DEFAULT;							\
+										\
+	return substitute_link(result, string);					\
+}
+
+RESOLVE_TRACEE_LINK(exe, known_tracee->exe)
+RESOLVE_TRACEE_LINK(cwd, known_tracee->fs->cwd)
+RESOLVE_TRACEE_LINK(root, get_root(known_tracee))
+#undef RESOLVE_TRACEE_LINK
+
+/* Don't dereference "/proc/<PID>/fd/???" now: they can point to
+ * anonymous pipe, socket, ...  otherwise they point to a path
+ * already canonicalized by the kernel.
+ *
+ * Note they are still correctly detranslated in syscall/exit.c if a
+ * monitored process uses readlink() against any of them.  */
+static Action resolve_fd(const Tracee *tracee UNUSED, pid_t pid UNUSED,
+			const char base[PATH_MAX], const char component[NAME_MAX],
+			char result[PATH_MAX])
+{
+	char *end_ptr;
+	int status;
 
-	/* Handle links in "/proc/<PID>/fd/".  */
-	status = snprintf(proc_path, sizeof(proc_path), "/proc/%d/fd", pid);
-	if (status < 0 || (size_t) status >= sizeof(proc_path))
+	/* Sanity check: a number is expected.  */
+	errno = 0;
+	(void) strtol(component, &end_ptr, 10);
+	if (errno != 0 || end_ptr == component)
 		return -EPERM;
 
-	comparison = compare_paths(proc_path, base);
-	switch (comparison) {
-		char *end_ptr;
+	status = snprintf(result, PATH_MAX, "%s/%s", base, component);
+	if (status < 0 || status >= PATH_MAX)
+		return -EPERM;
 
-	case PATHS_ARE_EQUAL:
-		/* Sanity check: a number is expected.  */
-		errno = 0;
-		(void) strtol(component, &end_ptr, 10);
-		if (errno != 0 || end_ptr == component)
-			return -EPERM;
+	return DONT_CANONICALIZE;
+}
 
-		/* Don't dereference "/proc/<PID>/fd/???" now: they
-		 * can point to anonymous pipe, socket, ...  otherwise
-		 * they point to a path already canonicalized by the
-		 * kernel.
-		 *
-		 * Note they are still correctly detranslated in
-		 * syscall/exit.c if a monitored process uses
-		 * readlink() against any of them.  */
-		status = snprintf(result, PATH_MAX, "%s/%s", base, component);
-		if (status < 0 || status >= PATH_MAX)
-			return -EPERM;
+/* Links in "/proc" emulated by PRoot.  */
+static const struct {
+	ProcDirectory directory;
+	const char *name; /* NULL matches any name.  */
+	Action (*resolve)(const Tracee *tracee, pid_t pid, const char base[PATH_MAX],
+			const char component[NAME_MAX], char result[PATH_MAX]);
+} proc_links[] = {
+	{ PROC_ROOT,	"self",		resolve_self },
+	{ PROC_ROOT,	"thread-self",	resolve_thread_self },
+	{ PROC_PID,	"exe",		resolve_exe },
+	{ PROC_PID,	"cwd",		resolve_cwd },
+	{ PROC_PID,	"root",		resolve_root },
+	{ PROC_PID_FD,	NULL,		resolve_fd },
+};
 
-		return DONT_CANONICALIZE;
+/**
+ * This function emulates the @result of readlink("@base/@component")
+ * with respect to @tracee, where @base belongs to "/proc" (according
+ * to @comparison).  This function returns -errno on error, an enum
+ * @action otherwise (c.f. above).
+ *
+ * Unlike readlink(), this function includes the nul terminating byte
+ * to @result.
+ */
+Action readlink_proc(const Tracee *tracee, char result[PATH_MAX],
+			const char base[PATH_MAX], const char component[NAME_MAX],
+			Comparison comparison)
+{
+	ProcDirectory directory;
+	pid_t pid = 0;
+	size_t i;
+
+	assert(comparison == compare_paths("/proc", base));
+	assert(comparison == PATHS_ARE_EQUAL || comparison == PATH1_IS_PREFIX);
+
+	directory = parse_proc_directory(base, &pid);
+	if (directory == PROC_OTHER)
+		return DEFAULT;
 
-	default:
-		break;
+	/* The known tracee is searched for only once the link is
+	 * known to be emulated.  */
+	for (i = 0; i < sizeof(proc_links) / sizeof(proc_links[0]); i++) {
+		if (proc_links[i].directory != directory)
+			continue;
+
+		if (proc_links[i].name != NULL && strcmp(proc_links[i].name, component) != 0)
+			continue;
+
+		return proc_links[i].resolve(tracee, pid, base, component, result);
 	}
 
 	return DEFAULT;
@@ -193,3 +282,424 @@ ssize_t readlink_proc2(const Tracee *tracee, char result[PATH_MAX], const char r
 	action = readlink_proc(tracee, result, base, component, PATH1_IS_PREFIX);
 	return (action == CANONICALIZE ? strlen(result) : 0);
 }
+
+/**
+ * Write @path to @file, with the same escaping as the kernel does in
+ * "/proc/<PID>/mountinfo" for instance.
+ */
+static void print_mount_path(FILE *file, const char *path)
+{
+	for (; *path != '\0'; path++) {
+		if (strchr(" \t\n\\", *path) != NULL)
+			fprintf(file, "\\%03o", (unsigned char) *path);
+		else
+			fputc(*path, file);
+	}
+}
+
+/**
+ * Write to @file the content of "/proc/<PID>/mountinfo" for
+ * @known_tracee: each of its bindings is reported as a mount point.
+ */
+static void fill_mountinfo(Tracee *tracee UNUSED, const Tracee *known_tracee,
+			const char *raw UNUSED, size_t raw_size UNUSED, FILE *file)
+{
+	const Bindings *bindings = known_tracee->fs->bindings.guest;
+	const Binding *binding;
+	const Binding *parent;
+	int parent_id;
+	int id = 0;
+
+	/* Bindings are sorted from the deepest to the shallowest one
+	 * (the rootfs is the last one), whereas parent mount points
+	 * are reported first in this file.  */
+	for (binding = CIRCLEQ_LAST(bindings);
+	     binding != (void *) bindings;
+	     binding = CIRCLEQ_PREV(binding, link.guest)) {
+		id++;
+
+		/* The closest enclosing binding was already
+		 * reported, the rootfs is its own parent.  */
+		parent_id = id;
+		for (parent = CIRCLEQ_NEXT(binding, link.guest);
+		     parent != (void *) bindings;
+		     parent = CIRCLEQ_NEXT(parent, link.guest)) {
+			parent_id--;
+			if (compare_paths(parent->guest.path, binding->guest.path) == PATH1_IS_PREFIX)
+				break;
+		}
+		if (parent == (void *) bindings)
+			parent_id = id;
+
+		fprintf(file, "%d %d 0:%d / ", id, parent_id, id);
+		print_mount_path(file, binding->guest.path);
+		fprintf(file, " rw - %1$s %1$s rw\n", binding->fstype ?: "none");
+	}
+}
+
+/**
+ * Write to @file the content of "/proc/<PID>/mounts" for
+ * @known_tracee, c.f. fill_mountinfo().
+ */
+static void fill_mounts(Tracee *tracee UNUSED, const Tracee *known_tracee,
+			const char *raw UNUSED, size_t raw_size UNUSED, FILE *file)
+{
+	const Bindings *bindings = known_tracee->fs->bindings.guest;
+	const Binding *binding;
+
+	for (binding = CIRCLEQ_LAST(bindings);
+	     binding != (void *) bindings;
+	     binding = CIRCLEQ_PREV(binding, link.guest)) {
+		const char *fstype = binding->fstype ?: "none";
+
+		fprintf(file, "%s ", fstype);
+		print_mount_path(file, binding->guest.path);
+		fprintf(file, " %s rw 0 0\n", fstype);
+	}
+}
+
+/**
+ * Write to @file the @raw content of "/proc/<PID>/maps" -- or
+ * "/proc/<PID>/smaps" -- where the path of each mapped file is
+ * detranslated from the @tracee's point-of-view.
+ */
+static void fill_maps(Tracee *tracee, const Tracee *known_tracee UNUSED,
+		const char *raw, size_t raw_size, FILE *file)
+{
+	char previous_host_path[PATH_MAX] = "";
+	char previous_guest_path[PATH_MAX] = "";
+	const char *end = raw + raw_size;
+	const char *line;
+	const char *next;
+
+	for (line = raw; line < end; line = next) {
+		char buffer[PATH_MAX + 128];
+		char path[PATH_MAX];
+		const char *suffix;
+		size_t length;
+		int offset;
+		int status;
+
+		next = memchr(line, '\n', end - line);
+		next = (next != NULL ? next + 1 : end);
+		length = next - line;
+
+		/* Only the first line of each entry ends with the
+		 * path of the mapped file, the other ones -- in
+		 * "smaps" -- are copied verbatim.  */
+		if (length >= sizeof(buffer))
+			goto verbatim;
+
+		memcpy(buffer, line, length);
+		buffer[length] = '\0';
+		if (buffer[length - 1] == '\n')
+			buffer[length - 1] = '\0';
+
+		offset = -1;
+		(void) sscanf(buffer, "%*x-%*x %*s %*x %*x:%*x %*u %n", &offset);
+		if (offset < 0 || buffer[offset] != '/')
+			goto verbatim;
+
+		/* The kernel appends this suffix to the path of
+		 * mapped files that were unlinked.  */
+		length = strlen(buffer + offset);
+		suffix = "";
+		if (length > strlen(" (deleted)")
+		    && strcmp(buffer + offset + length - strlen(" (deleted)"), " (deleted)") == 0) {
+			suffix = " (deleted)";
+			length -= strlen(" (deleted)");
+			buffer[offset + length] = '\0';
+		}
+
+		/* Consecutive entries usually refer to the same file.  */
+		if (strcmp(buffer + offset, previous_host_path) != 0) {
+			strcpy(previous_host_path, buffer + offset);
+			strcpy(path, buffer + offset);
+
+			/* Paths outside of the guest rootfs -- like
+			 * PRoot's loader -- are left unchanged.  */
+			status = detranslate_path(tracee, path, NULL);
+			strcpy(previous_guest_path, status < 0 ? buffer + offset : path);
+		}
+
+		buffer[offset] = '\0';
+		fprintf(file, "%s%s%s%s", buffer, previous_guest_path, suffix,
+			next[-1] == '\n' ? "\n" : "");
+		continue;
+
+	verbatim:
+		fwrite(line, 1, length, file);
+	}
+}
+
+/**
+ * Return whether the bindings of @known_tracee include at least one
+ * emulated mount, c.f. emulate_mount() in fake_id0.
+ */
+static bool has_emulated_mounts(const Tracee *known_tracee)
+{
+	const Bindings *bindings = known_tracee->fs->bindings.guest;
+	const Binding *binding;
+
+	for (binding = CIRCLEQ_FIRST(bindings);
+	     binding != (void *) bindings;
+	     binding = CIRCLEQ_NEXT(binding, link.guest)) {
+		if (binding->fstype != NULL)
+			return true;
+	}
+
+	return false;
+}
+
+/* Files in "/proc/<PID>/" whose content is emulated.  The content
+ * of the "filtered" ones is derived from the actual file, and the
+ * "cached" ones are kept until either the content of this latter or
+ * the bindings change.  Note that "smaps" also reports memory usage counters,
+ * hence it is never cached.  */
+static const struct {
+	const char *name;
+	void (*fill)(Tracee *tracee, const Tracee *known_tracee,
+		const char *raw, size_t raw_size, FILE *file);
+	bool filtered;
+	bool cached;
+} proc_files[] = {
+	{ "mountinfo",	fill_mountinfo,	false,	false },
+	{ "mounts",	fill_mounts,	false,	false },
+	{ "maps",	fill_maps,	true,	true },
+	{ "smaps",	fill_maps,	true,	false },
+};
+
+/* Emulated file in "/proc/<PID>/", as cached in @tracee->proc_cache.  */
+typedef struct proc_cache {
+	const char *name;
+
+	/* Point-of-view it was generated for.  */
+	const Bindings *bindings;
+	unsigned long bindings_generation;
+
+	/* Content of the actual file it was generated from.  */
+	const char *raw;
+	size_t raw_size;
+
+	const char *path;
+
+	struct proc_cache *next;
+} ProcCache;
+
+/**
+ * Read the whole content of the file pointed to by @path into
+ * @content, allocated within the given Talloc @context.  Its size is
+ * stored into @size.  This function returns -errno if an error
+ * occured, otherwise 0.
+ */
+static int read_whole_file(TALLOC_CTX *context, const char *path, char **content, size_t *size)
+{
+	size_t capacity = 4096;
+	ssize_t status;
+	int fd;
+
+	/* Files in "/proc" report a null size, so it has to be read
+	 * until the end.  */
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+
+	*content = talloc_size(context, capacity);
+	*size = 0;
+
+	while (*content != NULL) {
+		if (*size == capacity) {
+			capacity *= 2;
+			*content = talloc_realloc_size(context, *content, capacity);
+			if (*content == NULL)
+				break;
+		}
+
+		status = read(fd, *content + *size, capacity - *size);
+		if (status < 0) {
+			status = -errno;
+			close(fd);
+			return status;
+		}
+		if (status == 0)
+			break;
+
+		*size += status;
+	}
+
+	close(fd);
+	return (*content != NULL ? 0 : -ENOMEM);
+}
+
+/**
+ * Generate into a new temporary file -- whose path is stored into
+ * @temp_path and whose lifetime is tied to @context -- the emulated
+ * content of the @index-th entry in proc_files[].  This function
+ * returns -errno if an error occured, otherwise 0.
+ */
+static int generate_proc_file(Tracee *tracee, const Tracee *known_tracee, size_t index,
+			const char *raw, size_t raw_size, TALLOC_CTX *context,
+			const char **temp_path)
+{
+	FILE *file;
+
+	*temp_path = create_temp_file(context, "proot-proc");
+	if (*temp_path == NULL)
+		return -ENOMEM;
+
+	file = fopen(*temp_path, "w");
+	if (file == NULL)
+		return -errno;
+
+	proc_files[index].fill(tracee, known_tracee, raw, raw_size, file);
+
+	if (ferror(file) != 0) {
+		fclose(file);
+		return -EIO;
+	}
+
+	if (fclose(file) != 0)
+		return -errno;
+
+	return 0;
+}
+
+/**
+ * Substitute @path -- a host path about to be read by @tracee -- with
+ * a temporary file that contains the emulated content of
+ * "/proc/<PID>/<NAME>", if <PID> is a known tracee and <NAME> is
+ * listed in proc_files[].  This temporary file is either removed as
+ * soon as @tracee->ctx is freed, that is, once the current syscall
+ * has opened it, or cached until the known tracee calls execve(2).
+ * This function returns -errno if an error occured, otherwise 0.
+ */
+int emulate_proc_file(Tracee *tracee, char path[PATH_MAX])
+{
+	Tracee *known_tracee;
+	const char *temp_path;
+	const char *name;
+	ProcCache **cache;
+	ProcCache *entry;
+	char *end_ptr;
+	size_t raw_size = 0;
+	char *raw = NULL;
+	size_t i;
+	pid_t pid;
+	int status;
+
+	if (strncmp(path, "/proc/", strlen("/proc/")) != 0)
+		return 0;
+
+	errno = 0;
+	pid = strtol(path + strlen("/proc/"), &end_ptr, 10);
+	if (errno != 0 || end_ptr == path + strlen("/proc/") || end_ptr[0] != '/')
+		return 0;
+	name = end_ptr + 1;
+
+	for (i = 0; i < sizeof(proc_files) / sizeof(proc_files[0]); i++) {
+		if (strcmp(name, proc_files[i].name) == 0)
+			break;
+	}
+	if (i == sizeof(proc_files) / sizeof(proc_files[0]))
+		return 0;
+
+	known_tracee = get_tracee(tracee, pid, false);
+	if (known_tracee == NULL || known_tracee->fs->bindings.guest == NULL)
+		return 0;
+
+	if (!proc_files[i].filtered) {
+		/* The actual mount table is accurate enough as long
+		 * as no mount was emulated.  */
+		if (!has_emulated_mounts(known_tracee))
+			return 0;
+
+		status = generate_proc_file(tracee, known_tracee, i, NULL, 0,
+					tracee->ctx, &temp_path);
+		if (status < 0)
+			return status;
+
+		strcpy(path, temp_path);
+		return 0;
+	}
+
+	if (!proc_files[i].cached) {
+		/* Let the kernel report the error if the actual file
+		 * can't be read by PRoot.  */
+		status = read_whole_file(tracee->ctx, path, &raw, &raw_size);
+		if (status < 0)
+			return 0;
+
+		status = generate_proc_file(tracee, known_tracee, i, raw, raw_size,
+					tracee->ctx, &temp_path);
+		if (status < 0)
+			return status;
+
+		strcpy(path, temp_path);
+		return 0;
+	}
+
+	/* Same as above.  */
+	status = read_whole_file(tracee->ctx, path, &raw, &raw_size);
+	if (status < 0)
+		return 0;
+
+	/* The memory mappings might have changed without notice
+	 * since mmap(2), mprotect(2) & co. are not traced, that's why
+	 * the cached file is reused only if the actual content is
+	 * unchanged.  This still saves its detranslation.  */
+	for (cache = &known_tracee->proc_cache; *cache != NULL; cache = &(*cache)->next) {
+		if ((*cache)->name == proc_files[i].name
+		    && (*cache)->bindings == tracee->fs->bindings.guest)
+			break;
+	}
+
+	if (*cache != NULL) {
+		entry = *cache;
+		if (   entry->bindings_generation == get_bindings_generation()
+		    && entry->raw_size == raw_size
+		    && memcmp(entry->raw, raw, raw_size) == 0) {
+			strcpy(path, entry->path);
+			return 0;
+		}
+
+		*cache = entry->next;
+		TALLOC_FREE(entry);
+	}
+
+	entry = talloc_zero(known_tracee, ProcCache);
+	if (entry == NULL)
+		return -ENOMEM;
+
+	status = generate_proc_file(tracee, known_tracee, i, raw, raw_size, entry, &temp_path);
+	if (status < 0) {
+		TALLOC_FREE(entry);
+		return status;
+	}
+
+	entry->name = proc_files[i].name;
+	entry->bindings = tracee->fs->bindings.guest;
+	entry->bindings_generation = get_bindings_generation();
+	entry->raw = talloc_steal(entry, raw);
+	entry->raw_size = raw_size;
+	entry->path = temp_path;
+
+	entry->next = known_tracee->proc_cache;
+	known_tracee->proc_cache = entry;
+
+	strcpy(path, temp_path);
+	return 0;
+}
+
+/**
+ * Drop the emulated files in "/proc/<PID>/" cached for @tracee.
+ */
+void invalidate_proc_cache(Tracee *tracee)
+{
+	ProcCache *entry;
+
+	while (tracee->proc_cache != NULL) {
+		entry = tracee->proc_cache;
+		tracee->proc_cache = entry->next;
+		TALLOC_FREE(entry);
+	}
+}
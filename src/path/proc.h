@@ -41,4 +41,7 @@ extern Action readlink_proc(const Tracee *tracee, char result[PATH_MAX], const c
 
 extern ssize_t readlink_proc2(const Tracee *tracee, char result[PATH_MAX], const char path[PATH_MAX]);
 
+extern int emulate_proc_file(Tracee *tracee, char path[PATH_MAX]);
+extern void invalidate_proc_cache(Tracee *tracee);
+
 #endif /* PROC_H */
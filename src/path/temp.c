@@ -1,15 +1,23 @@
 #include <sys/types.h>  /* stat(2), opendir(3), */
 #include <sys/stat.h>   /* stat(2), chmod(2), */
+#include <sys/file.h>   /* flock(2), */
 #include <unistd.h>     /* stat(2), rmdir(2), unlink(2), readlink(2), */
 #include <errno.h>      /* errno(2), */
 #include <dirent.h>     /* readdir(3), opendir(3), */
 #include <string.h>     /* strcmp(3), */
-#include <stdlib.h>     /* free(3), getenv(3), */
+#include <stdlib.h>     /* free(3), getenv(3), atoi(3), */
 #include <stdio.h>      /* P_tmpdir, */
+#include <fcntl.h>      /* open(2), O_*, */
+#include <signal.h>     /* kill(2), */
 #include <talloc.h>     /* talloc(3), */
 
+#include "path/temp.h"
 #include "cli/note.h"
 
+/* Prefix of the directory that contains all the temporary files of
+ * a PRoot session, see get_temp_session().  */
+#define SESSION_PREFIX "proot-session-"
+
 /**
  * Return the path to a directory where temporary files should be
  * created.
@@ -246,12 +254,20 @@ end:
 }
 
 /**
- * Like remove_temp_directory2() but always return 0.
+ * Like remove_temp_directory2() but always return 0.  Nothing is done
+ * if @path was already removed along with the session directory.
  *
  * Note: this is a talloc destructor.
  */
 static int remove_temp_directory(char *path)
 {
+	struct stat statl;
+	int status;
+
+	status = lstat(path, &statl);
+	if (status < 0 && errno == ENOENT)
+		return 0;
+
 	(void) remove_temp_directory2(path);
 	return 0;
 }
@@ -266,27 +282,134 @@ static int remove_temp_file(char *path)
 	int status;
 
 	status = unlink(path);
-	if (status < 0)
+	if (status < 0 && errno != ENOENT)
 		note(NULL, ERROR, SYSTEM, "can't remove '%s'", path);
 
 	return 0;
 }
 
+/**
+ * Return the path to the directory where all the temporary files of
+ * this PRoot session are created, or NULL if an error occurred.  This
+ * directory is created on first use, and it is removed on PRoot
+ * termination.  It remains locked as long as PRoot is alive, even if
+ * this latter is killed, c.f. reap_stale_temp_sessions().
+ */
+static const char *get_temp_session()
+{
+	static char *session = NULL;
+	int status;
+	int fd;
+
+	if (session != NULL)
+		return session;
+
+	session = talloc_asprintf(talloc_autofree_context(), "%s/" SESSION_PREFIX "%d-XXXXXX",
+				get_temp_directory(), getpid());
+	if (session == NULL) {
+		note(NULL, ERROR, INTERNAL, "can't allocate memory");
+		return NULL;
+	}
+
+	if (mkdtemp(session) == NULL) {
+		note(NULL, ERROR, SYSTEM, "can't create temporary directory");
+		note(NULL, INFO, USER, "Please set PROOT_TMP_DIR env. variable "
+			"to an alternate location (with write permission).");
+		TALLOC_FREE(session);
+		return NULL;
+	}
+
+	talloc_set_destructor(session, remove_temp_directory);
+
+	/* This file descriptor is intentionally never closed: the
+	 * lock is released by the kernel once PRoot terminates.  */
+	fd = open(session, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	status = (fd < 0 ? -1 : flock(fd, LOCK_EX | LOCK_NB));
+	if (status < 0)
+		note(NULL, WARNING, SYSTEM, "can't lock '%s'", session);
+
+	return session;
+}
+
+/**
+ * Remove the session directories -- c.f. get_temp_session() -- left
+ * behind by PRoot instances that were killed.  A session is stale
+ * once both its owner is dead and its lock is released.  Note:
+ * @tracee is only used for notification purpose.
+ */
+void reap_stale_temp_sessions(const Tracee *tracee)
+{
+	const char *temp_directory = get_temp_directory();
+	struct dirent *entry;
+	struct stat statl;
+	char *path;
+	DIR *dir;
+	pid_t pid;
+	int status;
+	int fd;
+
+	dir = opendir(temp_directory);
+	if (dir == NULL)
+		return;
+
+	while ((entry = readdir(dir)) != NULL) {
+		if (strncmp(entry->d_name, SESSION_PREFIX, strlen(SESSION_PREFIX)) != 0)
+			continue;
+
+		/* The lock is not taken yet right after the creation
+		 * of the directory, hence this check on its owner.  */
+		pid = atoi(entry->d_name + strlen(SESSION_PREFIX));
+		if (pid <= 0 || pid == getpid() || kill(pid, 0) == 0 || errno != ESRCH)
+			continue;
+
+		path = talloc_asprintf(NULL, "%s/%s", temp_directory, entry->d_name);
+		if (path == NULL)
+			break;
+
+		fd = open(path, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+		if (fd < 0) {
+			TALLOC_FREE(path);
+			continue;
+		}
+
+		/* Don't try to remove sessions of other users.  */
+		status = fstat(fd, &statl);
+		if (status == 0 && statl.st_uid == getuid())
+			status = flock(fd, LOCK_EX | LOCK_NB);
+		else
+			status = -1;
+
+		if (status == 0) {
+			VERBOSE(tracee, 1, "removing stale session '%s'", path);
+			(void) remove_temp_directory2(path);
+		}
+
+		close(fd);
+		TALLOC_FREE(path);
+	}
+
+	(void) closedir(dir);
+}
+
 /**
  * Create a path name with the following format:
- * "/tmp/@prefix-$PID-XXXXXX".  The returned C string is either
- * auto-freed if @context is NULL.  This function returns NULL if an
- * error occurred.
+ * "/tmp/proot-session-$PID-XXXXXX/@prefix-XXXXXX".  The returned C
+ * string is either auto-freed if @context is NULL.  This function
+ * returns NULL if an error occurred.
  */
 char *create_temp_name(TALLOC_CTX *context, const char *prefix)
 {
-	const char *temp_directory = get_temp_directory();
+	const char *session;
 	char *name;
 
+	session = get_temp_session();
+	if (session == NULL)
+		return NULL;
+
 	if (context == NULL)
 		context = talloc_autofree_context();
 
-	name = talloc_asprintf(context, "%s/%s-%d-XXXXXX", temp_directory, prefix, getpid());
+	name = talloc_asprintf(context, "%s/%s-XXXXXX", session, prefix);
 	if (name == NULL) {
 		note(NULL, ERROR, INTERNAL, "can't allocate memory");
 		return NULL;
@@ -353,26 +476,47 @@ const char *create_temp_file(TALLOC_CTX *context, const char *prefix)
 }
 
 /**
- * Like create_temp_file() but returns an open file stream to the
- * created file.  It's up to the caller to close returned stream.
+ * Create an anonymous file -- ie. that has no name in the file-system
+ * -- and return an open file stream to it, or NULL if an error
+ * occurred.  This file is removed as soon as it is closed, even if
+ * PRoot is killed.  Its content remains reachable through
+ * "/proc/self/fd/".  It's up to the caller to close returned stream.
  */
 FILE* open_temp_file(TALLOC_CTX *context, const char *prefix)
 {
+	const char *session;
 	char *name;
 	FILE *file;
+	int status;
 	int fd;
 
+	session = get_temp_session();
+	if (session == NULL)
+		return NULL;
+
+	fd = open(session, O_TMPFILE | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+	if (fd >= 0)
+		goto opened;
+
+	/* Not all file-systems support O_TMPFILE, in this case the
+	 * file is unlinked right after its creation.  */
 	name = create_temp_name(context, prefix);
 	if (name == NULL)
 		return NULL;
 
 	fd = mkstemp(name);
-	if (fd < 0)
+	if (fd < 0) {
+		TALLOC_FREE(name);
 		goto error;
+	}
 
-	talloc_set_destructor(name, remove_temp_file);
+	status = unlink(name);
+	TALLOC_FREE(name);
+	if (status < 0)
+		goto error;
 
-	file = fdopen(fd, "w");
+opened:
+	file = fdopen(fd, "w+");
 	if (file == NULL)
 		goto error;
 
@@ -24,11 +24,15 @@
 #define TEMP_H
 
 #include <talloc.h>
+#include <stdio.h>
+
+#include "tracee/tracee.h"
 
 extern char *create_temp_name(TALLOC_CTX *context, const char *prefix);
 extern const char *create_temp_directory(TALLOC_CTX *context, const char *prefix);
 extern const char *create_temp_file(TALLOC_CTX *context, const char *prefix);
 extern FILE* open_temp_file(TALLOC_CTX *context, const char *prefix);
 extern const char *get_temp_directory();
+extern void reap_stale_temp_sessions(const Tracee *tracee);
 
 #endif /* TEMP_H */
@@ -31,6 +31,8 @@
 #include "syscall/syscall.h"
 #include "syscall/sysnum.h"
 #include "syscall/socket.h"
+#include "syscall/io_uring.h"
+#include "syscall/unknown.h"
 #include "ptrace/ptrace.h"
 #include "ptrace/wait.h"
 #include "syscall/heap.h"
@@ -42,7 +44,11 @@
 #include "tracee/abi.h"
 #include "path/path.h"
 #include "path/canon.h"
+#include "path/proc.h"
+#include "path/cwd.h"
+#include "path/policy.h"
 #include "arch.h"
+#include "compat.h"
 
 /**
  * Translate @path and put the result in the @tracee's memory address
@@ -84,6 +90,135 @@ static int translate_sysarg(Tracee *tracee, Reg reg, Type type)
 	return translate_path2(tracee, AT_FDCWD, old_path, reg, type);
 }
 
+/**
+ * Like translate_path2(), for a @path opened with the given @flags.
+ * The emulated files in "/proc/<PID>/" are substituted when they are
+ * opened for reading only, see emulate_proc_file().
+ */
+static int translate_open_path(Tracee *tracee, int dir_fd, char path[PATH_MAX], Reg reg, int flags)
+{
+	char new_path[PATH_MAX];
+	bool deref_final;
+	int status;
+
+	/* Special case where the argument was NULL. */
+	if (path[0] == '\0')
+		return 0;
+
+	deref_final = (   (flags & O_NOFOLLOW) == 0
+		       && ((flags & O_EXCL) == 0 || (flags & O_CREAT) == 0));
+
+	status = translate_path(tracee, new_path, dir_fd, path, deref_final);
+	if (status < 0)
+		return status;
+
+	if ((flags & O_ACCMODE) == O_RDONLY) {
+		status = emulate_proc_file(tracee, new_path);
+		if (status < 0)
+			return status;
+	}
+
+	return set_sysarg_path(tracee, new_path, reg);
+}
+
+/* RESOLVE_* flags of openat2(2) handled by canonicalize().  */
+#define RESOLVE_TRANSLATED (RESOLVE_NO_XDEV | RESOLVE_NO_MAGICLINKS | RESOLVE_NO_SYMLINKS \
+			  | RESOLVE_BENEATH | RESOLVE_IN_ROOT)
+
+/**
+ * Translate @path of the current openat2(2) of @tracee, relatively
+ * to @dir_fd.  Since the RESOLVE_* flags have a meaning from the
+ * guest point-of-view, they are enforced during the translation then
+ * removed from the copy of struct open_how the kernel is given.  This
+ * function returns -errno if an error occured, otherwise 0.
+ */
+static int translate_openat2(Tracee *tracee, int dir_fd, char path[PATH_MAX])
+{
+	OpenHow how;
+	int status;
+
+	status = get_sysarg_open_how(tracee, CURRENT, &how);
+	if (status < 0)
+		return status;
+
+	if ((how.resolve & RESOLVE_BENEATH) != 0 && (how.resolve & RESOLVE_IN_ROOT) != 0)
+		return -EINVAL;
+
+	/* Let the kernel report the error, if any.  */
+	if (path[0] == '\0')
+		return 0;
+
+	if (path[0] == '/') {
+		/* Absolute paths are not allowed to escape...  */
+		if ((how.resolve & RESOLVE_BENEATH) != 0)
+			return -EXDEV;
+
+		/* ... or are relative to the new "root".  */
+		if ((how.resolve & RESOLVE_IN_ROOT) != 0) {
+			size_t length = strspn(path, "/");
+
+			memmove(path, path + length, strlen(path + length) + 1);
+			if (path[0] == '\0')
+				strcpy(path, ".");
+		}
+	}
+
+	tracee->resolve.flags = how.resolve & RESOLVE_TRANSLATED;
+	status = translate_open_path(tracee, dir_fd, path, SYSARG_2, how.flags);
+	tracee->resolve.flags = 0;
+	tracee->resolve.base = NULL;
+	if (status < 0)
+		return status;
+
+	if ((how.resolve & RESOLVE_TRANSLATED) == 0)
+		return 0;
+
+	/* Don't modify the tracee's own structure, the remaining
+	 * flags (RESOLVE_CACHED, ...) are checked by the kernel.  */
+	how.resolve &= ~RESOLVE_TRANSLATED;
+	status = set_sysarg_data(tracee, &how, sizeof(how), SYSARG_3);
+	if (status < 0)
+		return status;
+
+	poke_reg(tracee, SYSARG_4, sizeof(how));
+	return 0;
+}
+
+/**
+ * Don't stop @tracee at the exit stage of the current rename-like
+ * syscall if this stage is required neither by any extension nor by
+ * translate_syscall_exit(), that is, when no current working
+ * directory is located under the translated path in @reg.  This is
+ * possible only when seccomp is enabled since the exit stage can't
+ * be skipped with ptrace alone.
+ */
+static void skip_rename_sysexit(Tracee *tracee, Reg reg)
+{
+	char path[PATH_MAX];
+	int status;
+
+	if (tracee->seccomp != ENABLED || !tracee->sysexit_pending)
+		return;
+
+	if (extensions_filter_sysexit(tracee, get_sysnum(tracee, ORIGINAL)))
+		return;
+
+	status = get_sysarg_path(tracee, path, reg);
+	if (status < 0)
+		return;
+
+	status = detranslate_path(tracee, path, NULL);
+	if (status < 0)
+		return;
+	chop_finality(path);
+
+	if (has_cwd_under(path))
+		return;
+
+	tracee->restart_how = PTRACE_CONT;
+	tracee->sysexit_pending = false;
+}
+
 /**
  * Translate the input arguments of the current @tracee's syscall in the
  * @tracee->pid process area. This function sets @tracee->status to
@@ -122,6 +257,7 @@ int translate_syscall_enter(Tracee *tracee)
 		break;
 
 	case PR_execve:
+	case PR_execveat:
 		status = translate_execve_enter(tracee);
 		break;
 
@@ -129,6 +265,15 @@ int translate_syscall_enter(Tracee *tracee)
 		status = translate_ptrace_enter(tracee);
 		break;
 
+	case PR_io_uring_setup:
+		status = translate_io_uring_setup(tracee);
+		break;
+
+	case PR_void:
+		/* Unknown to PRoot, hence untranslated.  */
+		status = translate_unknown_syscall(tracee);
+		break;
+
 	case PR_wait4:
 	case PR_waitpid:
 		status = translate_wait_enter(tracee);
@@ -147,7 +292,6 @@ int translate_syscall_enter(Tracee *tracee)
 	case PR_fchdir:
 	case PR_chdir: {
 		struct stat statl;
-		char *tmp;
 
 		/* The ending "." ensures an error will be reported if
 		 * path does not exist or if it is not a directory.  */
@@ -200,15 +344,9 @@ int translate_syscall_enter(Tracee *tracee)
 		/* Remove the trailing "/" or "/.".  */
 		chop_finality(path);
 
-		tmp = talloc_strdup(tracee->fs, path);
-		if (tmp == NULL) {
-			status = -ENOMEM;
+		status = set_cwd(tracee->fs, path);
+		if (status < 0)
 			break;
-		}
-		TALLOC_FREE(tracee->fs->cwd);
-
-		tracee->fs->cwd = tmp;
-		talloc_set_name_const(tracee->fs->cwd, "$cwd");
 
 		set_sysnum(tracee, PR_void);
 		status = 0;
@@ -223,12 +361,12 @@ int translate_syscall_enter(Tracee *tracee)
 		address = peek_reg(tracee, CURRENT, SYSARG_2);
 		size    = peek_reg(tracee, CURRENT, SYSARG_3);
 
-		status = translate_socketcall_enter(tracee, &address, size);
+		status = translate_socketcall_enter(tracee, &address, &size);
 		if (status <= 0)
 			break;
 
 		poke_reg(tracee, SYSARG_2, address);
-		poke_reg(tracee, SYSARG_3, sizeof(struct sockaddr_un));
+		poke_reg(tracee, SYSARG_3, size);
 
 		status = 0;
 		break;
@@ -281,6 +419,7 @@ int translate_syscall_enter(Tracee *tracee)
 	case PR_socketcall: {
 		word_t args_addr;
 		word_t sock_addr_saved;
+		word_t size_saved;
 		word_t sock_addr;
 		word_t size_addr;
 		word_t size;
@@ -331,18 +470,19 @@ int translate_syscall_enter(Tracee *tracee)
 		size      = PEEK_WORD(SYSARG_ADDR(3), 0);
 
 		sock_addr_saved = sock_addr;
-		status = translate_socketcall_enter(tracee, &sock_addr, size);
+		size_saved = size;
+		status = translate_socketcall_enter(tracee, &sock_addr, &size);
 		if (status <= 0)
 			break;
 
 		/* These parameters are used/restored at the exit stage.  */
 		poke_reg(tracee, SYSARG_5, sock_addr_saved);
-		poke_reg(tracee, SYSARG_6, size);
+		poke_reg(tracee, SYSARG_6, size_saved);
 
 		/* Remember: POKE_WORD puts -errno in status and breaks if an
 		 * error occured.  */
 		POKE_WORD(SYSARG_ADDR(2), sock_addr);
-		POKE_WORD(SYSARG_ADDR(3), sizeof(struct sockaddr_un));
+		POKE_WORD(SYSARG_ADDR(3), size);
 
 		status = 0;
 		break;
@@ -384,13 +524,14 @@ int translate_syscall_enter(Tracee *tracee)
 	case PR_open:
 		flags = peek_reg(tracee, CURRENT, SYSARG_2);
 
-		if (   ((flags & O_NOFOLLOW) != 0)
-		    || ((flags & O_EXCL) != 0 && (flags & O_CREAT) != 0))
-			status = translate_sysarg(tracee, SYSARG_1, SYMLINK);
-		else
-			status = translate_sysarg(tracee, SYSARG_1, REGULAR);
+		status = get_sysarg_path(tracee, path, SYSARG_1);
+		if (status < 0)
+			break;
+
+		status = translate_open_path(tracee, AT_FDCWD, path, SYSARG_1, flags);
 		break;
 
+	case PR_fchmodat2:
 	case PR_fchownat:
 	case PR_fstatat64:
 	case PR_newfstatat:
@@ -415,6 +556,30 @@ int translate_syscall_enter(Tracee *tracee)
 			status = translate_path2(tracee, dirfd, path, SYSARG_2, SYMLINK);
 		else
 			status = translate_path2(tracee, dirfd, path, SYSARG_2, REGULAR);
+		if (status < 0 || path[0] != '\0')
+			break;
+
+		/* The file referenced by dirfd is modified, this path
+		 * is either empty with AT_EMPTY_PATH or NULL with
+		 * utimensat(2).  */
+		if (   (   (syscall_number == PR_fchmodat2 || syscall_number == PR_fchownat)
+			&& (flags & AT_EMPTY_PATH) != 0)
+		    || syscall_number == PR_utimensat
+		    || syscall_number == PR_utimensat_time64)
+			status = check_fd_policy(tracee, dirfd);
+		break;
+
+	case PR_fallocate:
+	case PR_fchmod:
+	case PR_fchown:
+	case PR_fchown32:
+	case PR_fremovexattr:
+	case PR_fsetxattr:
+	case PR_ftruncate:
+	case PR_ftruncate64:
+		/* Files opened for reading only can be modified
+		 * through these syscalls too.  */
+		status = check_fd_policy(tracee, peek_reg(tracee, CURRENT, SYSARG_1));
 		break;
 
 	case PR_fchmodat:
@@ -510,11 +675,17 @@ int translate_syscall_enter(Tracee *tracee)
 		if (status < 0)
 			break;
 
-		if (   ((flags & O_NOFOLLOW) != 0)
-			|| ((flags & O_EXCL) != 0 && (flags & O_CREAT) != 0))
-			status = translate_path2(tracee, dirfd, path, SYSARG_2, SYMLINK);
-		else
-			status = translate_path2(tracee, dirfd, path, SYSARG_2, REGULAR);
+		status = translate_open_path(tracee, dirfd, path, SYSARG_2, flags);
+		break;
+
+	case PR_openat2:
+		dirfd = peek_reg(tracee, CURRENT, SYSARG_1);
+
+		status = get_sysarg_path(tracee, path, SYSARG_2);
+		if (status < 0)
+			break;
+
+		status = translate_openat2(tracee, dirfd, path);
 		break;
 
 	case PR_readlinkat:
@@ -530,12 +701,23 @@ int translate_syscall_enter(Tracee *tracee)
 		break;
 
 	case PR_link:
+		status = translate_sysarg(tracee, SYSARG_1, SYMLINK);
+		if (status < 0)
+			break;
+
+		status = translate_sysarg(tracee, SYSARG_2, SYMLINK);
+		break;
+
 	case PR_rename:
 		status = translate_sysarg(tracee, SYSARG_1, SYMLINK);
 		if (status < 0)
 			break;
 
 		status = translate_sysarg(tracee, SYSARG_2, SYMLINK);
+		if (status < 0)
+			break;
+
+		skip_rename_sysexit(tracee, SYSARG_1);
 		break;
 
 	case PR_renameat:
@@ -556,6 +738,10 @@ int translate_syscall_enter(Tracee *tracee)
 			break;
 
 		status = translate_path2(tracee, newdirfd, newpath, SYSARG_4, SYMLINK);
+		if (status < 0)
+			break;
+
+		skip_rename_sysexit(tracee, SYSARG_2);
 		break;
 
 	case PR_symlink:
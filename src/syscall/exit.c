@@ -37,6 +37,7 @@
 #include "tracee/mem.h"
 #include "tracee/abi.h"
 #include "path/path.h"
+#include "path/cwd.h"
 #include "ptrace/ptrace.h"
 #include "ptrace/wait.h"
 #include "extension/extension.h"
@@ -236,12 +237,8 @@ void translate_syscall_exit(Tracee *tracee)
 	case PR_renameat2: {
 		char old_path[PATH_MAX];
 		char new_path[PATH_MAX];
-		ssize_t old_length;
-		ssize_t new_length;
-		Comparison comparison;
 		Reg old_reg;
 		Reg new_reg;
-		char *tmp;
 
 		/* Error reported by the kernel.  */
 		if ((int) syscall_result < 0)
@@ -265,12 +262,11 @@ void translate_syscall_exit(Tracee *tracee)
 		status = detranslate_path(tracee, old_path, NULL);
 		if (status < 0)
 			break;
-		old_length = (status > 0 ? status - 1 : (ssize_t) strlen(old_path));
+		chop_finality(old_path);
 
 		/* Nothing special to do if the moved path is not the
-		 * current working directory.  */
-		comparison = compare_paths(old_path, tracee->fs->cwd);
-		if (comparison != PATH1_IS_PREFIX && comparison != PATHS_ARE_EQUAL) {
+		 * current working directory of any process.  */
+		if (!has_cwd_under(old_path)) {
 			status = 0;
 			break;
 		}
@@ -284,28 +280,10 @@ void translate_syscall_exit(Tracee *tracee)
 		status = detranslate_path(tracee, new_path, NULL);
 		if (status < 0)
 			break;
-		new_length = (status > 0 ? status - 1 : (ssize_t) strlen(new_path));
+		chop_finality(new_path);
 
-		/* Sanity check.  */
-		if (strlen(tracee->fs->cwd) >= PATH_MAX) {
-			status = 0;
-			break;
-		}
-		strcpy(old_path, tracee->fs->cwd);
-
-		/* Update the virtual current working directory.  */
-		substitute_path_prefix(old_path, old_length, new_path, new_length);
-
-		tmp = talloc_strdup(tracee->fs, old_path);
-		if (tmp == NULL) {
-			status = -ENOMEM;
-			break;
-		}
-
-		TALLOC_FREE(tracee->fs->cwd);
-		tracee->fs->cwd = tmp;
-
-		status = 0;
+		/* Update the virtual current working directories.  */
+		status = rename_cwds(tracee, old_path, new_path);
 		break;
 	}
 
@@ -428,6 +406,7 @@ void translate_syscall_exit(Tracee *tracee)
 #endif
 
 	case PR_execve:
+	case PR_execveat:
 		translate_execve_exit(tracee);
 		goto end;
 
@@ -0,0 +1,113 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <stdio.h>     /* fprintf(3), */
+#include <string.h>    /* strcmp(3), */
+#include <errno.h>     /* E*, */
+#include <inttypes.h>  /* PRI*, */
+
+#include "syscall/io_uring.h"
+#include "tracee/tracee.h"
+#include "cli/note.h"
+
+/* The operations submitted through an io_uring are performed by
+ * kernel workers, out of the reach of ptrace.  As a consequence
+ * their paths can't be translated, hence they would bypass the
+ * bindings.  By default, io_uring_setup(2) fails with ENOSYS so that
+ * programs fall back to regular syscalls.  */
+IoUringPolicy io_uring_policy = IO_URING_DENY;
+
+static const char *policy_names[] = {
+	[IO_URING_DENY]  = "deny",
+	[IO_URING_ALLOW] = "allow",
+};
+
+#define NB_POLICIES (sizeof(policy_names) / sizeof(policy_names[0]))
+
+static struct {
+	unsigned long nb_denied;
+	unsigned long nb_allowed;
+} stats;
+
+/**
+ * Set the io_uring policy of this session from its @name.  This
+ * function returns -1 if @name is unknown, otherwise 0.
+ */
+int set_io_uring_policy(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < NB_POLICIES; i++) {
+		if (strcmp(name, policy_names[i]) == 0) {
+			io_uring_policy = i;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Apply the io_uring policy to the current io_uring_setup(2) of
+ * @tracee.  This function returns -ENOSYS if this syscall is denied,
+ * otherwise 0.
+ */
+int translate_io_uring_setup(const Tracee *tracee)
+{
+	switch (io_uring_policy) {
+	case IO_URING_ALLOW:
+		stats.nb_allowed++;
+		return 0;
+
+	case IO_URING_DENY:
+	default:
+		stats.nb_denied++;
+		VERBOSE(tracee, 1, "vpid %" PRIu64 ": io_uring_setup() denied, see --io-uring",
+			tracee->vpid);
+		return -ENOSYS;
+	}
+}
+
+/**
+ * Print the io_uring policy and statistics of this session to @file.
+ */
+void print_io_uring_stats(FILE *file)
+{
+	fprintf(file, "io_uring: policy %s, %lu setup denied, %lu setup allowed\n",
+		policy_names[io_uring_policy], stats.nb_denied, stats.nb_allowed);
+}
+
+/**
+ * Report the io_uring statistics of this session, if they are
+ * meaningful and if the verbose level is positive.
+ */
+void report_io_uring_stats(void)
+{
+	if (global_verbose_level <= 0)
+		return;
+
+	if (stats.nb_denied == 0 && stats.nb_allowed == 0)
+		return;
+
+	note(NULL, INFO, USER, "io_uring: policy %s, %lu setup denied, %lu setup allowed",
+		policy_names[io_uring_policy], stats.nb_denied, stats.nb_allowed);
+}
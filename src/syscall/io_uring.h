@@ -0,0 +1,41 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include <stdio.h>
+#include "tracee/tracee.h"
+
+typedef enum {
+	IO_URING_DENY = 0,
+	IO_URING_ALLOW,
+} IoUringPolicy;
+
+extern IoUringPolicy io_uring_policy;
+
+extern int set_io_uring_policy(const char *name);
+extern int translate_io_uring_setup(const Tracee *tracee);
+extern void print_io_uring_stats(FILE *file);
+extern void report_io_uring_stats(void);
+
+#endif /* IO_URING_H */
@@ -43,7 +43,9 @@
 #include "tracee/tracee.h"
 #include "syscall/syscall.h"
 #include "syscall/sysnum.h"
+#include "syscall/unknown.h"
 #include "extension/extension.h"
+#include "path/policy.h"
 #include "cli/note.h"
 
 #include "compat.h"
@@ -121,13 +123,46 @@ static int add_trace_syscall(struct sock_fprog *program, word_t syscall, int fla
 	return 0;
 }
 
+/**
+ * Append to @program->filter the statements required to return the
+ * given seccomp @action for any syscall in @range.  This function
+ * returns -errno if an error occurred, otherwise 0.
+ */
+static int add_unknown_range(struct sock_fprog *program, const SysnumRange *range, uint32_t action)
+{
+	int status;
+
+	#define LENGTH_UNKNOWN_RANGE 3
+	struct sock_filter statements[LENGTH_UNKNOWN_RANGE] = {
+		/* Compare the accumulator with the first syscall of
+		 * this range: skip the next two statements if lower.  */
+		BPF_JUMP(BPF_JMP + BPF_JGE + BPF_K, range->first, 0, 2),
+
+		/* Compare the accumulator with the last syscall of
+		 * this range: skip the next statement if greater.  */
+		BPF_JUMP(BPF_JMP + BPF_JGT + BPF_K, range->last, 1, 0),
+
+		/* Deny or notify the tracer.  */
+		BPF_STMT(BPF_RET + BPF_K, action)
+	};
+
+	DEBUG_FILTER("FILTER:     0x%x if %u <= syscall <= %u\n", action, range->first, range->last);
+
+	status = add_statements(program, LENGTH_UNKNOWN_RANGE, statements);
+	if (status < 0)
+		return status;
+
+	return 0;
+}
+
 /**
  * Append to @program->filter the statements that allow anything (if
- * unfiltered).  Note that @nb_traced_syscalls is used to make a
- * sanity check.  This function returns -errno if an error occurred,
- * otherwise 0.
+ * unfiltered).  Note that @nb_traced_syscalls and @nb_unknown_ranges
+ * are used to make a sanity check.  This function returns -errno if
+ * an error occurred, otherwise 0.
  */
-static int end_arch_section(struct sock_fprog *program, size_t nb_traced_syscalls)
+static int end_arch_section(struct sock_fprog *program, size_t nb_traced_syscalls,
+			size_t nb_unknown_ranges)
 {
 	int status;
 
@@ -144,7 +179,8 @@ static int end_arch_section(struct sock_fprog *program, size_t nb_traced_syscall
 
 	/* Sanity check, see start_arch_section().  */
 	if (   talloc_array_length(program->filter) - program->len
-	    != LENGTH_END_SECTION + nb_traced_syscalls * LENGTH_TRACE_SYSCALL)
+	    != LENGTH_END_SECTION + nb_traced_syscalls * LENGTH_TRACE_SYSCALL
+	       + nb_unknown_ranges * LENGTH_UNKNOWN_RANGE)
 		return -ERANGE;
 
 	return 0;
@@ -152,16 +188,18 @@ static int end_arch_section(struct sock_fprog *program, size_t nb_traced_syscall
 
 /**
  * Append to @program->filter the statements that check the current
- * @architecture.  Note that @nb_traced_syscalls is used to make a
- * sanity check.  This function returns -errno if an error occurred,
- * otherwise 0.
+ * @architecture.  Note that @nb_traced_syscalls and
+ * @nb_unknown_ranges are used to make a sanity check.  This function
+ * returns -errno if an error occurred, otherwise 0.
  */
-static int start_arch_section(struct sock_fprog *program, uint32_t arch, size_t nb_traced_syscalls)
+static int start_arch_section(struct sock_fprog *program, uint32_t arch, size_t nb_traced_syscalls,
+			size_t nb_unknown_ranges)
 {
 	const size_t arch_offset    = offsetof(struct seccomp_data, arch);
 	const size_t syscall_offset = offsetof(struct seccomp_data, nr);
 	const size_t section_length = LENGTH_END_SECTION +
-					nb_traced_syscalls * LENGTH_TRACE_SYSCALL;
+					nb_traced_syscalls * LENGTH_TRACE_SYSCALL +
+					nb_unknown_ranges * LENGTH_UNKNOWN_RANGE;
 	int status;
 
 	/* Sanity checks.  */
@@ -245,6 +283,8 @@ static void free_program_filter(struct sock_fprog *program)
  *     for each handled architectures
  *         for each filtered syscall
  *             trace
+ *         for each unknown syscall (if not allowed)
+ *             deny or trace
  *         allow
  *     kill
  *
@@ -257,6 +297,9 @@ static int set_seccomp_filters(const FilteredSysnum *sysnums)
 
 	struct sock_fprog program = { .len = 0, .filter = NULL };
 	size_t nb_traced_syscalls;
+	size_t nb_unknown_ranges;
+	SysnumRange *unknown_ranges;
+	uint32_t unknown_action;
 	size_t i, j, k;
 	int status;
 
@@ -264,6 +307,10 @@ static int set_seccomp_filters(const FilteredSysnum *sysnums)
 	if (status < 0)
 		goto end;
 
+	unknown_action = (unknown_syscalls_policy == UNKNOWN_SYSCALLS_DENY
+			? SECCOMP_RET_ERRNO | (ENOSYS & SECCOMP_RET_DATA)
+			: SECCOMP_RET_TRACE);
+
 	/* For each handled architectures */
 	for (i = 0; i < nb_archs; i++) {
 		word_t syscall;
@@ -279,8 +326,23 @@ static int set_seccomp_filters(const FilteredSysnum *sysnums)
 			}
 		}
 
+		/* Pre-compute the ranges of syscalls unknown to all the
+		 * ABIs of this architecture.  */
+		unknown_ranges = NULL;
+		nb_unknown_ranges = 0;
+		if (unknown_syscalls_policy != UNKNOWN_SYSCALLS_ALLOW) {
+			unknown_ranges = get_unknown_sysnums(program.filter, seccomp_archs[i].abis,
+							seccomp_archs[i].nb_abis);
+			if (unknown_ranges == NULL) {
+				status = -ENOMEM;
+				goto end;
+			}
+			nb_unknown_ranges = talloc_array_length(unknown_ranges);
+		}
+
 		/* Filter: if handled architecture */
-		status = start_arch_section(&program, seccomp_archs[i].value, nb_traced_syscalls);
+		status = start_arch_section(&program, seccomp_archs[i].value, nb_traced_syscalls,
+					nb_unknown_ranges);
 		if (status < 0)
 			goto end;
 
@@ -298,8 +360,15 @@ static int set_seccomp_filters(const FilteredSysnum *sysnums)
 			}
 		}
 
+		/* Filter: deny or trace unknown syscalls */
+		for (j = 0; j < nb_unknown_ranges; j++) {
+			status = add_unknown_range(&program, &unknown_ranges[j], unknown_action);
+			if (status < 0)
+				goto end;
+		}
+
 		/* Filter: allow untraced syscalls for this architecture */
-		status = end_arch_section(&program, nb_traced_syscalls);
+		status = end_arch_section(&program, nb_traced_syscalls, nb_unknown_ranges);
 		if (status < 0)
 			goto end;
 	}
@@ -343,9 +412,11 @@ static FilteredSysnum proot_sysnums[] = {
 	{ PR_connect,		0 },
 	{ PR_creat,		0 },
 	{ PR_execve,		FILTER_SYSEXIT },
+	{ PR_execveat,		FILTER_SYSEXIT },
 	{ PR_faccessat,		0 },
 	{ PR_fchdir,		FILTER_SYSEXIT },
 	{ PR_fchmodat,		0 },
+	{ PR_fchmodat2,		0 },
 	{ PR_fchownat,		0 },
 	{ PR_fstatat64,		0 },
 	{ PR_futimesat,		0 },
@@ -354,6 +425,7 @@ static FilteredSysnum proot_sysnums[] = {
 	{ PR_getsockname,	FILTER_SYSEXIT },
 	{ PR_getxattr,		0 },
 	{ PR_inotify_add_watch,	0 },
+	{ PR_io_uring_setup,	0 },
 	{ PR_lchown,		0 },
 	{ PR_lchown32,		0 },
 	{ PR_lgetxattr,		0 },
@@ -376,6 +448,7 @@ static FilteredSysnum proot_sysnums[] = {
 	{ PR_oldstat,		0 },
 	{ PR_open,		0 },
 	{ PR_openat,		0 },
+	{ PR_openat2,		0 },
 	{ PR_pivot_root,	0 },
 	{ PR_prctl, 		0 },
 	{ PR_prlimit64,		FILTER_SYSEXIT },
@@ -417,6 +490,20 @@ static FilteredSysnum proot_sysnums[] = {
 	FILTERED_SYSNUM_END,
 };
 
+/* List of sysnums that modify a file through its descriptor, they
+ * are handled by PRoot only when policies are defined.  */
+static FilteredSysnum policy_sysnums[] = {
+	{ PR_fallocate,		0 },
+	{ PR_fchmod,		0 },
+	{ PR_fchown,		0 },
+	{ PR_fchown32,		0 },
+	{ PR_fremovexattr,	0 },
+	{ PR_fsetxattr,		0 },
+	{ PR_ftruncate,		0 },
+	{ PR_ftruncate64,	0 },
+	FILTERED_SYSNUM_END,
+};
+
 /**
  * Add the @new_sysnums to the list of filtered @sysnums, using the
  * given Talloc @context.  This function returns -errno if an error
@@ -484,6 +571,12 @@ int enable_syscall_filtering(const Tracee *tracee)
 	if (status < 0)
 		return status;
 
+	if (policies != NULL) {
+		status = merge_filtered_sysnums(tracee->ctx, &filtered_sysnums, policy_sysnums);
+		if (status < 0)
+			return status;
+	}
+
 	/* Merge the sysnums required by the extensions to the list
 	 * of filtered sysnums.  */
 	if (tracee->extensions != NULL) {
@@ -28,6 +28,13 @@
 #include <sys/socket.h>  /* struct sockaddr_un, AF_UNIX, */
 #include <sys/un.h>      /* struct sockaddr_un, */
 #include <sys/param.h>   /* MIN(), MAX(), */
+#include <sys/types.h>   /* open(2), stat(2), getpid(2), */
+#include <sys/stat.h>    /* open(2), stat(2), */
+#include <fcntl.h>       /* open(2), O_*, */
+#include <unistd.h>      /* close(2), getpid(2), */
+#include <stdio.h>       /* snprintf(3), fopen(3), */
+#include <stdlib.h>      /* strtol(3), */
+#include <talloc.h>      /* talloc*, */
 
 #include "syscall/socket.h"
 #include "tracee/tracee.h"
@@ -83,15 +90,315 @@ static int read_sockaddr_un(Tracee *tracee, struct sockaddr_un *sockaddr, word_t
 	return 1;
 }
 
+/* Prefix of the abstract socket names of this session, c.f.
+ * isolate_abstract_sockets().  */
+static char abstract_tag[32] = "";
+static size_t abstract_tag_length = 0;
+
+/**
+ * Make the abstract namespace of Unix domain sockets private to the
+ * current session, by transparently prefixing abstract socket names
+ * with a tag unique to this instance of PRoot.
+ */
+void isolate_abstract_sockets(void)
+{
+	int status;
+
+	status = snprintf(abstract_tag, sizeof(abstract_tag), "proot-%d/", getpid());
+	assert(status > 0 && (size_t) status < sizeof(abstract_tag));
+	abstract_tag_length = status;
+}
+
+/**
+ * Copy in @sockaddr the struct sockaddr_un stored in the @tracee
+ * memory at the given @address, if it is an abstract one and if
+ * abstract sockets are isolated.  Only @size bytes are read from the
+ * @tracee memory (should be <= @max_size <= sizeof(struct
+ * sockaddr_un)).  This function returns -errno if an error occurred,
+ * 0 if the structure was not found, otherwise 1.
+ */
+static int read_abstract_sockaddr_un(Tracee *tracee, struct sockaddr_un *sockaddr,
+				word_t max_size, word_t address, int size)
+{
+	int status;
+
+	assert(max_size <= sizeof(struct sockaddr_un));
+
+	if (abstract_tag_length == 0)
+		return 0;
+
+	/* Nothing to do if the sockaddr has an unexpected size.  */
+	if (size <= offsetof_path + 1 || (word_t) size > max_size)
+		return 0;
+
+	bzero(sockaddr, sizeof(struct sockaddr_un));
+	status = read_data(tracee, sockaddr, address, size);
+	if (status < 0)
+		return status;
+
+	/* Nothing to do if it's not an abstract Unix domain socket.  */
+	if ((sockaddr->sun_family != AF_UNIX)
+	    || sockaddr->sun_path[0] != '\0')
+		return 0;
+
+	return 1;
+}
+
+/* Directories of sockets whose host path is too long to fit the
+ * sun_path array, c.f. shorten_socket_path().  The kernel keeps
+ * reporting the name a socket was bound to, so the file descriptor
+ * of such a directory is closed -- and its number possibly reused --
+ * only once no socket reports this name anymore, c.f.
+ * reclaim_socket_directories().  */
+typedef struct {
+	char *path;
+	dev_t dev;
+	ino_t ino;
+	int fd;
+
+	/* Whether this entry was used since the last reclaim.  */
+	bool used;
+} SocketDirectory;
+static SocketDirectory *socket_directories = NULL;
+
+/* Number of entries above which the ones no longer in use are
+ * reclaimed before a new one is added.  */
+#define SOCKET_DIRECTORIES_MAX 64
+
+/**
+ * Close the directories of socket_directories that no socket reports
+ * in its name anymore, according to /proc/net/unix.  An entry used
+ * since the last reclaim is kept for one more round since the
+ * syscall it was used for might not have bound its socket yet.  This
+ * function returns the number of reclaimed entries.
+ */
+static size_t reclaim_socket_directories(void)
+{
+	char prefix[64];
+	char line[512];
+	size_t nb_entries;
+	size_t nb_reclaimed;
+	size_t length;
+	bool *reported;
+	FILE *file;
+	size_t i;
+
+	nb_entries = talloc_array_length(socket_directories);
+
+	reported = talloc_zero_array(NULL, bool, nb_entries);
+	if (reported == NULL)
+		return 0;
+
+	/* Nothing is reclaimed if the sockets can't be listed.  */
+	file = fopen("/proc/net/unix", "r");
+	if (file == NULL) {
+		TALLOC_FREE(reported);
+		return 0;
+	}
+
+	length = snprintf(prefix, sizeof(prefix), "/proc/%d/fd/", getpid());
+	while (fgets(line, sizeof(line), file) != NULL) {
+		char *name;
+		char *end;
+		int fd;
+
+		name = strstr(line, prefix);
+		if (name == NULL)
+			continue;
+
+		fd = strtol(name + length, &end, 10);
+		if (end == name + length || *end != '/')
+			continue;
+
+		for (i = 0; i < nb_entries; i++) {
+			if (socket_directories[i].fd == fd)
+				reported[i] = true;
+		}
+	}
+	(void) fclose(file);
+
+	nb_reclaimed = 0;
+	for (i = 0; i < nb_entries; i++) {
+		SocketDirectory *socket_directory = &socket_directories[i];
+
+		if (socket_directory->fd < 0)
+			continue;
+
+		if (socket_directory->used || reported[i]) {
+			socket_directory->used = false;
+			continue;
+		}
+
+		(void) close(socket_directory->fd);
+		TALLOC_FREE(socket_directory->path);
+		socket_directory->fd = -1;
+		nb_reclaimed++;
+	}
+
+	TALLOC_FREE(reported);
+	return nb_reclaimed;
+}
+
+/**
+ * Get the file descriptor -- opened by PRoot -- of the directory
+ * @path.  This function returns -errno if an error occurred,
+ * otherwise this file descriptor.
+ */
+static int get_socket_directory(const char *path)
+{
+	SocketDirectory *socket_directory;
+	SocketDirectory *entries;
+	struct stat statl;
+	size_t nb_entries;
+	size_t i;
+	int status;
+	int fd;
+
+	status = stat(path, &statl);
+	if (status < 0)
+		return -errno;
+
+	nb_entries = talloc_array_length(socket_directories);
+	for (i = 0; i < nb_entries; i++) {
+		/* Entries of directories that were replaced in the
+		 * meantime are left as-is.  */
+		if (   socket_directories[i].fd >= 0
+		    && socket_directories[i].dev == statl.st_dev
+		    && socket_directories[i].ino == statl.st_ino
+		    && strcmp(socket_directories[i].path, path) == 0) {
+			socket_directories[i].used = true;
+			return socket_directories[i].fd;
+		}
+	}
+
+	fd = open(path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+
+	status = fstat(fd, &statl);
+	if (status < 0) {
+		status = -errno;
+		(void) close(fd);
+		return status;
+	}
+
+	if (nb_entries >= SOCKET_DIRECTORIES_MAX)
+		(void) reclaim_socket_directories();
+
+	/* Reuse a reclaimed entry, if any.  */
+	for (i = 0; i < nb_entries; i++) {
+		if (socket_directories[i].fd < 0)
+			break;
+	}
+
+	if (i == nb_entries) {
+		entries = talloc_realloc(NULL, socket_directories, SocketDirectory, nb_entries + 1);
+		if (entries == NULL) {
+			(void) close(fd);
+			return -ENOMEM;
+		}
+		talloc_set_name_const(entries, "$socket_directories");
+		socket_directories = entries;
+		socket_directories[i].fd = -1;
+	}
+
+	socket_directory = &socket_directories[i];
+	socket_directory->path = talloc_strdup(socket_directories, path);
+	if (socket_directory->path == NULL) {
+		(void) close(fd);
+		return -ENOMEM;
+	}
+
+	/* The lookups skip this entry until it is complete.  */
+	socket_directory->dev  = statl.st_dev;
+	socket_directory->ino  = statl.st_ino;
+	socket_directory->used = true;
+	socket_directory->fd   = fd;
+
+	return fd;
+}
+
+/**
+ * Replace @host_path -- too long to fit the sun_path array -- with
+ * the equivalent "/proc/{PRoot's PID}/fd/{N}/{name}", where N is a
+ * file descriptor opened by PRoot onto the parent directory of
+ * @host_path.  That way, neither a new binding nor a temporary file
+ * are required, whatever the number of calls.  This function returns
+ * -errno if an error occurred, 0 if the shortened path doesn't fit
+ * the sun_path array either, otherwise 1.
+ */
+static int shorten_socket_path(char host_path[PATH_MAX])
+{
+	char shorter_path[PATH_MAX];
+	char *name;
+	int status;
+	int fd;
+
+	name = strrchr(host_path, '/');
+	if (name == NULL || name == host_path)
+		return 0;
+
+	*name = '\0';
+	fd = get_socket_directory(host_path);
+	*name = '/';
+	if (fd < 0)
+		return fd;
+
+	status = snprintf(shorter_path, sizeof(shorter_path), "/proc/%d/fd/%d%s",
+			getpid(), fd, name);
+	if (status < 0 || (size_t) status > sizeof_path)
+		return 0;
+
+	strcpy(host_path, shorter_path);
+	return 1;
+}
+
+/**
+ * Reverse the effect of shorten_socket_path() on @path, if needed.
+ */
+static void unshorten_socket_path(char path[PATH_MAX])
+{
+	char prefix[64];
+	char *end;
+	size_t length;
+	size_t i;
+	int fd;
+
+	length = snprintf(prefix, sizeof(prefix), "/proc/%d/fd/", getpid());
+	if (strncmp(path, prefix, length) != 0)
+		return;
+
+	fd = strtol(path + length, &end, 10);
+	if (end == path + length || *end != '/')
+		return;
+
+	for (i = 0; i < talloc_array_length(socket_directories); i++) {
+		char unshorter_path[PATH_MAX];
+		int status;
+
+		if (socket_directories[i].fd < 0 || socket_directories[i].fd != fd)
+			continue;
+
+		status = snprintf(unshorter_path, sizeof(unshorter_path), "%s%s",
+				socket_directories[i].path, end);
+		if (status < 0 || status >= PATH_MAX)
+			return;
+
+		strcpy(path, unshorter_path);
+		return;
+	}
+}
+
 /**
  * Translate the pathname of the struct sockaddr_un currently stored
  * in the @tracee memory at the given @address.  See the documentation
  * of read_sockaddr_un() for the meaning of the @size parameter.
- * Also, the new address of the translated sockaddr_un is put in the
- * @address parameter.  This function returns -errno if an error
- * occurred, otherwise 0.
+ * Also, the new address and size of the translated sockaddr_un are
+ * put in the @address and @size parameters.  This function returns
+ * -errno if an error occurred, 0 if nothing was translated,
+ * otherwise 1.
  */
-int translate_socketcall_enter(Tracee *tracee, word_t *address, int size)
+int translate_socketcall_enter(Tracee *tracee, word_t *address, word_t *size)
 {
 	struct sockaddr_un sockaddr;
 	char user_path[PATH_MAX];
@@ -101,7 +408,24 @@ int translate_socketcall_enter(Tracee *tracee, word_t *address, int size)
 	if (*address == 0)
 		return 0;
 
-	status = read_sockaddr_un(tracee, &sockaddr, sizeof(sockaddr), user_path, *address, size);
+	status = read_abstract_sockaddr_un(tracee, &sockaddr, sizeof(sockaddr), *address, *size);
+	if (status < 0)
+		return status;
+	if (status > 0) {
+		size_t name_length = *size - offsetof_path - 1;
+
+		/* The tagged name has to fit the sun_path array.  */
+		if (1 + abstract_tag_length + name_length > sizeof_path)
+			return -EINVAL;
+
+		memmove(sockaddr.sun_path + 1 + abstract_tag_length, sockaddr.sun_path + 1, name_length);
+		memcpy(sockaddr.sun_path + 1, abstract_tag, abstract_tag_length);
+		*size += abstract_tag_length;
+
+		goto push;
+	}
+
+	status = read_sockaddr_un(tracee, &sockaddr, sizeof(sockaddr), user_path, *address, *size);
 	if (status <= 0)
 		return status;
 
@@ -110,6 +434,12 @@ int translate_socketcall_enter(Tracee *tracee, word_t *address, int size)
 		return status;
 
 	/* Be careful: sun_path doesn't have to be null-terminated.  */
+	if (strlen(host_path) > sizeof_path) {
+		status = shorten_socket_path(host_path);
+		if (status < 0)
+			return status;
+	}
+
 	if (strlen(host_path) > sizeof_path) {
 		const char *shorter_host_dir;
 		const char *shorter_host_path;
@@ -146,7 +476,9 @@ int translate_socketcall_enter(Tracee *tracee, word_t *address, int size)
 		strcpy(host_path, shorter_host_path);
 	}
 	strncpy(sockaddr.sun_path, host_path, sizeof_path);
+	*size = sizeof(sockaddr);
 
+push:
 	/* Push the updated sockaddr to a newly allocated space.  */
 	*address = alloc_mem(tracee, sizeof(sockaddr));
 	if (*address == 0)
@@ -182,10 +514,49 @@ int translate_socketcall_exit(Tracee *tracee, word_t sock_addr, word_t size_addr
 		return -errno;
 
 	max_size = MIN(max_size, sizeof(sockaddr));
+
+	/* The kernel reports the actual size of the sockaddr, even if
+	 * it was truncated to fit the buffer.  */
+	status = read_abstract_sockaddr_un(tracee, &sockaddr, max_size, sock_addr,
+					MIN((word_t) size, max_size));
+	if (status < 0)
+		return status;
+	if (status > 0) {
+		size_t name_length = size - offsetof_path - 1;
+		size_t read_length = MIN((word_t) size, max_size) - offsetof_path - 1;
+		size_t tag_length  = MIN(read_length, abstract_tag_length);
+
+		/* Names that were not tagged -- the autobound ones
+		 * for instance -- are left as-is.  */
+		if (name_length < abstract_tag_length
+		    || memcmp(sockaddr.sun_path + 1, abstract_tag, tag_length) != 0)
+			return 0;
+
+		/* When the name was truncated, its end -- as long as
+		 * the tag -- wasn't returned by the kernel, so it is
+		 * zeroed rather than leaking the tag.  */
+		memmove(sockaddr.sun_path + 1, sockaddr.sun_path + 1 + tag_length,
+			read_length - tag_length);
+		bzero(sockaddr.sun_path + 1 + read_length - tag_length, tag_length);
+		size -= abstract_tag_length;
+
+		status = write_data(tracee, sock_addr, &sockaddr, MIN((word_t) size, max_size));
+		if (status < 0)
+			return status;
+
+		poke_int32(tracee, size_addr, size);
+		if (errno != 0)
+			return -errno;
+
+		return 0;
+	}
+
 	status = read_sockaddr_un(tracee, &sockaddr, max_size, path, sock_addr, size);
 	if (status <= 0)
 		return status;
 
+	unshorten_socket_path(path);
+
 	status = detranslate_path(tracee, path, NULL);
 	if (status < 0)
 		return status;
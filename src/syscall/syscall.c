@@ -31,6 +31,7 @@
 #include "tracee/tracee.h"
 #include "tracee/reg.h"
 #include "tracee/mem.h"
+#include "compat.h"
 
 /**
  * Copy in @path a C string (PATH_MAX bytes max.) from the @tracee's
@@ -68,7 +69,7 @@ int get_sysarg_path(const Tracee *tracee, char path[PATH_MAX], Reg reg)
  * syscall points to this new block.  This function returns -errno if
  * an error occured, otherwise 0.
  */
-static int set_sysarg_data(Tracee *tracee, const void *tracer_ptr, word_t size, Reg reg)
+int set_sysarg_data(Tracee *tracee, const void *tracer_ptr, word_t size, Reg reg)
 {
 	word_t tracee_ptr;
 	int status;
@@ -99,6 +100,24 @@ int set_sysarg_path(Tracee *tracee, const char path[PATH_MAX], Reg reg)
 	return set_sysarg_data(tracee, path, strlen(path) + 1, reg);
 }
 
+/**
+ * Copy in @how the struct open_how of the current openat2(2) of
+ * @tracee, as pointed to by its @version of SYSARG_3.  Only the
+ * fields known by PRoot are copied, the kernel checks the remaining
+ * ones (if any).  This function returns -errno if an error occured,
+ * otherwise 0.
+ */
+int get_sysarg_open_how(const Tracee *tracee, RegVersion version, OpenHow *how)
+{
+	word_t size;
+
+	size = peek_reg(tracee, version, SYSARG_4);
+	if (size < OPEN_HOW_SIZE_VER0)
+		return -EINVAL;
+
+	return read_data(tracee, how, peek_reg(tracee, version, SYSARG_3), sizeof(OpenHow));
+}
+
 void translate_syscall(Tracee *tracee)
 {
 	const bool is_enter_stage = IS_IN_SYSENTER(tracee);
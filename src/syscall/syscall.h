@@ -24,12 +24,22 @@
 #define SYSCALL_H
 
 #include <limits.h>     /* PATH_MAX, */
+#include <stdint.h>     /* uint64_t, */
 
 #include "tracee/tracee.h"
 #include "tracee/reg.h"
 
+/* Argument of openat2(2), c.f. struct open_how.  */
+typedef struct {
+	uint64_t flags;
+	uint64_t mode;
+	uint64_t resolve;
+} OpenHow;
+
 extern int get_sysarg_path(const Tracee *tracee, char path[PATH_MAX], Reg reg);
 extern int set_sysarg_path(Tracee *tracee, const char path[PATH_MAX], Reg reg);
+extern int set_sysarg_data(Tracee *tracee, const void *tracer_ptr, word_t size, Reg reg);
+extern int get_sysarg_open_how(const Tracee *tracee, RegVersion version, OpenHow *how);
 
 extern void translate_syscall(Tracee *tracee);
 extern int  translate_syscall_enter(Tracee *tracee);
@@ -92,7 +92,7 @@ static Sysnum translate_sysnum(Abi abi, word_t sysnum)
 	index = sysnum - sysnums.offset;
 
 	/* Sanity checks.  */
-	if (index > sysnums.length)
+	if (index >= sysnums.length)
 		return PR_void;
 
 	return sysnums.table[index];
@@ -122,6 +122,29 @@ word_t detranslate_sysnum(Abi abi, Sysnum sysnum)
 	return SYSCALL_AVOIDER;
 }
 
+/**
+ * Return whether the architecture value @sysnum is known to the
+ * table of the given @abi.
+ */
+bool is_known_sysnum(Abi abi, word_t sysnum)
+{
+	return translate_sysnum(abi, sysnum) != PR_void;
+}
+
+/**
+ * Update @first and @last with the range of architecture values
+ * covered by the table of the given @abi.
+ */
+void get_sysnums_range(Abi abi, word_t *first, word_t *last)
+{
+	Sysnums sysnums;
+
+	get_sysnums(abi, &sysnums);
+
+	*first = sysnums.offset;
+	*last  = sysnums.offset + sysnums.length - 1;
+}
+
 /**
  * Return the neutral value of the @tracee's current syscall number.
  */
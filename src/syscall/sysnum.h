@@ -40,6 +40,8 @@ typedef enum {
 extern Sysnum get_sysnum(const Tracee *tracee, RegVersion version);
 extern void set_sysnum(Tracee *tracee, Sysnum sysnum);
 extern word_t detranslate_sysnum(Abi abi, Sysnum sysnum);
+extern bool is_known_sysnum(Abi abi, word_t sysnum);
+extern void get_sysnums_range(Abi abi, word_t *first, word_t *last);
 extern const char *stringify_sysnum(Sysnum sysnum);
 
 #endif /* SYSNUM_H */
@@ -351,6 +351,63 @@ static const Sysnum sysnums_i386[] = {
 	[ 351 ] = PR_sched_setattr,
 	[ 352 ] = PR_sched_getattr,
 	[ 353 ] = PR_renameat2,
+	[ 354 ] = PR_seccomp,
+	[ 355 ] = PR_getrandom,
+	[ 356 ] = PR_memfd_create,
+	[ 358 ] = PR_execveat,
+	[ 374 ] = PR_userfaultfd,
+	[ 375 ] = PR_membarrier,
+	[ 376 ] = PR_mlock2,
+	[ 377 ] = PR_copy_file_range,
+	[ 378 ] = PR_preadv2,
+	[ 379 ] = PR_pwritev2,
+	[ 380 ] = PR_pkey_mprotect,
+	[ 381 ] = PR_pkey_alloc,
+	[ 382 ] = PR_pkey_free,
 	[ 383 ] = PR_statx,
+	[ 385 ] = PR_io_pgetevents,
+	[ 386 ] = PR_rseq,
+	[ 403 ] = PR_clock_gettime64,
+	[ 404 ] = PR_clock_settime64,
+	[ 405 ] = PR_clock_adjtime64,
+	[ 406 ] = PR_clock_getres_time64,
+	[ 407 ] = PR_clock_nanosleep_time64,
+	[ 408 ] = PR_timer_gettime64,
+	[ 409 ] = PR_timer_settime64,
+	[ 410 ] = PR_timerfd_gettime64,
+	[ 411 ] = PR_timerfd_settime64,
 	[ 412 ] = PR_utimensat_time64,
+	[ 413 ] = PR_pselect6_time64,
+	[ 414 ] = PR_ppoll_time64,
+	[ 416 ] = PR_io_pgetevents_time64,
+	[ 417 ] = PR_recvmmsg_time64,
+	[ 418 ] = PR_mq_timedsend_time64,
+	[ 419 ] = PR_mq_timedreceive_time64,
+	[ 420 ] = PR_semtimedop_time64,
+	[ 421 ] = PR_rt_sigtimedwait_time64,
+	[ 422 ] = PR_futex_time64,
+	[ 423 ] = PR_sched_rr_get_interval_time64,
+	[ 424 ] = PR_pidfd_send_signal,
+	[ 425 ] = PR_io_uring_setup,
+	[ 434 ] = PR_pidfd_open,
+	[ 435 ] = PR_clone3,
+	[ 436 ] = PR_close_range,
+	[ 437 ] = PR_openat2,
+	[ 438 ] = PR_pidfd_getfd,
+	[ 440 ] = PR_process_madvise,
+	[ 441 ] = PR_epoll_pwait2,
+	[ 443 ] = PR_quotactl_fd,
+	[ 444 ] = PR_landlock_create_ruleset,
+	[ 445 ] = PR_landlock_add_rule,
+	[ 446 ] = PR_landlock_restrict_self,
+	[ 447 ] = PR_memfd_secret,
+	[ 448 ] = PR_process_mrelease,
+	[ 449 ] = PR_futex_waitv,
+	[ 450 ] = PR_set_mempolicy_home_node,
+	[ 451 ] = PR_cachestat,
+	[ 452 ] = PR_fchmodat2,
+	[ 454 ] = PR_futex_wake,
+	[ 455 ] = PR_futex_wait,
+	[ 456 ] = PR_futex_requeue,
+	[ 462 ] = PR_mseal,
 };
@@ -344,4 +344,29 @@ static const Sysnum sysnums_sh4[] = {
 	[ 369 ] = PR_sched_setattr,
 	[ 370 ] = PR_sched_getattr,
 	[ 371 ] = PR_renameat2,
+	[ 373 ] = PR_getrandom,
+	[ 387 ] = PR_execveat,
+	[ 424 ] = PR_pidfd_send_signal,
+	[ 425 ] = PR_io_uring_setup,
+	[ 434 ] = PR_pidfd_open,
+	[ 435 ] = PR_clone3,
+	[ 436 ] = PR_close_range,
+	[ 437 ] = PR_openat2,
+	[ 438 ] = PR_pidfd_getfd,
+	[ 440 ] = PR_process_madvise,
+	[ 441 ] = PR_epoll_pwait2,
+	[ 443 ] = PR_quotactl_fd,
+	[ 444 ] = PR_landlock_create_ruleset,
+	[ 445 ] = PR_landlock_add_rule,
+	[ 446 ] = PR_landlock_restrict_self,
+	[ 447 ] = PR_memfd_secret,
+	[ 448 ] = PR_process_mrelease,
+	[ 449 ] = PR_futex_waitv,
+	[ 450 ] = PR_set_mempolicy_home_node,
+	[ 451 ] = PR_cachestat,
+	[ 452 ] = PR_fchmodat2,
+	[ 454 ] = PR_futex_wake,
+	[ 455 ] = PR_futex_wait,
+	[ 456 ] = PR_futex_requeue,
+	[ 462 ] = PR_mseal,
 };
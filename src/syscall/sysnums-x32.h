@@ -276,8 +276,43 @@ static const Sysnum sysnums_x32[] = {
 	[ 314 ] = PR_sched_setattr,
 	[ 315 ] = PR_sched_getattr,
 	[ 316 ] = PR_renameat2,
+	[ 317 ] = PR_seccomp,
+	[ 318 ] = PR_getrandom,
+	[ 319 ] = PR_memfd_create,
+	[ 323 ] = PR_userfaultfd,
+	[ 324 ] = PR_membarrier,
+	[ 325 ] = PR_mlock2,
+	[ 326 ] = PR_copy_file_range,
+	[ 329 ] = PR_pkey_mprotect,
+	[ 330 ] = PR_pkey_alloc,
+	[ 331 ] = PR_pkey_free,
 	[ 332 ] = PR_statx,
+	[ 333 ] = PR_io_pgetevents,
+	[ 334 ] = PR_rseq,
+	[ 424 ] = PR_pidfd_send_signal,
+	[ 425 ] = PR_io_uring_setup,
+	[ 434 ] = PR_pidfd_open,
+	[ 435 ] = PR_clone3,
+	[ 436 ] = PR_close_range,
+	[ 437 ] = PR_openat2,
+	[ 438 ] = PR_pidfd_getfd,
 	[ 439 ] = PR_faccessat2,
+	[ 440 ] = PR_process_madvise,
+	[ 441 ] = PR_epoll_pwait2,
+	[ 443 ] = PR_quotactl_fd,
+	[ 444 ] = PR_landlock_create_ruleset,
+	[ 445 ] = PR_landlock_add_rule,
+	[ 446 ] = PR_landlock_restrict_self,
+	[ 447 ] = PR_memfd_secret,
+	[ 448 ] = PR_process_mrelease,
+	[ 449 ] = PR_futex_waitv,
+	[ 450 ] = PR_set_mempolicy_home_node,
+	[ 451 ] = PR_cachestat,
+	[ 452 ] = PR_fchmodat2,
+	[ 454 ] = PR_futex_wake,
+	[ 455 ] = PR_futex_wait,
+	[ 456 ] = PR_futex_requeue,
+	[ 462 ] = PR_mseal,
 	[ 512 ] = PR_rt_sigaction,
 	[ 513 ] = PR_rt_sigreturn,
 	[ 514 ] = PR_ioctl,
@@ -309,4 +344,7 @@ static const Sysnum sysnums_x32[] = {
 	[ 540 ] = PR_process_vm_writev,
 	[ 541 ] = PR_setsockopt,
 	[ 542 ] = PR_getsockopt,
+	[ 545 ] = PR_execveat,
+	[ 546 ] = PR_preadv2,
+	[ 547 ] = PR_pwritev2,
 };
@@ -318,6 +318,44 @@ static const Sysnum sysnums_x86_64[] = {
 	[ 314 ] = PR_sched_setattr,
 	[ 315 ] = PR_sched_getattr,
 	[ 316 ] = PR_renameat2,
+	[ 317 ] = PR_seccomp,
+	[ 318 ] = PR_getrandom,
+	[ 319 ] = PR_memfd_create,
+	[ 322 ] = PR_execveat,
+	[ 323 ] = PR_userfaultfd,
+	[ 324 ] = PR_membarrier,
+	[ 325 ] = PR_mlock2,
+	[ 326 ] = PR_copy_file_range,
+	[ 327 ] = PR_preadv2,
+	[ 328 ] = PR_pwritev2,
+	[ 329 ] = PR_pkey_mprotect,
+	[ 330 ] = PR_pkey_alloc,
+	[ 331 ] = PR_pkey_free,
 	[ 332 ] = PR_statx,
+	[ 333 ] = PR_io_pgetevents,
+	[ 334 ] = PR_rseq,
+	[ 424 ] = PR_pidfd_send_signal,
+	[ 425 ] = PR_io_uring_setup,
+	[ 434 ] = PR_pidfd_open,
+	[ 435 ] = PR_clone3,
+	[ 436 ] = PR_close_range,
+	[ 437 ] = PR_openat2,
+	[ 438 ] = PR_pidfd_getfd,
 	[ 439 ] = PR_faccessat2,
+	[ 440 ] = PR_process_madvise,
+	[ 441 ] = PR_epoll_pwait2,
+	[ 443 ] = PR_quotactl_fd,
+	[ 444 ] = PR_landlock_create_ruleset,
+	[ 445 ] = PR_landlock_add_rule,
+	[ 446 ] = PR_landlock_restrict_self,
+	[ 447 ] = PR_memfd_secret,
+	[ 448 ] = PR_process_mrelease,
+	[ 449 ] = PR_futex_waitv,
+	[ 450 ] = PR_set_mempolicy_home_node,
+	[ 451 ] = PR_cachestat,
+	[ 452 ] = PR_fchmodat2,
+	[ 454 ] = PR_futex_wake,
+	[ 455 ] = PR_futex_wait,
+	[ 456 ] = PR_futex_requeue,
+	[ 462 ] = PR_mseal,
 };
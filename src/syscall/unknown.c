@@ -0,0 +1,320 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <stdlib.h>    /* strtoul(3), qsort(3), */
+#include <string.h>    /* str*(3), */
+#include <stdio.h>     /* snprintf(3), */
+#include <errno.h>     /* E*, */
+#include <inttypes.h>  /* PRI*, */
+#include <talloc.h>    /* talloc_*, */
+
+#include "syscall/unknown.h"
+#include "syscall/sysnum.h"
+#include "tracee/tracee.h"
+#include "tracee/reg.h"
+#include "tracee/abi.h"
+#include "cli/note.h"
+#include "arch.h"
+
+/* Syscalls unknown to PRoot's tables are not translated at all, so
+ * they may take paths that escape from the guest rootfs.  By default
+ * they run as-is, as they always did.  */
+UnknownSyscallsPolicy unknown_syscalls_policy = UNKNOWN_SYSCALLS_ALLOW;
+
+static const char *policy_names[] = {
+	[UNKNOWN_SYSCALLS_ALLOW]  = "allow",
+	[UNKNOWN_SYSCALLS_REPORT] = "report",
+	[UNKNOWN_SYSCALLS_DENY]   = "deny",
+};
+
+#define NB_POLICIES (sizeof(policy_names) / sizeof(policy_names[0]))
+
+/* Unknown syscalls that are known to not take any path, as specified
+ * by the user.  */
+static word_t *allowed_sysnums = NULL;
+
+/* Unknown syscalls already reported.  */
+static struct {
+	Abi abi;
+	word_t sysnum;
+} *reported_sysnums = NULL;
+
+/**
+ * Set the policy for unknown syscalls from @value, that is, a policy
+ * name optionally followed by a comma-separated list of syscall
+ * numbers that are allowed anyway.  This function returns -1 if
+ * @value is invalid, otherwise 0.
+ */
+int set_unknown_syscalls_policy(const char *value)
+{
+	const char *cursor;
+	size_t length;
+	size_t i;
+
+	length = strcspn(value, ",");
+	for (i = 0; i < NB_POLICIES; i++) {
+		if (strlen(policy_names[i]) == length
+		    && strncmp(value, policy_names[i], length) == 0)
+			break;
+	}
+	if (i == NB_POLICIES)
+		return -1;
+
+	unknown_syscalls_policy = i;
+
+	for (cursor = value + length; *cursor == ','; ) {
+		unsigned long sysnum;
+		char *end;
+		void *tmp;
+
+		cursor++;
+		errno = 0;
+		sysnum = strtoul(cursor, &end, 0);
+		if (errno != 0 || end == cursor || (*end != ',' && *end != '\0'))
+			return -1;
+		cursor = end;
+
+		length = talloc_array_length(allowed_sysnums);
+		tmp = talloc_realloc(NULL, allowed_sysnums, word_t, length + 1);
+		if (tmp == NULL)
+			return -1;
+		allowed_sysnums = tmp;
+		allowed_sysnums[length] = sysnum;
+	}
+
+	return 0;
+}
+
+/**
+ * Return whether the architecture value @sysnum was explicitly
+ * allowed by the user.
+ */
+static bool is_allowed_sysnum(word_t sysnum)
+{
+	size_t i;
+
+	for (i = 0; i < talloc_array_length(allowed_sysnums); i++) {
+		if (allowed_sysnums[i] == sysnum)
+			return true;
+	}
+
+	return false;
+}
+
+static int compare_sysnums(const void *a, const void *b)
+{
+	uint32_t sysnum_a = *(const uint32_t *)a;
+	uint32_t sysnum_b = *(const uint32_t *)b;
+
+	return (sysnum_a > sysnum_b) - (sysnum_a < sysnum_b);
+}
+
+/**
+ * Return the ranges of syscall numbers that are neither known to the
+ * tables of the given @abis (@nb_abis items) nor allowed explicitly.
+ * These ranges are sorted and allocated in @context.  This function
+ * returns NULL if an error occurred.
+ */
+SysnumRange *get_unknown_sysnums(TALLOC_CTX *context, const Abi *abis, size_t nb_abis)
+{
+	uint32_t *known;
+	SysnumRange *ranges;
+	uint64_t cursor;
+	size_t nb_known;
+	size_t nb_ranges;
+	size_t i;
+
+	/* Known syscalls, allowed syscalls, and the special value
+	 * PRoot uses to avoid a syscall.  */
+	nb_known = talloc_array_length(allowed_sysnums) + 1;
+	for (i = 0; i < nb_abis; i++) {
+		word_t first;
+		word_t last;
+
+		get_sysnums_range(abis[i], &first, &last);
+		nb_known += last - first + 1;
+	}
+
+	known = talloc_array(context, uint32_t, nb_known);
+	if (known == NULL)
+		return NULL;
+
+	nb_known = 0;
+	for (i = 0; i < nb_abis; i++) {
+		word_t sysnum;
+		word_t first;
+		word_t last;
+
+		get_sysnums_range(abis[i], &first, &last);
+		for (sysnum = first; sysnum <= last; sysnum++) {
+			if (is_known_sysnum(abis[i], sysnum))
+				known[nb_known++] = sysnum;
+		}
+	}
+
+	for (i = 0; i < talloc_array_length(allowed_sysnums); i++)
+		known[nb_known++] = allowed_sysnums[i];
+
+	known[nb_known++] = (uint32_t) SYSCALL_AVOIDER;
+
+	qsort(known, nb_known, sizeof(uint32_t), compare_sysnums);
+
+	/* The unknown syscalls are in the gaps.  */
+	ranges = talloc_array(context, SysnumRange, nb_known + 1);
+	if (ranges == NULL)
+		return NULL;
+
+	nb_ranges = 0;
+	cursor = 0;
+	for (i = 0; i < nb_known; i++) {
+		if (known[i] > cursor) {
+			ranges[nb_ranges].first = cursor;
+			ranges[nb_ranges].last  = known[i] - 1;
+			nb_ranges++;
+		}
+		if (known[i] >= cursor)
+			cursor = (uint64_t) known[i] + 1;
+	}
+
+	if (cursor <= UINT32_MAX) {
+		ranges[nb_ranges].first = cursor;
+		ranges[nb_ranges].last  = UINT32_MAX;
+		nb_ranges++;
+	}
+
+	talloc_free(known);
+
+	return talloc_realloc(context, ranges, SysnumRange, nb_ranges);
+}
+
+/**
+ * Apply the policy for unknown syscalls to the current syscall of
+ * @tracee, when it is unknown to PRoot.  This function returns
+ * -ENOSYS if this syscall is denied, otherwise 0.
+ */
+int translate_unknown_syscall(const Tracee *tracee)
+{
+	word_t sysnum = peek_reg(tracee, ORIGINAL, SYSARG_NUM);
+	Abi abi = get_abi(tracee);
+	size_t length;
+	size_t i;
+	void *tmp;
+
+	if (sysnum == SYSCALL_AVOIDER || is_allowed_sysnum(sysnum))
+		return 0;
+
+	switch (unknown_syscalls_policy) {
+	case UNKNOWN_SYSCALLS_DENY:
+		VERBOSE(tracee, 1, "vpid %" PRIu64 ": unknown syscall %" PRIu64 " denied",
+			tracee->vpid, (uint64_t) sysnum);
+		return -ENOSYS;
+
+	case UNKNOWN_SYSCALLS_REPORT:
+		length = talloc_array_length(reported_sysnums);
+		for (i = 0; i < length; i++) {
+			if (reported_sysnums[i].abi == abi && reported_sysnums[i].sysnum == sysnum)
+				return 0;
+		}
+
+		tmp = talloc_realloc(NULL, reported_sysnums, typeof(*reported_sysnums), length + 1);
+		if (tmp != NULL) {
+			reported_sysnums = tmp;
+			reported_sysnums[length].abi = abi;
+			reported_sysnums[length].sysnum = sysnum;
+		}
+
+		note(tracee, WARNING, USER, "syscall %" PRIu64 " (abi %d) is unknown, it runs untranslated",
+			(uint64_t) sysnum, abi);
+		return 0;
+
+	case UNKNOWN_SYSCALLS_ALLOW:
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Report the syscall numbers unknown to PRoot for each ABI, that is,
+ * the ones that run untranslated unless they are denied.  This is
+ * done at verbose level 1 and above, or if they are reported.
+ */
+void print_unknown_sysnums(const Tracee *tracee)
+{
+	static const Abi abis[] = {
+		ABI_DEFAULT,
+#ifdef SYSNUMS_ABI2
+		ABI_2,
+#endif
+#ifdef SYSNUMS_ABI3
+		ABI_3,
+#endif
+	};
+	size_t i;
+
+	if (tracee->verbose <= 0 && unknown_syscalls_policy != UNKNOWN_SYSCALLS_REPORT)
+		return;
+
+	note(tracee, INFO, USER, "unknown syscalls policy = %s", policy_names[unknown_syscalls_policy]);
+
+	for (i = 0; i < sizeof(abis) / sizeof(Abi); i++) {
+		SysnumRange *ranges;
+		char string[1024] = "";
+		word_t first;
+		word_t last;
+		size_t j;
+
+		get_sysnums_range(abis[i], &first, &last);
+
+		ranges = get_unknown_sysnums(NULL, &abis[i], 1);
+		if (ranges == NULL)
+			return;
+
+		/* Numbers are relative to the start of the table.  */
+		for (j = 0; j < talloc_array_length(ranges); j++) {
+			size_t offset = strlen(string);
+			word_t range_first;
+			word_t range_last;
+
+			if (ranges[j].last < first)
+				continue;
+
+			range_first = (ranges[j].first > first ? ranges[j].first - first : 0);
+			range_last  = ranges[j].last - first;
+
+			if (ranges[j].first > last)
+				snprintf(string + offset, sizeof(string) - offset, " %" PRIu64 "+",
+					(uint64_t) range_first);
+			else if (range_first == range_last)
+				snprintf(string + offset, sizeof(string) - offset, " %" PRIu64,
+					(uint64_t) range_first);
+			else
+				snprintf(string + offset, sizeof(string) - offset, " %" PRIu64 "-%" PRIu64,
+					(uint64_t) range_first, (uint64_t) range_last);
+
+			if (ranges[j].first > last)
+				break;
+		}
+
+		note(tracee, INFO, USER, "unknown syscalls (abi %d) =%s", abis[i], string);
+		talloc_free(ranges);
+	}
+}
@@ -0,0 +1,51 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * Copyright (C) 2015 STMicroelectronics
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef UNKNOWN_H
+#define UNKNOWN_H
+
+#include <stdint.h>
+#include <talloc.h>
+
+#include "tracee/tracee.h"
+#include "tracee/abi.h"
+
+typedef enum {
+	UNKNOWN_SYSCALLS_ALLOW = 0,
+	UNKNOWN_SYSCALLS_REPORT,
+	UNKNOWN_SYSCALLS_DENY,
+} UnknownSyscallsPolicy;
+
+/* Range of syscall numbers, as seen by seccomp.  */
+typedef struct {
+	uint32_t first;
+	uint32_t last;
+} SysnumRange;
+
+extern UnknownSyscallsPolicy unknown_syscalls_policy;
+
+extern int set_unknown_syscalls_policy(const char *value);
+extern SysnumRange *get_unknown_sysnums(TALLOC_CTX *context, const Abi *abis, size_t nb_abis);
+extern int translate_unknown_syscall(const Tracee *tracee);
+extern void print_unknown_sysnums(const Tracee *tracee);
+
+#endif /* UNKNOWN_H */
@@ -33,11 +33,16 @@
 #include <stdbool.h>    /* bool, true, false, */
 #include <assert.h>     /* assert(3), */
 #include <stdlib.h>     /* atexit(3), getenv(3), */
+#include <signal.h>     /* sigaction(2), sigwaitinfo(2), kill(2), SIG*, */
+#include <fcntl.h>      /* open(2), O_*, */
 #include <talloc.h>     /* talloc_*, */
 #include <inttypes.h>   /* PRI*, */
 #include <linux/version.h> /* KERNEL_VERSION, */
 
 #include "tracee/event.h"
+#include "tracee/features.h"
+#include "tracee/watchdog.h"
+#include "syscall/io_uring.h"
 #include "cli/note.h"
 #include "path/path.h"
 #include "path/binding.h"
@@ -45,12 +50,20 @@
 #include "syscall/seccomp.h"
 #include "ptrace/wait.h"
 #include "extension/extension.h"
+#include "extension/deps/deps.h"
 #include "execve/elf.h"
 
 #include "attribute.h"
 #include "compat.h"
 
 
+/* Number of seconds the tracees are given to terminate once a
+ * termination signal was forwarded to them, c.f. --grace-period.  */
+int signal_grace_period = 10;
+
+/* PID of the first tracee, or 0 once it has terminated.  */
+static volatile pid_t first_tracee_pid = 0;
+
 /**
  * Start @tracee->exe with the given @argv[].  This function
  * returns -errno if an error occurred, otherwise 0.
@@ -102,6 +115,7 @@ int launch_process(Tracee *tracee, char *const argv[])
 	default: /* parent */
 		/* We know the pid of the first tracee now.  */
 		tracee->pid = pid;
+		first_tracee_pid = pid;
 		return 0;
 	}
 
@@ -124,6 +138,152 @@ static void kill_all_tracees2(int signum, siginfo_t *siginfo UNUSED, void *ucont
 		_exit(EXIT_FAILURE);
 }
 
+/**
+ * Check whether @pid is traced by PRoot.
+ */
+static bool is_tracee(pid_t pid)
+{
+	char buffer[1024];
+	char path[64];
+	ssize_t size;
+	char *field;
+	int fd;
+
+	snprintf(path, sizeof(path), "/proc/%d/status", pid);
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	size = read(fd, buffer, sizeof(buffer) - 1);
+	close(fd);
+	if (size <= 0)
+		return false;
+	buffer[size] = '\0';
+
+	field = strstr(buffer, "\nTracerPid:");
+	if (field == NULL)
+		return false;
+
+	return atoi(field + strlen("\nTracerPid:")) == getpid();
+}
+
+/* Signals blocked during the event loop, they are received
+ * synchronously by receive_signal() instead.  */
+static sigset_t loop_signals;
+
+/* Last termination signal received by PRoot, and its sender, not yet
+ * handled by the event loop, c.f. handle_termination_signal().  */
+static int pending_signal = 0;
+static pid_t pending_sender = 0;
+
+/* Whether the grace period was started by handle_termination_signal(),
+ * then whether it has expired.  */
+static bool grace_period_started = false;
+static bool grace_period_expired = false;
+
+/**
+ * Receive one of the loop_signals sent to PRoot, if any, and record
+ * it for handle_termination_signal().  If @wait is true, this
+ * function blocks until one of them -- SIGCHLD included, that is, a
+ * new event from a tracee -- is received.  Since these signals are
+ * blocked everywhere else, none of them can be lost between the
+ * check of the pending ones and the wait for the next event.
+ */
+static void receive_signal(bool wait)
+{
+	static const struct timespec no_timeout = { 0, 0 };
+	siginfo_t siginfo;
+	int signum;
+
+	signum = (wait
+		? sigwaitinfo(&loop_signals, &siginfo)
+		: sigtimedwait(&loop_signals, &siginfo, &no_timeout));
+
+	switch (signum) {
+	case SIGHUP:
+	case SIGINT:
+	case SIGTERM:
+		/* Signals generated by the kernel -- ^C from the
+		 * terminal for instance -- have already reached the
+		 * tracees.  */
+		if (siginfo.si_code > 0)
+			break;
+
+		pending_signal = signum;
+		pending_sender = siginfo.si_pid;
+		break;
+
+	case SIGALRM:
+		/* Any SIGALRM other than the expiration of the grace
+		 * period is ignored.  */
+		if (grace_period_started)
+			grace_period_expired = true;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**
+ * Forward the pending termination signal to the process group of the
+ * first tracee -- or to this latter only if it shares PRoot's process
+ * group -- then kill all tracees once the grace period has expired,
+ * or as soon as another termination signal is received.
+ */
+static void handle_termination_signal(void)
+{
+	static bool forwarded = false;
+	pid_t first_pid = first_tracee_pid;
+	pid_t sender;
+	pid_t pgid;
+	int signum;
+	int status;
+
+	if (grace_period_expired) {
+		grace_period_expired = false;
+		kill_all_tracees();
+	}
+
+	if (pending_signal == 0)
+		return;
+
+	signum = pending_signal;
+	sender = pending_sender;
+	pending_signal = 0;
+
+	/* Signals sent by a tracee are none of PRoot's business.  */
+	if (is_tracee(sender))
+		return;
+
+	if (forwarded) {
+		kill_all_tracees();
+		return;
+	}
+	forwarded = true;
+
+	status = -1;
+	if (first_pid > 0) {
+		pgid = getpgid(first_pid);
+		if (pgid > 0 && pgid != getpgrp())
+			status = kill(-pgid, signum);
+		else
+			status = kill(first_pid, signum);
+	}
+
+	/* Remaining tracees have to be notified too.  */
+	if (status < 0)
+		signal_all_tracees(signum);
+
+	if (signal_grace_period > 0) {
+		grace_period_started = true;
+		alarm(signal_grace_period);
+	}
+	else
+		kill_all_tracees();
+}
+
 /**
  * Helper for print_talloc_hierarchy().
  */
@@ -207,33 +367,6 @@ static void print_talloc_hierarchy(int signum, siginfo_t *siginfo UNUSED, void *
 
 static int last_exit_status = -1;
 
-/**
- * Check if kernel >= 4.8
- */
-static bool is_kernel_4_8(void)
-{
-	static int version_48 = -1;
-	int major = 0;
-	int minor = 0;
-
-	if (version_48 != -1)
-		return version_48;
-
-	version_48 = false;
-
-	struct utsname utsname;
-
-	if (uname(&utsname) < 0)
-		return false;
-
-	sscanf(utsname.release, "%d.%d", &major, &minor);
-
-	if ((major == 4 && minor >= 8) || major > 4)
-		version_48 = true;
-
-	return version_48;
-}
-
 /**
  * Check if this instance of PRoot can *technically* handle @tracee.
  */
@@ -289,17 +422,32 @@ int event_loop()
 	if (status != 0)
 		note(NULL, WARNING, INTERNAL, "atexit() failed");
 
+	/* Termination signals, the expiration of the grace period,
+	 * and the events from tracees are received synchronously by
+	 * the event loop, c.f. receive_signal().  */
+	(void) sigemptyset(&loop_signals);
+	(void) sigaddset(&loop_signals, SIGHUP);
+	(void) sigaddset(&loop_signals, SIGINT);
+	(void) sigaddset(&loop_signals, SIGTERM);
+	(void) sigaddset(&loop_signals, SIGALRM);
+	(void) sigaddset(&loop_signals, SIGCHLD);
+
+	status = sigprocmask(SIG_BLOCK, &loop_signals, NULL);
+	if (status < 0)
+		note(NULL, WARNING, SYSTEM, "sigprocmask()");
+
 	/* All signals are blocked when the signal handler is called.
 	 * SIGINFO is used to know which process has signaled us and
 	 * RESTART is used to restart waitpid(2) seamlessly.  */
 	bzero(&signal_action, sizeof(signal_action));
-	signal_action.sa_flags = SA_SIGINFO | SA_RESTART;
 	status = sigfillset(&signal_action.sa_mask);
 	if (status < 0)
 		note(NULL, WARNING, SYSTEM, "sigfillset()");
 
 	/* Handle all signals.  */
 	for (signum = 0; signum < SIGRTMAX; signum++) {
+		signal_action.sa_flags = SA_SIGINFO | SA_RESTART;
+
 		switch (signum) {
 		case SIGQUIT:
 		case SIGILL:
@@ -319,6 +467,15 @@ int event_loop()
 			signal_action.sa_sigaction = print_talloc_hierarchy;
 			break;
 
+		case SIGHUP:
+		case SIGINT:
+		case SIGTERM:
+		case SIGALRM:
+			/* Let the tracees terminate gracefully when
+			 * PRoot is asked to terminate, c.f.
+			 * receive_signal().  */
+			continue;
+
 		case SIGCHLD:
 		case SIGCONT:
 		case SIGSTOP:
@@ -341,6 +498,9 @@ int event_loop()
 			note(NULL, WARNING, SYSTEM, "sigaction(%d)", signum);
 	}
 
+	/* This overrides the action for WATCHDOG_SIGNAL.  */
+	(void) start_watchdog();
+
 	while (1) {
 		int tracee_status;
 		Tracee *tracee;
@@ -350,9 +510,26 @@ int event_loop()
 		/* This is the only safe place to free tracees.  */
 		free_terminated_tracees();
 
-		/* Wait for the next tracee's stop. */
-		pid = waitpid(-1, &tracee_status, __WALL);
+		/* Report stuck tracees and dump their state, if asked.  */
+		run_watchdog();
+
+		/* Forward termination signals sent to PRoot, even if
+		 * tracees keep it busy.  */
+		receive_signal(false);
+		handle_termination_signal();
+
+		/* Get the next tracee's stop, or wait for it -- or for
+		 * a signal sent to PRoot -- if there's none yet.  */
+		pid = waitpid(-1, &tracee_status, __WALL | WNOHANG);
+		if (pid == 0) {
+			receive_signal(true);
+			continue;
+		}
 		if (pid < 0) {
+			/* Interrupted by a signal handler.  */
+			if (errno == EINTR)
+				continue;
+
 			if (errno != ECHILD) {
 				note(NULL, ERROR, SYSTEM, "waitpid()");
 				return EXIT_FAILURE;
@@ -360,11 +537,21 @@ int event_loop()
 			break;
 		}
 
+		/* The exit status of PRoot reflects the termination of
+		 * the first tracee by a signal, as shells do.  */
+		if (pid == first_tracee_pid && (WIFEXITED(tracee_status) || WIFSIGNALED(tracee_status))) {
+			first_tracee_pid = 0;
+			if (WIFSIGNALED(tracee_status))
+				last_exit_status = 128 + WTERMSIG(tracee_status);
+		}
+
 		/* Get information about this tracee. */
 		tracee = get_tracee(NULL, pid, true);
 		assert(tracee != NULL);
 
 		tracee->running = false;
+		tracee->stopped_since = get_watchdog_time();
+		tracee->reported_stuck = false;
 
 		VERBOSE(tracee, 6, "vpid %" PRIu64 ": got event %x",
 			tracee->vpid, tracee_status);
@@ -383,6 +570,12 @@ int event_loop()
 		(void) restart_tracee(tracee, signal);
 	}
 
+	report_io_uring_stats();
+
+	status = write_deps();
+	if (status < 0)
+		return EXIT_FAILURE;
+
 	return last_exit_status;
 }
 
@@ -626,7 +819,7 @@ int handle_tracee_event(Tracee *tracee, int tracee_status)
 	long status;
 	int signal;
 
-	if (is_kernel_4_8())
+	if (kernel_profile.release >= KERNEL_VERSION(4,8,0))
 		return handle_tracee_event_kernel_4_8(tracee, tracee_status);
 	/* Don't overwrite restart_how if it is explicitly set
 	 * elsewhere, i.e in the ptrace emulation when single
@@ -32,4 +32,6 @@ extern int event_loop();
 extern int handle_tracee_event(Tracee *tracee, int tracee_status);
 extern bool restart_tracee(Tracee *tracee, int signal);
 
+extern int signal_grace_period;
+
 #endif /* TRACEE_EVENT_H */
@@ -0,0 +1,477 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <sys/utsname.h>   /* uname(2), */
+#include <sys/syscall.h>   /* SYS_*, */
+#include <sys/ptrace.h>    /* ptrace(2), PTRACE_*, */
+#include <sys/wait.h>      /* waitpid(2), */
+#include <sys/stat.h>      /* fstat(2), */
+#include <sys/uio.h>       /* process_vm_readv(2), */
+#include <unistd.h>        /* syscall(2), fork(2), getuid(2), */
+#include <signal.h>        /* kill(2), raise(3), SIG*, */
+#include <fcntl.h>         /* open(2), O_*, */
+#include <stdlib.h>        /* strtoul(3), getenv(3), */
+#include <stdio.h>         /* snprintf(3), sscanf(3), fopen(3), */
+#include <string.h>        /* str*(3), */
+#include <errno.h>         /* errno(3), E*, */
+#include <limits.h>        /* PATH_MAX, */
+#include <stdbool.h>       /* bool, true, false, */
+#include <stdint.h>        /* uint*_t, */
+#include <inttypes.h>      /* PRIx32, SCNx32, */
+#include <linux/version.h> /* KERNEL_VERSION, */
+
+#include "tracee/features.h"
+#include "path/temp.h"
+#include "cli/note.h"
+#include "build.h"         /* HAVE_PROCESS_VM, */
+#include "compat.h"
+
+KernelProfile kernel_profile = { .release = 0, .features = ~0U };
+
+/* Bump this each time the meaning of the cached profile changes.  */
+#define CACHE_FORMAT 2
+
+static const struct {
+	const char *name;
+	Feature feature;
+} feature_names[] = {
+	{ "process_vm",          FEATURE_PROCESS_VM },
+	{ "ptrace_syscall_info", FEATURE_PTRACE_SYSCALL_INFO },
+	{ "seccomp_user_notif",  FEATURE_SECCOMP_USER_NOTIF },
+	{ "openat2",             FEATURE_OPENAT2 },
+	{ "pidfd",               FEATURE_PIDFD },
+	{ "clone3",              FEATURE_CLONE3 },
+	{ "io_uring",            FEATURE_IO_URING },
+	{ "memfd",               FEATURE_MEMFD },
+};
+
+#define NB_FEATURES (sizeof(feature_names) / sizeof(feature_names[0]))
+
+/**
+ * Return the numeric value for the given kernel @release.
+ */
+int parse_kernel_release(const char *release)
+{
+	unsigned long major = 0;
+	unsigned long minor = 0;
+	unsigned long revision = 0;
+	char *cursor = (char *)release;
+
+	major = strtoul(cursor, &cursor, 10);
+
+	if (*cursor == '.') {
+		cursor++;
+		minor = strtoul(cursor, &cursor, 10);
+	}
+
+	if (*cursor == '.') {
+		cursor++;
+		revision = strtoul(cursor, &cursor, 10);
+	}
+
+	return KERNEL_VERSION(major, minor, revision);
+}
+
+/**
+ * Check whether the syscall @sysnum is implemented, assuming the
+ * given arguments are rejected by any implementation.
+ */
+static bool is_implemented(long sysnum, long arg1, long arg2)
+{
+	long status;
+
+	errno = 0;
+	status = syscall(sysnum, arg1, arg2, 0, 0, 0, 0);
+	if (status >= 0) {
+		/* Unexpected success, release the new descriptor.  */
+		(void) close(status);
+		return true;
+	}
+
+	return (errno != ENOSYS && errno != EPERM);
+}
+
+/**
+ * Check whether process_vm_readv(2) works on this system, it might
+ * be missing or denied by a security module.
+ */
+static bool probe_process_vm(void)
+{
+#if defined(HAVE_PROCESS_VM)
+	struct iovec local;
+	struct iovec remote;
+	long source = 1;
+	long destination = 0;
+
+	local.iov_base  = &destination;
+	local.iov_len   = sizeof(destination);
+	remote.iov_base = &source;
+	remote.iov_len  = sizeof(source);
+
+	return (process_vm_readv(getpid(), &local, 1, &remote, 1, 0) == sizeof(source)
+		&& destination == source);
+#else
+	return false;
+#endif
+}
+
+/**
+ * Check whether PTRACE_GET_SYSCALL_INFO is supported, by tracing a
+ * child that stops itself right away.
+ */
+static bool probe_ptrace_syscall_info(void)
+{
+	uint8_t info[128];
+	bool result;
+	int child_status;
+	pid_t pid;
+
+	pid = fork();
+	if (pid < 0)
+		return false;
+
+	if (pid == 0) {
+		if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == 0)
+			(void) raise(SIGSTOP);
+		_exit(EXIT_SUCCESS);
+	}
+
+	if (waitpid(pid, &child_status, 0) < 0)
+		return false;
+
+	result = (WIFSTOPPED(child_status)
+		&& ptrace(PTRACE_GET_SYSCALL_INFO, pid, sizeof(info), info) > 0);
+
+	(void) kill(pid, SIGKILL);
+	(void) waitpid(pid, &child_status, 0);
+
+	return result;
+}
+
+/**
+ * Check whether the seccomp "user notification" action is available.
+ */
+static bool probe_seccomp_user_notif(void)
+{
+#if defined(SYS_seccomp)
+	uint32_t action = SECCOMP_RET_USER_NOTIF;
+
+	return (syscall(SYS_seccomp, SECCOMP_GET_ACTION_AVAIL, 0, &action) == 0);
+#else
+	return false;
+#endif
+}
+
+/**
+ * Check whether pidfd_open(2) is implemented.
+ */
+static bool probe_pidfd(void)
+{
+	long status;
+
+	status = syscall(SYS_pidfd_open, getpid(), 0);
+	if (status < 0)
+		return false;
+
+	(void) close(status);
+	return true;
+}
+
+/**
+ * Probe every feature of the running kernel.
+ */
+static unsigned int probe_features(void)
+{
+	unsigned int features = 0;
+
+	if (probe_process_vm())
+		features |= FEATURE_PROCESS_VM;
+
+	if (probe_ptrace_syscall_info())
+		features |= FEATURE_PTRACE_SYSCALL_INFO;
+
+	if (probe_seccomp_user_notif())
+		features |= FEATURE_SECCOMP_USER_NOTIF;
+
+	/* A NULL/0 argument is invalid for all these syscalls, so
+	 * only ENOSYS (or EPERM from a filter) tells it is missing.  */
+	if (is_implemented(SYS_openat2, AT_FDCWD, 0))
+		features |= FEATURE_OPENAT2;
+
+	if (is_implemented(SYS_clone3, 0, 0))
+		features |= FEATURE_CLONE3;
+
+	if (is_implemented(SYS_io_uring_setup, 0, 0))
+		features |= FEATURE_IO_URING;
+
+#if defined(SYS_memfd_create)
+	if (is_implemented(SYS_memfd_create, 0, 0))
+		features |= FEATURE_MEMFD;
+#endif
+
+	if (probe_pidfd())
+		features |= FEATURE_PIDFD;
+
+	return features;
+}
+
+/**
+ * Hash the @size bytes of @data into *@hash (FNV-1a).
+ */
+static void hash_bytes(uint32_t *hash, const char *data, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		*hash = (*hash ^ (uint8_t) data[i]) * 0x01000193U;
+}
+
+/**
+ * Return a digest of what decides whether the features are usable,
+ * beyond the kernel release: the seccomp filters and the security
+ * module context PRoot runs under.  This way a profile cached outside
+ * a sandbox isn't reused inside it, and vice versa.
+ */
+static uint32_t get_context(void)
+{
+	uint32_t hash = 0x811c9dc5U;
+	char buffer[256];
+	size_t size;
+	FILE *file;
+
+	file = fopen("/proc/self/status", "r");
+	if (file != NULL) {
+		while (fgets(buffer, sizeof(buffer), file) != NULL) {
+			if (   strncmp(buffer, "Seccomp:", strlen("Seccomp:")) == 0
+			    || strncmp(buffer, "Seccomp_filters:", strlen("Seccomp_filters:")) == 0
+			    || strncmp(buffer, "NoNewPrivs:", strlen("NoNewPrivs:")) == 0)
+				hash_bytes(&hash, buffer, strlen(buffer));
+		}
+		fclose(file);
+	}
+
+	/* Label of the AppArmor or SELinux confinement, if any.  */
+	file = fopen("/proc/self/attr/current", "r");
+	if (file != NULL) {
+		size = fread(buffer, 1, sizeof(buffer), file);
+		hash_bytes(&hash, buffer, size);
+		fclose(file);
+	}
+
+	return hash;
+}
+
+/**
+ * Put in @path the location of the cache file, as specified by the
+ * PROOT_FEATURES_CACHE environment variable if any.  This function
+ * returns false if the cache is disabled.
+ */
+static bool get_cache_path(char path[PATH_MAX])
+{
+	const char *location;
+	int status;
+
+	location = getenv("PROOT_FEATURES_CACHE");
+	if (location != NULL) {
+		if (location[0] == '\0')
+			return false;
+		status = snprintf(path, PATH_MAX, "%s", location);
+	}
+	else
+		status = snprintf(path, PATH_MAX, "%s/proot-features-%d",
+				get_temp_directory(), getuid());
+
+	return (status > 0 && status < PATH_MAX);
+}
+
+/**
+ * Load into *@features the profile cached for the kernel @release
+ * and the given @context in @path.  This function returns false if
+ * there's no such profile.
+ */
+static bool load_cache(const char *path, const char *release, uint32_t context,
+		unsigned int *features)
+{
+	char cached_release[65];
+	uint32_t cached_context;
+	struct stat statl;
+	char buffer[128];
+	int format;
+	ssize_t size;
+	int status;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	/* Don't trust a profile written by somebody else.  */
+	status = fstat(fd, &statl);
+	if (status < 0 || !S_ISREG(statl.st_mode) || statl.st_uid != getuid()) {
+		close(fd);
+		return false;
+	}
+
+	size = read(fd, buffer, sizeof(buffer) - 1);
+	close(fd);
+	if (size <= 0)
+		return false;
+	buffer[size] = '\0';
+
+	status = sscanf(buffer, "%d %64s %" SCNx32 " %x", &format, cached_release,
+			&cached_context, features);
+	return (status == 4
+		&& format == CACHE_FORMAT
+		&& strcmp(cached_release, release) == 0
+		&& cached_context == context);
+}
+
+/**
+ * Atomically save the @features of the kernel @release, for the
+ * given @context, in @path.  Failures are not fatal, the kernel will
+ * be probed again next time.
+ */
+static void save_cache(const char *path, const char *release, uint32_t context,
+		unsigned int features)
+{
+	char tmp_path[PATH_MAX];
+	char buffer[128];
+	int length;
+	int status;
+	int fd;
+
+	status = snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, getpid());
+	if (status < 0 || status >= (int) sizeof(tmp_path))
+		return;
+
+	length = snprintf(buffer, sizeof(buffer), "%d %s %08" PRIx32 " %x\n",
+			CACHE_FORMAT, release, context, features);
+	if (length < 0 || length >= (int) sizeof(buffer))
+		return;
+
+	fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+	if (fd < 0)
+		return;
+
+	status = write(fd, buffer, length);
+	close(fd);
+
+	if (status != length || rename(tmp_path, path) < 0)
+		(void) unlink(tmp_path);
+}
+
+/**
+ * Remove from *@features the ones listed in the PROOT_DISABLE_FEATURES
+ * environment variable -- a comma-separated list of names or "all" --
+ * in order to exercise fallbacks.
+ */
+static void disable_features(unsigned int *features)
+{
+	const char *cursor;
+	size_t length;
+	size_t i;
+
+	cursor = getenv("PROOT_DISABLE_FEATURES");
+	if (cursor == NULL)
+		return;
+
+	for (; *cursor != '\0'; cursor += length + (cursor[length] == ',')) {
+		length = strcspn(cursor, ",");
+
+		if (length == 3 && strncmp(cursor, "all", length) == 0) {
+			*features = 0;
+			continue;
+		}
+
+		for (i = 0; i < NB_FEATURES; i++) {
+			if (strlen(feature_names[i].name) == length
+			    && strncmp(cursor, feature_names[i].name, length) == 0)
+				break;
+		}
+
+		if (i < NB_FEATURES)
+			*features &= ~feature_names[i].feature;
+		else if (length > 0)
+			note(NULL, WARNING, USER, "unknown feature '%.*s' in PROOT_DISABLE_FEATURES",
+				(int) length, cursor);
+	}
+}
+
+/**
+ * Fill kernel_profile, either from the cache -- keyed by the kernel
+ * release and the context returned by get_context() -- or by probing
+ * the running kernel.  This way the implementations depending on
+ * optional kernel features are selected once and for all instead of
+ * failing over on each use.
+ */
+void probe_kernel_features(void)
+{
+	char path[PATH_MAX];
+	struct utsname utsname;
+	unsigned int features;
+	uint32_t context = 0;
+	bool use_cache;
+
+	if (uname(&utsname) < 0) {
+		note(NULL, WARNING, SYSTEM, "can't get the kernel release");
+		return;
+	}
+
+	kernel_profile.release = parse_kernel_release(utsname.release);
+
+	use_cache = get_cache_path(path);
+	if (use_cache)
+		context = get_context();
+
+	if (!use_cache || !load_cache(path, utsname.release, context, &features)) {
+		features = probe_features();
+		if (use_cache)
+			save_cache(path, utsname.release, context, features);
+	}
+
+	disable_features(&features);
+	kernel_profile.features = features;
+}
+
+/**
+ * Print the kernel profile if @tracee is verbose enough.
+ */
+void print_kernel_features(const Tracee *tracee)
+{
+	char buffer[256] = "";
+	size_t i;
+
+	if (tracee->verbose <= 0)
+		return;
+
+	for (i = 0; i < NB_FEATURES; i++) {
+		if ((kernel_profile.features & feature_names[i].feature) == 0)
+			continue;
+		if (buffer[0] != '\0')
+			strcat(buffer, " ");
+		strcat(buffer, feature_names[i].name);
+	}
+
+	note(tracee, INFO, USER, "kernel release = %d.%d.%d",
+		(kernel_profile.release >> 16) & 0xFF,
+		(kernel_profile.release >> 8) & 0xFF,
+		kernel_profile.release & 0xFF);
+	note(tracee, INFO, USER, "kernel features = %s", buffer[0] != '\0' ? buffer : "none");
+}
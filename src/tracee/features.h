@@ -0,0 +1,55 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef FEATURES_H
+#define FEATURES_H
+
+#include "tracee/tracee.h"
+
+typedef enum {
+	FEATURE_PROCESS_VM          = 1 << 0,
+	FEATURE_PTRACE_SYSCALL_INFO = 1 << 1,
+	FEATURE_SECCOMP_USER_NOTIF  = 1 << 2,
+	FEATURE_OPENAT2             = 1 << 3,
+	FEATURE_PIDFD               = 1 << 4,
+	FEATURE_CLONE3              = 1 << 5,
+	FEATURE_IO_URING            = 1 << 6,
+	FEATURE_MEMFD               = 1 << 7,
+} Feature;
+
+typedef struct {
+	/* KERNEL_VERSION() of the running kernel, 0 if unknown.  */
+	int release;
+
+	/* Set of Feature supported by the running kernel.  */
+	unsigned int features;
+} KernelProfile;
+
+/* Everything is assumed available until the kernel is probed, this
+ * way callers keep their "try then fall back" behavior.  */
+extern KernelProfile kernel_profile;
+
+#define HAS_FEATURE(name) ((kernel_profile.features & FEATURE_ ## name) != 0)
+
+extern int parse_kernel_release(const char *release);
+extern void probe_kernel_features(void);
+extern void print_kernel_features(const Tracee *tracee);
+
+#endif /* FEATURES_H */
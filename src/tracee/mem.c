@@ -36,6 +36,7 @@
 
 #include "tracee/mem.h"
 #include "tracee/abi.h"
+#include "tracee/features.h"
 #include "syscall/heap.h"
 #include "arch.h"            /* word_t, NO_MISALIGNED_ACCESS */
 #include "build.h"           /* HAVE_PROCESS_VM,  */
@@ -103,9 +104,11 @@ int write_data(const Tracee *tracee, word_t dest_tracee, const void *src_tracer,
 	remote.iov_base = dest;
 	remote.iov_len  = size;
 
-	status = process_vm_writev(tracee->pid, &local, 1, &remote, 1, 0);
-	if ((size_t) status == size)
-		return 0;
+	if (HAS_FEATURE(PROCESS_VM)) {
+		status = process_vm_writev(tracee->pid, &local, 1, &remote, 1, 0);
+		if ((size_t) status == size)
+			return 0;
+	}
 	/* Fallback to ptrace if something went wrong.  */
 
 #endif /* HAVE_PROCESS_VM */
@@ -170,9 +173,11 @@ int writev_data(const Tracee *tracee, word_t dest_tracee, const struct iovec *sr
 	remote.iov_base = (word_t *)dest_tracee;
 	remote.iov_len  = size;
 
-	status = process_vm_writev(tracee->pid, src_tracer, src_tracer_count, &remote, 1, 0);
-	if ((size_t) status == size)
-		return 0;
+	if (HAS_FEATURE(PROCESS_VM)) {
+		status = process_vm_writev(tracee->pid, src_tracer, src_tracer_count, &remote, 1, 0);
+		if ((size_t) status == size)
+			return 0;
+	}
 	/* Fallback to iterative-write if something went wrong.  */
 
 #endif /* HAVE_PROCESS_VM */
@@ -217,9 +222,11 @@ int read_data(const Tracee *tracee, void *dest_tracer, word_t src_tracee, word_t
 	remote.iov_base = src;
 	remote.iov_len  = size;
 
-	status = process_vm_readv(tracee->pid, &local, 1, &remote, 1, 0);
-	if ((size_t) status == size)
-		return 0;
+	if (HAS_FEATURE(PROCESS_VM)) {
+		status = process_vm_readv(tracee->pid, &local, 1, &remote, 1, 0);
+		if ((size_t) status == size)
+			return 0;
+	}
 	/* Fallback to ptrace if something went wrong.  */
 
 #endif /* HAVE_PROCESS_VM */
@@ -308,6 +315,9 @@ int read_string(const Tracee *tracee, char *dest_tracer, word_t src_tracee, word
 	static size_t chunk_size = 0;
 	static uintptr_t chunk_mask;
 
+	if (!HAS_FEATURE(PROCESS_VM))
+		goto fallback;
+
 	/* A chunk shall not cross a page boundary.  */
 	if (chunk_size == 0) {
 		chunk_size = sysconf(_SC_PAGE_SIZE);
@@ -408,10 +418,12 @@ word_t peek_word(const Tracee *tracee, word_t address)
 	remote.iov_base = (void *)address;
 	remote.iov_len  = sizeof_word(tracee);
 
-	errno = 0;
-	status = process_vm_readv(tracee->pid, &local, 1, &remote, 1, 0);
-	if (status > 0)
-		return result;
+	if (HAS_FEATURE(PROCESS_VM)) {
+		errno = 0;
+		status = process_vm_readv(tracee->pid, &local, 1, &remote, 1, 0);
+		if (status > 0)
+			return result;
+	}
 	/* Fallback to ptrace if something went wrong.  */
 #endif
 	errno = 0;
@@ -453,10 +465,12 @@ void poke_word(const Tracee *tracee, word_t address, word_t value)
 	remote.iov_base = (void *)address;
 	remote.iov_len  = sizeof_word(tracee);
 
-	errno = 0;
-	status = process_vm_writev(tracee->pid, &local, 1, &remote, 1, 0);
-	if (status > 0)
-		return;
+	if (HAS_FEATURE(PROCESS_VM)) {
+		errno = 0;
+		status = process_vm_writev(tracee->pid, &local, 1, &remote, 1, 0);
+		if (status > 0)
+			return;
+	}
 	/* Fallback to ptrace if something went wrong.  */
 #endif
 	/* Don't overwrite the 32 MSB when running a 32-bit process on
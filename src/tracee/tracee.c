@@ -35,7 +35,9 @@
 
 #include "tracee/tracee.h"
 #include "tracee/reg.h"
+#include "tracee/mem.h"
 #include "path/binding.h"
+#include "path/cwd.h"
 #include "syscall/sysnum.h"
 #include "tracee/event.h"
 #include "ptrace/ptrace.h"
@@ -378,6 +380,54 @@ void free_terminated_tracees()
 	}
 }
 
+/* Layout of the structure passed to clone3(2), as of Linux 5.7.  */
+typedef struct {
+	uint64_t flags;
+	uint64_t pidfd;
+	uint64_t child_tid;
+	uint64_t parent_tid;
+	uint64_t exit_signal;
+	uint64_t stack;
+	uint64_t stack_size;
+	uint64_t tls;
+	uint64_t set_tid;
+	uint64_t set_tid_size;
+	uint64_t cgroup;
+} CloneArgs;
+
+/**
+ * Get in @clone_flags the flags of the clone3(2) currently performed
+ * by @parent, in the same form as for clone(2).  This function
+ * returns -errno if an error occured, otherwise 0.
+ */
+static int fetch_clone3_flags(const Tracee *parent, word_t *clone_flags)
+{
+	CloneArgs args;
+	word_t size;
+	int status;
+
+	/* Fields added by newer kernels are meaningless for PRoot.  */
+	size = peek_reg(parent, CURRENT, SYSARG_2);
+	if (size < CLONE_ARGS_SIZE_VER0)
+		return -EINVAL;
+	if (size > sizeof(args))
+		size = sizeof(args);
+
+	bzero(&args, sizeof(args));
+	status = read_data(parent, &args, peek_reg(parent, CURRENT, SYSARG_1), size);
+	if (status < 0)
+		return status;
+
+	/* The exit signal has its own field, whereas it lies in the
+	 * lowest byte of the flags for clone(2).  Note that
+	 * CLONE_INTO_CGROUP, set_tid[] and CLONE_PIDFD -- the pidfd
+	 * is returned in its own field too -- are fully handled by
+	 * the kernel.  */
+	*clone_flags = (word_t) (args.flags & ~(uint64_t) CSIGNAL) | (args.exit_signal & CSIGNAL);
+
+	return 0;
+}
+
 /**
  * Make new @parent's child inherit from it.  Depending on
  * @clone_flags, some information are copied or shared.  This function
@@ -397,12 +447,26 @@ int new_child(Tracee *parent, word_t clone_flags)
 	 *
 	 * -- ptrace(2) man-page
 	 *
-	 * That means we have to check if it's actually a clone(2) in
-	 * order to get the right flags.
+	 * That means we have to check if it's actually a clone(2) --
+	 * or a clone3(2) -- in order to get the right flags.
 	 */
 	status = fetch_regs(parent);
-	if (status >= 0 && get_sysnum(parent, CURRENT) == PR_clone)
-		clone_flags = peek_reg(parent, CURRENT, SYSARG_1);
+	if (status >= 0) {
+		switch (get_sysnum(parent, CURRENT)) {
+		case PR_clone:
+			clone_flags = peek_reg(parent, CURRENT, SYSARG_1);
+			break;
+
+		case PR_clone3:
+			status = fetch_clone3_flags(parent, &clone_flags);
+			if (status < 0)
+				note(parent, WARNING, INTERNAL, "can't fetch clone3 arguments");
+			break;
+
+		default:
+			break;
+		}
+	}
 
 	/* Get the pid of the parent's new child.  */
 	status = ptrace(PTRACE_GETEVENTMSG, parent->pid, NULL, &pid);
@@ -425,6 +489,7 @@ int new_child(Tracee *parent, word_t clone_flags)
 	    && child->fs->bindings.guest == NULL
 	    && child->fs->bindings.host == NULL
 	    && child->qemu == NULL
+	    && child->runners == NULL
 	    && child->glue == NULL
 	    && child->parent == NULL
 	    && child->as_ptracee.ptracer == NULL);
@@ -525,10 +590,9 @@ int new_child(Tracee *parent, word_t clone_flags)
 		if (child->fs == NULL)
 			return -ENOMEM;
 
-		child->fs->cwd = talloc_strdup(child->fs, parent->fs->cwd);
-		if (child->fs->cwd == NULL)
-			return -ENOMEM;
-		talloc_set_name_const(child->fs->cwd, "$cwd");
+		status = set_cwd(child->fs, parent->fs->cwd);
+		if (status < 0)
+			return status;
 
 		/* Bindings are shared across file-system name-spaces since a
 		 * "mount --bind" made by a process affects all other processes
@@ -543,6 +607,7 @@ int new_child(Tracee *parent, word_t clone_flags)
 	child->exe = talloc_reference(child, parent->exe);
 
 	child->qemu = talloc_reference(child, parent->qemu);
+	child->runners = talloc_reference(child, parent->runners);
 	child->glue = talloc_reference(child, parent->glue);
 
 	child->host_ldso_paths  = talloc_reference(child, parent->host_ldso_paths);
@@ -597,6 +662,7 @@ static void reparent_config(Tracee *new_parent, Tracee *old_parent)
 	REPARENT(fs);
 	REPARENT(exe);
 	REPARENT(qemu);
+	REPARENT(runners);
 	REPARENT(glue);
 	REPARENT(extensions);
 
@@ -621,11 +687,26 @@ int swap_config(Tracee *tracee1, Tracee *tracee2)
 	return 0;
 }
 
+/* Send the signal @signum to all tracees.  */
+void signal_all_tracees(int signum)
+{
+	Tracee *tracee;
+
+	LIST_FOREACH(tracee, &tracees, link)
+		kill(tracee->pid, signum);
+}
+
 /* Send the KILL signal to all tracees.  */
 void kill_all_tracees()
+{
+	signal_all_tracees(SIGKILL);
+}
+
+/* Call @callback on each tracee, with the given @data.  */
+void foreach_tracee(void (*callback)(Tracee *tracee, void *data), void *data)
 {
 	Tracee *tracee;
 
 	LIST_FOREACH(tracee, &tracees, link)
-		kill(tracee->pid, SIGKILL);
+		callback(tracee, data);
 }
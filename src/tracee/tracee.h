@@ -31,6 +31,7 @@
 #include <talloc.h>    /* talloc_*, */
 #include <stdint.h>    /* *int*_t, */
 #include <sys/wait.h>  /* __WAIT_* */
+#include <time.h>      /* time_t, */
 #include "arch.h" /* word_t, user_regs_struct, */
 #include "compat.h"
 
@@ -48,6 +49,7 @@ typedef enum {
 } RegVersion;
 
 struct bindings;
+struct binding;
 struct load_info;
 struct extensions;
 struct chained_syscalls;
@@ -94,6 +96,11 @@ typedef struct tracee {
 	/* Is it currently running or not?  */
 	bool running;
 
+	/* Since when it is stopped, and whether it was reported as
+	 * stuck since then, c.f. the watchdog.  */
+	time_t stopped_since;
+	bool reported_stuck;
+
 	/* Is this tracee ready to be freed?  TODO: move to a list
 	 * dedicated to terminated tracees instead.  */
 	bool terminated;
@@ -183,6 +190,19 @@ typedef struct tracee {
 	 * defined in bind_path() then used in build_glue().  */
 	mode_t glue_type;
 
+	/* Constraints on the path resolution, as specified by the
+	 * RESOLVE_* flags of openat2(2).  These variables are first
+	 * defined in translate_path() then used in canonicalize():
+	 * @base is the guest path of the directory the resolution
+	 * starts from, @binding and @dev are the binding and the
+	 * device it belongs to.  */
+	struct {
+		uint64_t flags;
+		const char *base;
+		const struct binding *binding;
+		dev_t dev;
+	} resolve;
+
 	/* During a sub-reconfiguration, the new setup is relatively
 	 * to @tracee's file-system name-space.  Also, @paths holds
 	 * its $PATH environment variable in order to emulate the
@@ -204,6 +224,10 @@ typedef struct tracee {
 	 * execve sysexit.  */
 	struct load_info *load_info;
 
+	/* Emulated files in "/proc/<PID>/" generated for this tracee,
+	 * they are valid until its next call to execve().  */
+	struct proc_cache *proc_cache;
+
 
 	/**********************************************************************
 	 * Private but inherited resources                                    *
@@ -246,6 +270,9 @@ typedef struct tracee {
 	/* Runner command-line.  */
 	char **qemu;
 
+	/* Runner command-lines selected by ELF machine, c.f. --runner.  */
+	struct runner *runners;
+
 	/* Path to glue between the guest rootfs and the host rootfs.  */
 	const char *glue;
 
@@ -284,6 +311,8 @@ extern Tracee *new_dummy_tracee(TALLOC_CTX *context);
 extern void terminate_tracee(Tracee *tracee);
 extern void free_terminated_tracees();
 extern int swap_config(Tracee *tracee1, Tracee *tracee2);
+extern void signal_all_tracees(int signum);
 extern void kill_all_tracees();
+extern void foreach_tracee(void (*callback)(Tracee *tracee, void *data), void *data);
 
 #endif /* TRACEE_H */
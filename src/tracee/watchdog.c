@@ -0,0 +1,326 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#include <stdio.h>      /* fprintf(3), fopen(3), */
+#include <stdlib.h>     /* getenv(3), */
+#include <string.h>     /* strerror(3), */
+#include <strings.h>    /* bzero(3), */
+#include <signal.h>     /* sigaction(2), SIG*, */
+#include <time.h>       /* timer_*(2), clock_gettime(2), */
+#include <errno.h>      /* E*, */
+#include <inttypes.h>   /* PRI*, */
+#include <sys/ptrace.h> /* PTRACE_*, */
+
+#include "tracee/watchdog.h"
+#include "tracee/tracee.h"
+#include "tracee/event.h"
+#include "tracee/reg.h"
+#include "syscall/sysnum.h"
+#include "syscall/io_uring.h"
+#include "cli/note.h"
+
+#include "attribute.h"
+
+/* Stopped tracees are reported after this number of seconds, 0 to
+ * disable the watchdog.  */
+int watchdog_timeout = 0;
+
+/* Whether stuck tracees are restarted once reported.  */
+bool watchdog_restart = false;
+
+/* Set asynchronously by handle_watchdog_signal().  */
+static volatile sig_atomic_t pending_check = 0;
+static volatile sig_atomic_t pending_dump = 0;
+
+/**
+ * Return the current time, in seconds, for the watchdog purpose.
+ */
+time_t get_watchdog_time(void)
+{
+	struct timespec now;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &now) < 0)
+		return 0;
+
+	return now.tv_sec;
+}
+
+/**
+ * Print the state of @tracee in @file.
+ */
+static void dump_tracee(FILE *file, const Tracee *tracee, time_t now)
+{
+	if (tracee->running)
+		fprintf(file, "vpid %" PRIu64 ": pid %d, running", tracee->vpid, tracee->pid);
+	else
+		fprintf(file, "vpid %" PRIu64 ": pid %d, stopped for %lds",
+			tracee->vpid, tracee->pid, (long) (now - tracee->stopped_since));
+
+	fprintf(file, ", status %d, restart_how %d, seccomp %d, sysexit_pending %d, sigstop %d%s\n",
+		tracee->status, tracee->restart_how, tracee->seccomp,
+		tracee->sysexit_pending, tracee->sigstop,
+		tracee->terminated ? ", terminated" : "");
+
+	fprintf(file, "    as_ptracer: nb_ptracees %zu, wait_pid %d, wait_options 0x%lx, waits_in %d\n",
+		tracee->as_ptracer.nb_ptracees, tracee->as_ptracer.wait_pid,
+		(unsigned long) tracee->as_ptracer.wait_options, tracee->as_ptracer.waits_in);
+
+	fprintf(file, "    as_ptracee: ptracer %d, event4.proot 0x%x%s, event4.ptracer 0x%x%s, "
+		"tracing_started %d, options 0x%lx, is_zombie %d\n",
+		tracee->as_ptracee.ptracer != NULL ? tracee->as_ptracee.ptracer->pid : 0,
+		tracee->as_ptracee.event4.proot.value,
+		tracee->as_ptracee.event4.proot.pending ? " (pending)" : "",
+		tracee->as_ptracee.event4.ptracer.value,
+		tracee->as_ptracee.event4.ptracer.pending ? " (pending)" : "",
+		tracee->as_ptracee.tracing_started, (unsigned long) tracee->as_ptracee.options,
+		tracee->as_ptracee.is_zombie);
+
+	fprintf(file, "    chain: syscalls %s, force_final_result %d, final_result 0x%lx\n",
+		tracee->chain.syscalls != NULL ? "pending" : "none",
+		tracee->chain.force_final_result, (unsigned long) tracee->chain.final_result);
+
+	/* The register cache holds the state of the last stop.  */
+	fprintf(file, "    last syscall: %s(0x%lx, 0x%lx, 0x%lx, 0x%lx, 0x%lx, 0x%lx) = 0x%lx "
+		"[pc 0x%lx, sp 0x%lx]\n",
+		stringify_sysnum(get_sysnum(tracee, ORIGINAL)),
+		peek_reg(tracee, ORIGINAL, SYSARG_1), peek_reg(tracee, ORIGINAL, SYSARG_2),
+		peek_reg(tracee, ORIGINAL, SYSARG_3), peek_reg(tracee, ORIGINAL, SYSARG_4),
+		peek_reg(tracee, ORIGINAL, SYSARG_5), peek_reg(tracee, ORIGINAL, SYSARG_6),
+		peek_reg(tracee, CURRENT, SYSARG_RESULT),
+		peek_reg(tracee, CURRENT, INSTR_POINTER),
+		peek_reg(tracee, CURRENT, STACK_POINTER));
+}
+
+/**
+ * Check whether @tracee has been stopped by PRoot for too long,
+ * unless it is legitimately held for a ptracer or waiting for one of
+ * its ptracees.
+ */
+static bool is_stuck(const Tracee *tracee, time_t now)
+{
+	const Tracee *ptracer = tracee->as_ptracee.ptracer;
+
+	if (tracee->running || tracee->terminated)
+		return false;
+
+	if (now - tracee->stopped_since < watchdog_timeout)
+		return false;
+
+	if (ptracer != NULL && !ptracer->terminated)
+		return false;
+
+	if (tracee->as_ptracer.wait_pid != 0 && tracee->as_ptracer.nb_ptracees > 0)
+		return false;
+
+	return true;
+}
+
+/**
+ * Try to restart the stuck @tracee in a way that can't corrupt its
+ * state.  This function returns whether it was restarted.
+ */
+static bool restart_stuck_tracee(Tracee *tracee)
+{
+	/* Don't release a child before its parent is known, nor a
+	 * ptracee behind the back of its ptracer.  */
+	if (tracee->sigstop == SIGSTOP_PENDING || tracee->as_ptracee.ptracer != NULL)
+		return false;
+
+	/* A ptracer waiting for ptracees that are all gone: complete
+	 * its wait(2) as the kernel would do.  */
+	if (tracee->as_ptracer.wait_pid != 0) {
+		poke_reg(tracee, SYSARG_RESULT, (word_t) -ECHILD);
+		(void) push_regs(tracee);
+		tracee->as_ptracer.wait_pid = 0;
+	}
+
+	if (tracee->restart_how == 0)
+		tracee->restart_how = PTRACE_SYSCALL;
+
+	return restart_tracee(tracee, 0);
+}
+
+/**
+ * Open the file specified by the PROOT_STATE_DUMP environment
+ * variable, or use stderr.
+ */
+static FILE *open_dump_file(void)
+{
+	const char *path;
+	FILE *file;
+
+	path = getenv("PROOT_STATE_DUMP");
+	if (path == NULL)
+		return stderr;
+
+	file = fopen(path, "a");
+	if (file == NULL) {
+		note(NULL, WARNING, SYSTEM, "can't open '%s'", path);
+		return stderr;
+	}
+
+	return file;
+}
+
+static void close_dump_file(FILE *file)
+{
+	if (file != stderr)
+		fclose(file);
+	else
+		fflush(file);
+}
+
+typedef struct {
+	FILE *file;
+	time_t now;
+	bool only_stuck;
+	size_t nb_stuck;
+} Dump;
+
+/**
+ * Dump @tracee as specified by @data, c.f. foreach_tracee().
+ */
+static void dump_tracee2(Tracee *tracee, void *data)
+{
+	Dump *dump = data;
+
+	if (dump->only_stuck) {
+		if (tracee->reported_stuck || !is_stuck(tracee, dump->now))
+			return;
+
+		if (dump->nb_stuck++ == 0) {
+			dump->file = open_dump_file();
+			fprintf(dump->file, "proot watchdog: tracees stopped for more than %ds\n",
+				watchdog_timeout);
+		}
+
+		tracee->reported_stuck = true;
+	}
+
+	dump_tracee(dump->file, tracee, dump->now);
+
+	if (dump->only_stuck && watchdog_restart)
+		fprintf(dump->file, "    %s\n", restart_stuck_tracee(tracee)
+			? "restarted" : "can't be restarted safely");
+}
+
+/**
+ * Handle the watchdog checks and the dump requests notified since the
+ * last call.  This is done from the event loop, where the state of
+ * the tracees is consistent.
+ */
+void run_watchdog(void)
+{
+	Dump dump;
+
+	if (pending_dump) {
+		pending_dump = 0;
+
+		dump.file = open_dump_file();
+		dump.now = get_watchdog_time();
+		dump.only_stuck = false;
+		dump.nb_stuck = 0;
+
+		fprintf(dump.file, "proot state dump:\n");
+		foreach_tracee(dump_tracee2, &dump);
+		print_io_uring_stats(dump.file);
+		close_dump_file(dump.file);
+	}
+
+	if (pending_check) {
+		pending_check = 0;
+
+		dump.file = NULL;
+		dump.now = get_watchdog_time();
+		dump.only_stuck = true;
+		dump.nb_stuck = 0;
+
+		foreach_tracee(dump_tracee2, &dump);
+		if (dump.file != NULL)
+			close_dump_file(dump.file);
+	}
+}
+
+/**
+ * Defer the handling of a watchdog tick or a dump request to
+ * run_watchdog().
+ */
+static void handle_watchdog_signal(int signum UNUSED, siginfo_t *siginfo, void *ucontext UNUSED)
+{
+	if (siginfo->si_code == SI_TIMER)
+		pending_check = 1;
+	else
+		pending_dump = 1;
+}
+
+/**
+ * Start the periodic checks and make WATCHDOG_SIGNAL dump the state
+ * of all tracees, if the watchdog is enabled; WATCHDOG_SIGNAL is left
+ * ignored otherwise.  This function returns -1 if an error occurred,
+ * otherwise 0.
+ */
+int start_watchdog(void)
+{
+	struct sigaction signal_action;
+	struct itimerspec period;
+	struct sigevent event;
+	timer_t timer;
+	int status;
+
+	if (watchdog_timeout <= 0)
+		return 0;
+
+	/* SA_RESTART is fine: the event loop waits for the next event
+	 * with sigwaitinfo(2), this latter is always interrupted by a
+	 * signal handler so run_watchdog() is called right after.  */
+	bzero(&signal_action, sizeof(signal_action));
+	signal_action.sa_flags = SA_SIGINFO | SA_RESTART;
+	signal_action.sa_sigaction = handle_watchdog_signal;
+	(void) sigfillset(&signal_action.sa_mask);
+
+	status = sigaction(WATCHDOG_SIGNAL, &signal_action, NULL);
+	if (status < 0) {
+		note(NULL, WARNING, SYSTEM, "sigaction(%d)", WATCHDOG_SIGNAL);
+		return -1;
+	}
+
+	bzero(&event, sizeof(event));
+	event.sigev_notify = SIGEV_SIGNAL;
+	event.sigev_signo  = WATCHDOG_SIGNAL;
+
+	status = timer_create(CLOCK_MONOTONIC, &event, &timer);
+	if (status < 0) {
+		note(NULL, WARNING, SYSTEM, "can't start the watchdog");
+		return -1;
+	}
+
+	/* Check twice per timeout, this bounds the report latency.  */
+	bzero(&period, sizeof(period));
+	period.it_interval.tv_sec = (watchdog_timeout + 1) / 2;
+	period.it_value = period.it_interval;
+
+	status = timer_settime(timer, 0, &period, NULL);
+	if (status < 0) {
+		note(NULL, WARNING, SYSTEM, "can't start the watchdog");
+		return -1;
+	}
+
+	return 0;
+}
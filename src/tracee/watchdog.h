@@ -0,0 +1,39 @@
+/* -*- c-set-style: "K&R"; c-basic-offset: 8 -*-
+ *
+ * This file is part of PRoot.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdbool.h>
+#include <signal.h>
+#include <time.h>
+
+/* Signal that triggers a dump of the state of all tracees; SIGUSR1
+ * and SIGUSR2 already print the talloc hierarchy.  */
+#define WATCHDOG_SIGNAL SIGPWR
+
+extern int watchdog_timeout;
+extern bool watchdog_restart;
+
+extern time_t get_watchdog_time(void);
+extern int start_watchdog(void);
+extern void run_watchdog(void);
+
+#endif /* WATCHDOG_H */
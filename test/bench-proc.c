@@ -0,0 +1,65 @@
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/* Entries looked up in each "/proc/<PID>/", like ps(1), top(1) and
+ * pgrep(1) do.  */
+static const char *entries[] = {
+	"exe", "cwd", "root", "stat", "status", "fd/0", "fd/1", "task",
+};
+
+#define NB_ENTRIES (sizeof(entries) / sizeof(entries[0]))
+
+/* Scan "/proc" @nb_iterations times -- 200 by default -- then report
+ * the mean time of a lookup.  */
+int main(int argc, char *argv[])
+{
+	struct timespec start;
+	struct timespec end;
+	unsigned long nb_lookups = 0;
+	int nb_iterations;
+	int i;
+
+	nb_iterations = (argc > 1 ? atoi(argv[1]) : 200);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (i = 0; i < nb_iterations; i++) {
+		struct dirent *dirent;
+		DIR *dir;
+
+		dir = opendir("/proc");
+		if (dir == NULL)
+			exit(EXIT_FAILURE);
+
+		while ((dirent = readdir(dir)) != NULL) {
+			char path[PATH_MAX];
+			struct stat statl;
+			size_t j;
+
+			if (dirent->d_name[0] < '0' || dirent->d_name[0] > '9')
+				continue;
+
+			for (j = 0; j < NB_ENTRIES; j++) {
+				snprintf(path, sizeof(path), "/proc/%s/%s", dirent->d_name, entries[j]);
+				(void) stat(path, &statl);
+				nb_lookups++;
+			}
+		}
+
+		closedir(dir);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	printf("%lu lookups in %.3f s, %.1f us per lookup\n", nb_lookups,
+		(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9,
+		nb_lookups == 0 ? 0 :
+		((end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3) / nb_lookups);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,62 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Boundaries of the initialized data and of the BSS, as defined by
+ * the linker.  */
+extern char edata;
+extern char end;
+
+char data[4096] = { 1 };
+char bss[3 * 4096];
+
+/* Return whether "/proc/self/maps" reports a writable mapping that
+ * contains @address.  */
+static int is_writable(const void *address)
+{
+	unsigned long start;
+	unsigned long stop;
+	char perms[5];
+	char line[1024];
+	int found = 0;
+	FILE *file;
+
+	file = fopen("/proc/self/maps", "r");
+	if (file == NULL)
+		exit(125);
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (sscanf(line, "%lx-%lx %4s", &start, &stop, perms) != 3)
+			continue;
+
+		if ((unsigned long) address >= start && (unsigned long) address < stop) {
+			found = (perms[0] == 'r' && perms[1] == 'w');
+			break;
+		}
+	}
+
+	fclose(file);
+	return found;
+}
+
+int main(void)
+{
+	size_t i;
+
+	if (data[0] != 1)
+		exit(EXIT_FAILURE);
+
+	/* The tail of the last page of the initialized data is either
+	 * cleared by the loader or zero-filled by the kernel.  */
+	for (i = 0; i < sizeof(bss); i++) {
+		if (bss[i] != 0)
+			exit(EXIT_FAILURE);
+	}
+
+	if (!is_writable(&edata - 1) || !is_writable(&edata) || !is_writable(&end - 1))
+		exit(EXIT_FAILURE);
+
+	memset(bss, 1, sizeof(bss));
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,35 @@
+#define _GNU_SOURCE /* CLONE_*, */
+
+#include <stdlib.h>      /* exit(3), atoi(3), */
+#include <unistd.h>      /* syscall(2), sleep(3), */
+#include <signal.h>      /* kill(2), SIG*, */
+#include <sched.h>       /* CLONE_*, */
+#include <sys/syscall.h> /* SYS_clone, */
+#include <sys/types.h>   /* waitpid(2), */
+#include <sys/wait.h>    /* waitpid(2), */
+
+/* The child of a traced process created with CLONE_PTRACE and
+ * CLONE_UNTRACED is traced too but its parent doesn't report any
+ * PTRACE_EVENT_CLONE, so PRoot keeps this child stopped.  The parent
+ * kills it after the number of seconds given as first argument.  */
+int main(int argc, char *argv[])
+{
+	int child_status;
+	pid_t pid;
+
+	pid = syscall(SYS_clone, CLONE_PTRACE | CLONE_UNTRACED | SIGCHLD, 0, 0, 0, 0);
+	switch (pid) {
+	case -1:
+		exit(EXIT_FAILURE);
+
+	case 0: /* Child */
+		_exit(EXIT_SUCCESS);
+
+	default: /* Parent */
+		sleep(argc > 1 ? atoi(argv[1]) : 0);
+		(void) kill(pid, SIGKILL);
+		if (waitpid(pid, &child_status, 0) < 0)
+			exit(EXIT_FAILURE);
+		exit(EXIT_SUCCESS);
+	}
+}
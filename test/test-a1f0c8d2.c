@@ -0,0 +1,280 @@
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <strings.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <time.h>
+#include <dirent.h>
+
+/* More than the number of directories PRoot used to keep open.  */
+#define NB_SOCKETS 20
+
+/* More than the number of directories PRoot keeps open once the
+ * sockets are gone.  */
+#define NB_ITERATIONS 2000
+#define NB_SAMPLES 200
+
+/* The host path of these sockets -- prefixed with the rootfs --
+ * doesn't fit sun_path.  */
+#define DIRNAME "/tmp/proot-a1f0c8d2-%02d-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx" \
+		"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+
+/* Check the name of the socket @fd is @path.  */
+static void check_sockname(int fd, const char *path)
+{
+	struct sockaddr_un sockaddr;
+	socklen_t socklen;
+	int status;
+
+	socklen = sizeof(sockaddr);
+	status = getsockname(fd, (struct sockaddr *) &sockaddr, &socklen);
+	if (status < 0) {
+		perror("getsockname");
+		exit(EXIT_FAILURE);
+	}
+
+	if (socklen != offsetof(struct sockaddr_un, sun_path) + strlen(path) + 1
+	    || strcmp(sockaddr.sun_path, path) != 0) {
+		fprintf(stderr, "unexpected socket name: %.*s, expected %s\n",
+			(int) sizeof(sockaddr.sun_path), sockaddr.sun_path, path);
+		exit(EXIT_FAILURE);
+	}
+}
+
+static double now()
+{
+	struct timespec timespec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timespec);
+	return timespec.tv_sec + timespec.tv_nsec / 1e9;
+}
+
+/* Return the number of files opened by PRoot -- the parent of the
+ * first tracee -- or -1 if they can't be listed.  */
+static int count_proot_fds()
+{
+	char path[64];
+	DIR *dir;
+	int count;
+
+	snprintf(path, sizeof(path), "/proc/%d/fd", getppid());
+	dir = opendir(path);
+	if (dir == NULL)
+		return -1;
+
+	count = 0;
+	while (readdir(dir) != NULL)
+		count++;
+
+	closedir(dir);
+	return count;
+}
+
+/* Bind, connect to, and close a socket with a long path, in a new
+ * directory, then return how long it took.  */
+static double bind_connect(int i)
+{
+	struct sockaddr_un sockaddr;
+	char dirname[sizeof(sockaddr.sun_path)];
+	char path[sizeof(sockaddr.sun_path)];
+	struct stat statl;
+	double start;
+	int server;
+	int client;
+	int peer;
+	int status;
+
+	start = now();
+
+	snprintf(dirname, sizeof(dirname), DIRNAME, i % 100);
+	snprintf(path, sizeof(path), "%s/s", dirname);
+
+	status = mkdir(dirname, 0700);
+	if (status < 0) {
+		perror("mkdir");
+		exit(EXIT_FAILURE);
+	}
+
+	bzero(&sockaddr, sizeof(sockaddr));
+	sockaddr.sun_family = AF_UNIX;
+	strcpy(sockaddr.sun_path, path);
+
+	server = socket(AF_UNIX, SOCK_STREAM, 0);
+	client = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0 || client < 0) {
+		perror("socket");
+		exit(EXIT_FAILURE);
+	}
+
+	status = bind(server, (const struct sockaddr *) &sockaddr, SUN_LEN(&sockaddr));
+	if (status < 0) {
+		perror("bind");
+		exit(EXIT_FAILURE);
+	}
+
+	/* No binding to a temporary path is involved.  */
+	status = stat(path, &statl);
+	if (status < 0 || !S_ISSOCK(statl.st_mode)) {
+		fprintf(stderr, "socket not found: %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	status = listen(server, 1);
+	if (status < 0) {
+		perror("listen");
+		exit(EXIT_FAILURE);
+	}
+
+	status = connect(client, (const struct sockaddr *) &sockaddr, SUN_LEN(&sockaddr));
+	if (status < 0) {
+		perror("connect");
+		exit(EXIT_FAILURE);
+	}
+
+	peer = accept(server, NULL, NULL);
+	if (peer < 0) {
+		perror("accept");
+		exit(EXIT_FAILURE);
+	}
+
+	check_sockname(peer, path);
+
+	close(peer);
+	close(client);
+	close(server);
+	(void) unlink(path);
+	(void) rmdir(dirname);
+
+	return now() - start;
+}
+
+int main()
+{
+	struct sockaddr_un sockaddr;
+	char dirnames[NB_SOCKETS][sizeof(sockaddr.sun_path)];
+	char paths[NB_SOCKETS][sizeof(sockaddr.sun_path)];
+	int servers[NB_SOCKETS];
+	struct stat statl;
+	double first = 0;
+	double last = 0;
+	int nb_fds;
+	int status;
+	int i;
+
+	for (i = 0; i < NB_SOCKETS; i++) {
+		snprintf(dirnames[i], sizeof(dirnames[i]), DIRNAME, i);
+		snprintf(paths[i], sizeof(paths[i]), "%s/s", dirnames[i]);
+
+		(void) unlink(paths[i]);
+		(void) rmdir(dirnames[i]);
+
+		status = mkdir(dirnames[i], 0700);
+		if (status < 0) {
+			perror("mkdir");
+			exit(125);
+		}
+
+		bzero(&sockaddr, sizeof(sockaddr));
+		sockaddr.sun_family = AF_UNIX;
+		strcpy(sockaddr.sun_path, paths[i]);
+
+		servers[i] = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (servers[i] < 0) {
+			perror("socket");
+			exit(EXIT_FAILURE);
+		}
+
+		status = bind(servers[i], (const struct sockaddr *) &sockaddr, SUN_LEN(&sockaddr));
+		if (status < 0) {
+			perror("bind");
+			exit(EXIT_FAILURE);
+		}
+
+		/* The socket shall be created at its actual location.  */
+		status = stat(paths[i], &statl);
+		if (status < 0 || !S_ISSOCK(statl.st_mode)) {
+			fprintf(stderr, "socket not found: %s\n", paths[i]);
+			exit(EXIT_FAILURE);
+		}
+
+		check_sockname(servers[i], paths[i]);
+	}
+
+	/* The name of each socket shall still be reported correctly
+	 * once all the others were bound.  */
+	for (i = 0; i < NB_SOCKETS; i++) {
+		int client;
+		int peer;
+
+		check_sockname(servers[i], paths[i]);
+
+		status = listen(servers[i], 1);
+		if (status < 0) {
+			perror("listen");
+			exit(EXIT_FAILURE);
+		}
+
+		bzero(&sockaddr, sizeof(sockaddr));
+		sockaddr.sun_family = AF_UNIX;
+		strcpy(sockaddr.sun_path, paths[i]);
+
+		client = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (client < 0) {
+			perror("socket");
+			exit(EXIT_FAILURE);
+		}
+
+		status = connect(client, (const struct sockaddr *) &sockaddr, SUN_LEN(&sockaddr));
+		if (status < 0) {
+			perror("connect");
+			exit(EXIT_FAILURE);
+		}
+
+		peer = accept(servers[i], NULL, NULL);
+		if (peer < 0) {
+			perror("accept");
+			exit(EXIT_FAILURE);
+		}
+
+		check_sockname(peer, paths[i]);
+
+		close(peer);
+		close(client);
+	}
+
+	for (i = 0; i < NB_SOCKETS; i++) {
+		close(servers[i]);
+		(void) unlink(paths[i]);
+		(void) rmdir(dirnames[i]);
+	}
+
+	/* Each iteration uses a new directory: neither the number of
+	 * files opened by PRoot nor the latency shall keep growing.  */
+	nb_fds = count_proot_fds();
+
+	for (i = 0; i < NB_ITERATIONS; i++) {
+		double duration = bind_connect(i);
+
+		if (i < NB_SAMPLES)
+			first += duration;
+		else if (i >= NB_ITERATIONS - NB_SAMPLES)
+			last += duration;
+	}
+
+	if (nb_fds >= 0 && count_proot_fds() > nb_fds + 150) {
+		fprintf(stderr, "PRoot opened %d more files\n", count_proot_fds() - nb_fds);
+		exit(EXIT_FAILURE);
+	}
+
+	if (last > 3 * first) {
+		fprintf(stderr, "latency grew from %fs to %fs\n", first, last);
+		exit(EXIT_FAILURE);
+	}
+
+	exit(EXIT_SUCCESS);
+}
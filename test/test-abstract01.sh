@@ -0,0 +1,61 @@
+if [ -z `which mcookie` ] || [ -z `which python3` ] || [ -z `which rm` ] || [ -z `which sleep` ]; then
+    exit 125;
+fi
+
+NAME=proot-$(mcookie)
+READY=/tmp/$(mcookie)
+DONE=/tmp/$(mcookie)
+
+# Bind the abstract socket $1, check its name from both ends of a
+# connection, then create the file $2 and wait for the file $3.
+SCRIPT='
+import ctypes, os, socket, sys, time
+name = b"\0" + sys.argv[1].encode()
+server = socket.socket(socket.AF_UNIX)
+server.bind(name)
+assert server.getsockname() == name, server.getsockname()
+server.listen(1)
+client = socket.socket(socket.AF_UNIX)
+client.connect(name)
+assert client.getpeername() == name, client.getpeername()
+server.accept()
+# A truncated name reports the actual size, without the session tag.
+truncated = socket.socket(socket.AF_UNIX)
+truncated.bind(b"\0" + b"x" * 40)
+buffer = ctypes.create_string_buffer(16)
+length = ctypes.c_uint(16)
+assert ctypes.CDLL(None).getsockname(truncated.fileno(), buffer, ctypes.byref(length)) == 0
+assert length.value == 2 + 1 + 40, length.value
+assert set(buffer.raw[3:]) <= set(b"x\0"), buffer.raw
+open(sys.argv[2], "w").close()
+while not os.path.exists(sys.argv[3]):
+    time.sleep(0.1)
+'
+
+wait_for() {
+    for i in $(seq 100); do
+	[ -e $1 ] && return 0
+	sleep 0.1
+    done
+    return 1
+}
+
+# Concurrent sessions can use the same abstract name.
+${PROOT} --isolate-abstract-sockets python3 -c "${SCRIPT}" ${NAME} ${READY} ${DONE} &
+PID=$!
+wait_for ${READY}
+rm -f ${READY}
+${PROOT} --isolate-abstract-sockets python3 -c "${SCRIPT}" ${NAME} ${READY} /
+touch ${DONE}
+wait ${PID}
+rm -f ${READY} ${DONE}
+
+# Whereas they collide without isolation.
+${PROOT} python3 -c "${SCRIPT}" ${NAME} ${READY} ${DONE} &
+PID=$!
+wait_for ${READY}
+rm -f ${READY}
+! ${PROOT} python3 -c "${SCRIPT}" ${NAME} ${READY} /
+touch ${DONE}
+wait ${PID}
+rm -f ${READY} ${DONE}
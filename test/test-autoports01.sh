@@ -0,0 +1,39 @@
+if [ -z `which mcookie` ] || [ -z `which python3` ] || [ -z `which cat` ] || [ -z `which grep` ] || [ -z `which cmp` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+
+cat > ${TMP}.py <<'END'
+import socket, sys, time
+
+server = socket.socket()
+server.bind(("127.0.0.1", 8080))
+server.listen(1)
+assert server.getsockname()[1] == 8080
+
+client = socket.create_connection(("127.0.0.1", 8080))
+connection, peer = server.accept()
+assert connection.getsockname()[1] == 8080
+assert client.getpeername()[1] == 8080
+assert peer[1] == client.getsockname()[1]
+
+connection.sendall(b"ok")
+assert client.recv(2) == b"ok"
+
+time.sleep(float(sys.argv[1]))
+END
+
+# Both sessions bind the same guest port concurrently.
+${PROOT} --auto-ports=8000-8999 --export-ports=${TMP}.1 python3 ${TMP}.py 2 &
+${PROOT} --auto-ports=8000-8999 --export-ports=${TMP}.2 python3 ${TMP}.py 2
+wait $!
+
+grep '^8080 [0-9]*$' ${TMP}.1
+grep '^8080 [0-9]*$' ${TMP}.2
+! cmp ${TMP}.1 ${TMP}.2
+
+! ${PROOT} --auto-ports=9-8 true
+! ${PROOT} --auto-ports=8000 true
+
+rm -f ${TMP}.py ${TMP}.1 ${TMP}.2
@@ -0,0 +1,36 @@
+if [ -z `which cpio` ] || [ -z `which rm` ] || [ -z `which mcookie` ] || [ -z `which sha256sum` ] || [ -z `which grep` ]; then
+    exit 125;
+fi
+
+if [ ! -e $CARE ]; then
+    exit 125;
+fi
+unset PROOT
+
+TMP=/tmp/$(mcookie)
+OUTPUT=$(pwd)/$(mcookie)
+
+${CARE} -o ${TMP}.cpio sh -c "echo foo > ${OUTPUT}; exit 3" || true
+
+cd /tmp
+cpio -idmuvF ${TMP}.cpio
+
+grep -q " ${OUTPUT}\$" ${TMP}/outputs.sha256
+
+# The reproduced execution matches the original one.
+env CARE_VERIFY=1 ${TMP}/re-execute.sh
+
+# Divergences are reported per file.
+rm -f ${TMP}/rootfs${OUTPUT}
+mkdir ${TMP}/rootfs${OUTPUT}
+
+set +e
+env CARE_VERIFY=1 ${TMP}/re-execute.sh > ${TMP}.log 2>&1
+status=$?
+set -e
+
+[ $status -ne 0 ]
+grep -q "care: verify: '${OUTPUT}' is missing" ${TMP}.log
+
+rm -f ${OUTPUT}
+rm -fr ${TMP} ${TMP}.cpio ${TMP}.log
@@ -0,0 +1,37 @@
+#!/bin/sh
+
+if [ ! -x ${ROOTFS}/bin/chroot ] || [ ! -x ${ROOTFS}/bin/cat ] || [ ! -x ${ROOTFS}/bin/pwd ] || [ ! -x ${ROOTFS}/bin/readlink ] || [ -z `which mcookie` ] || [ -z `which mkdir` ] || [ -z `which cp` ] || [ -z `which rm` ] || [ -z `which test` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+NEWROOT=${ROOTFS}/${TMP}
+
+rm -fr ${NEWROOT}
+mkdir -p ${NEWROOT}/bin ${NEWROOT}/dir ${NEWROOT}/proc
+
+cp ${ROOTFS}/bin/cat ${ROOTFS}/bin/pwd ${ROOTFS}/bin/readlink ${ROOTFS}/bin/chroot ${NEWROOT}/bin/
+echo "inside" > ${NEWROOT}/file
+
+# open(2) and execve(2) are relative to the new root.
+test "$(${PROOT} -0 -r ${ROOTFS} /bin/chroot ${TMP} /bin/cat /file)" = "inside"
+
+# getcwd(2) is expressed from the new root point-of-view.
+test "$(${PROOT} -0 -r ${ROOTFS} -w ${TMP}/dir /bin/chroot ${TMP} /bin/pwd)" = "/dir"
+test "$(${PROOT} -0 -r ${ROOTFS} -w ${TMP} /bin/chroot . /bin/pwd)" = "/"
+
+# Bindings under the new root are kept, the others are not.
+test "$(${PROOT} -0 -r ${ROOTFS} -b /proc:${TMP}/proc /bin/chroot ${TMP} /bin/readlink /proc/self/exe)" = "/bin/readlink"
+! ${PROOT} -0 -r ${ROOTFS} -b /proc /bin/chroot ${TMP} /bin/readlink /proc/self/exe
+
+# Nested chroot(2).
+test "$(${PROOT} -0 -r ${ROOTFS} -w ${TMP} /bin/chroot . /bin/chroot . /bin/cat /file)" = "inside"
+mkdir -p ${NEWROOT}/${TMP}
+cp -r ${NEWROOT}/bin ${NEWROOT}/${TMP}/
+echo "nested" > ${NEWROOT}/${TMP}/file
+test "$(${PROOT} -0 -r ${ROOTFS} /bin/chroot ${TMP} /bin/chroot ${TMP} /bin/cat /file)" = "nested"
+
+# chroot(2) requires the capability.
+! ${PROOT} -r ${ROOTFS} /bin/chroot ${TMP} /bin/cat /file
+
+rm -fr ${NEWROOT}
@@ -0,0 +1,131 @@
+#define _GNU_SOURCE
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <pthread.h>
+
+#if !defined(CLONE_PIDFD)
+#define CLONE_PIDFD 0x00001000
+#endif
+
+struct clone_args_v0 {
+	uint64_t flags;
+	uint64_t pidfd;
+	uint64_t child_tid;
+	uint64_t parent_tid;
+	uint64_t exit_signal;
+	uint64_t stack;
+	uint64_t stack_size;
+	uint64_t tls;
+};
+
+/* Create a child with the given clone @flags, either with clone(2)
+ * or with clone3(2), make it change its current working directory,
+ * then return whether this change is visible from the parent.  */
+static int child_chdir_is_shared(int use_clone3, unsigned long flags)
+{
+	char cwd[PATH_MAX];
+	int status;
+	int pidfd = -1;
+	long pid;
+
+	if (chdir("/") < 0)
+		exit(EXIT_FAILURE);
+
+	if (use_clone3) {
+#if defined(SYS_clone3)
+		struct clone_args_v0 args;
+
+		memset(&args, 0, sizeof(args));
+		args.flags       = flags | CLONE_PIDFD;
+		args.pidfd       = (uint64_t) (uintptr_t) &pidfd;
+		args.exit_signal = SIGCHLD;
+
+		pid = syscall(SYS_clone3, &args, sizeof(args));
+		if (pid < 0 && (errno == ENOSYS || errno == EINVAL))
+			exit(125);
+#else
+		exit(125);
+#endif
+	}
+	else
+		pid = syscall(SYS_clone, flags | SIGCHLD, 0, NULL, NULL, 0);
+
+	if (pid < 0)
+		exit(EXIT_FAILURE);
+
+	if (pid == 0)
+		_exit(chdir("/tmp") < 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+
+	if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		exit(EXIT_FAILURE);
+
+	if (use_clone3 && pidfd < 0)
+		exit(EXIT_FAILURE);
+	if (pidfd >= 0)
+		close(pidfd);
+
+	if (getcwd(cwd, sizeof(cwd)) == NULL)
+		exit(EXIT_FAILURE);
+
+	return strcmp(cwd, "/tmp") == 0;
+}
+
+static void *thread_chdir(void *arg)
+{
+	(void) arg;
+	return (void *) (intptr_t) chdir("/tmp");
+}
+
+/* Same as child_chdir_is_shared() but with a thread, that is, with
+ * CLONE_VM | CLONE_FS | CLONE_THREAD | ... as created by glibc.  */
+static int thread_chdir_is_shared()
+{
+	char cwd[PATH_MAX];
+	pthread_t thread;
+	void *result;
+
+	if (chdir("/") < 0)
+		exit(EXIT_FAILURE);
+
+	if (pthread_create(&thread, NULL, thread_chdir, NULL) != 0)
+		exit(EXIT_FAILURE);
+
+	if (pthread_join(thread, &result) != 0 || result != NULL)
+		exit(EXIT_FAILURE);
+
+	if (getcwd(cwd, sizeof(cwd)) == NULL)
+		exit(EXIT_FAILURE);
+
+	return strcmp(cwd, "/tmp") == 0;
+}
+
+int main()
+{
+	int use_clone3;
+
+	for (use_clone3 = 0; use_clone3 <= 1; use_clone3++) {
+		/* The file-system name-space is shared...  */
+		if (!child_chdir_is_shared(use_clone3, CLONE_FS))
+			exit(EXIT_FAILURE);
+
+		/* ... or copied.  */
+		if (child_chdir_is_shared(use_clone3, 0))
+			exit(EXIT_FAILURE);
+	}
+
+	/* Threads share the file-system name-space.  */
+	if (!thread_chdir_is_shared())
+		exit(EXIT_FAILURE);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,43 @@
+if [ -z `which mcookie` ] || [ -z `which python3` ] || [ -z `which mkdir` ] || [ -z `which cat` ] || [ -z `which touch` ] || [ -z `which rm` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+mkdir ${TMP}
+echo content > ${TMP}/input
+touch ${TMP}/old
+
+${PROOT} --deps=${TMP}.json sh -c "test -e ${TMP}/output || cat ${TMP}/input > ${TMP}/output; cat ${TMP}/output >> ${TMP}/old; rm ${TMP}/old ${TMP}/missing 2>/dev/null; true"
+
+# Check the record of each command, once executed.
+python3 - ${TMP} ${TMP}.json <<'EOF'
+import json, sys
+
+tmp = sys.argv[1]
+processes = json.load(open(sys.argv[2]))["processes"]
+
+def find(command):
+    return [p for p in processes if p["command"].endswith(command)]
+
+shell = find("/sh") + find("/dash") + find("/bash")
+assert shell, processes
+assert any(tmp + "/output" in p["created"] for p in shell), shell
+assert any(tmp + "/old" in p["written"] for p in shell), shell
+assert not any(tmp + "/old" in p["created"] for p in shell), shell
+
+cats = find("/cat")
+assert len(cats) == 2, cats
+assert any(tmp + "/input" in p["read"] for p in cats), cats
+assert any(tmp + "/output" in p["read"] for p in cats), cats
+
+rm = find("/rm")
+assert len(rm) == 1, rm
+assert tmp + "/old" in rm[0]["deleted"], rm
+assert tmp + "/missing" in rm[0]["missing"], rm
+
+# Each record refers to an existing parent.
+ids = set(p["id"] for p in processes)
+assert all(p["parent"] == 0 or p["parent"] in ids for p in processes)
+EOF
+
+rm -fr ${TMP} ${TMP}.json
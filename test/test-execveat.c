@@ -0,0 +1,94 @@
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#if !defined(AT_EMPTY_PATH)
+#define AT_EMPTY_PATH 0x1000
+#endif
+
+static char *const argv[] = { "true", NULL };
+static char *const envp[] = { NULL };
+
+/* Return the exit status of execveat(dirfd, path, argv, envp, flags).  */
+static int test_execveat(int dirfd, const char *path, int flags)
+{
+	int status;
+	pid_t pid;
+
+	pid = fork();
+	if (pid < 0)
+		exit(EXIT_FAILURE);
+
+	if (pid == 0) {
+		syscall(SYS_execveat, dirfd, path, argv, envp, flags);
+		_exit(errno == ENOSYS ? 125 : 42);
+	}
+
+	if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status))
+		exit(EXIT_FAILURE);
+
+	if (WEXITSTATUS(status) == 125)
+		exit(125);
+
+	return WEXITSTATUS(status);
+}
+
+int main()
+{
+	char buffer[4096];
+	ssize_t size;
+	int dirfd;
+	int fd;
+	int memfd;
+
+#if !defined(SYS_execveat) || !defined(SYS_memfd_create)
+	exit(125);
+#else
+	/* Absolute path.  */
+	if (test_execveat(AT_FDCWD, "/bin/true", 0) != 0)
+		exit(EXIT_FAILURE);
+
+	/* Path relative to a directory descriptor.  */
+	dirfd = open("/bin", O_RDONLY | O_DIRECTORY);
+	if (dirfd < 0)
+		exit(EXIT_FAILURE);
+
+	if (test_execveat(dirfd, "true", 0) != 0)
+		exit(EXIT_FAILURE);
+
+	if (test_execveat(dirfd, "false", 0) != 1)
+		exit(EXIT_FAILURE);
+
+	/* fexecve(3) on a regular file.  */
+	fd = open("/bin/true", O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		exit(EXIT_FAILURE);
+
+	if (test_execveat(fd, "", AT_EMPTY_PATH) != 0)
+		exit(EXIT_FAILURE);
+
+	/* An empty path requires AT_EMPTY_PATH.  */
+	if (test_execveat(fd, "", 0) != 42)
+		exit(EXIT_FAILURE);
+
+	/* fexecve(3) on a memfd.  */
+	memfd = syscall(SYS_memfd_create, "true", 1 /* MFD_CLOEXEC */);
+	if (memfd < 0)
+		exit(errno == ENOSYS ? 125 : EXIT_FAILURE);
+
+	while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+		if (write(memfd, buffer, size) != size)
+			exit(EXIT_FAILURE);
+	}
+
+	if (test_execveat(memfd, "", AT_EMPTY_PATH) != 0)
+		exit(EXIT_FAILURE);
+
+	exit(EXIT_SUCCESS);
+#endif
+}
@@ -0,0 +1,31 @@
+if [ -z `which mcookie` ] || [ -z `which cat` ] || [ -z `which cut` ] || [ -z `which grep` ] || [ -z `which uname` ] || [ ! -x ${ROOTFS}/bin/true ]; then
+    exit 125;
+fi
+
+CACHE=/tmp/$(mcookie)
+
+# The profile is probed then cached for the current kernel release.
+env PROOT_FEATURES_CACHE=${CACHE} ${PROOT} -v 1 true 2>&1 | grep 'kernel features = '
+grep "^2 $(uname -r) " ${CACHE}
+CONTEXT=$(cut -d ' ' -f 3 ${CACHE})
+
+# A profile cached for another release is ignored, then replaced.
+echo "2 0.0.0-other ${CONTEXT} 0" > ${CACHE}
+env PROOT_FEATURES_CACHE=${CACHE} ${PROOT} true
+grep "^2 $(uname -r) ${CONTEXT} " ${CACHE}
+
+# Likewise for a profile cached under other seccomp filters, here
+# the ones of the outer PRoot.
+${PROOT} env PROOT_FEATURES_CACHE=${CACHE} ${PROOT} true
+grep "^2 $(uname -r) " ${CACHE}
+! grep "^2 $(uname -r) ${CONTEXT} " ${CACHE}
+
+# Fallbacks can be forced.
+env PROOT_FEATURES_CACHE=${CACHE} PROOT_DISABLE_FEATURES=all ${PROOT} -v 1 true 2>&1 | grep 'kernel features = none'
+env PROOT_FEATURES_CACHE=${CACHE} PROOT_DISABLE_FEATURES=process_vm ${PROOT} -v 1 true 2>&1 | grep 'kernel features = ' | grep -v process_vm
+env PROOT_DISABLE_FEATURES=all ${PROOT} -r ${ROOTFS} /bin/true
+
+# The cache can be disabled.
+rm -f ${CACHE}
+env PROOT_FEATURES_CACHE= ${PROOT} true
+test ! -e ${CACHE}
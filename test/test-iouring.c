@@ -0,0 +1,30 @@
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#if !defined(SYS_io_uring_setup)
+#define SYS_io_uring_setup 425
+#endif
+
+int main(int argc, char *argv[])
+{
+	uint32_t params[30]; /* struct io_uring_params */
+	int fd;
+
+	memset(params, 0, sizeof(params));
+	fd = syscall(SYS_io_uring_setup, 1, params);
+
+	/* By default, programs have to fall back to regular syscalls.  */
+	if (argc < 2 || strcmp(argv[1], "allow") != 0)
+		exit(fd < 0 && errno == ENOSYS ? EXIT_SUCCESS : EXIT_FAILURE);
+
+	/* Otherwise io_uring is usable, if the kernel allows it.  */
+	if (fd < 0)
+		exit(errno == ENOSYS || errno == EPERM ? 125 : EXIT_FAILURE);
+
+	close(fd);
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,21 @@
+if [ ! -x ${ROOTFS}/bin/test-iouring ] || [ -z `which mcookie` ] || [ -z `which grep` ] || [ -z `which rm` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+
+# Denied by default, and reported.
+${PROOT} -v 1 -r ${ROOTFS} /bin/test-iouring 2> ${TMP}
+grep 'io_uring: policy deny, 1 setup denied, 0 setup allowed' ${TMP}
+
+# Not reported at the default verbose level.
+${PROOT} -r ${ROOTFS} /bin/test-iouring 2> ${TMP}
+! grep 'io_uring:' ${TMP}
+
+# Allowed on demand (if the kernel allows it).
+${PROOT} --io-uring=deny -r ${ROOTFS} /bin/test-iouring
+${PROOT} --io-uring=allow -r ${ROOTFS} /bin/test-iouring allow || [ $? -eq 125 ]
+
+! ${PROOT} --io-uring=maybe true
+
+rm -f ${TMP}
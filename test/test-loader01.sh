@@ -0,0 +1,28 @@
+if [ ! -x  ${ROOTFS}/bin/bss ] || [ -z `which readelf` ] || [ -z `which awk` ] || [ -z `which head` ] || [ -z `which grep` ] || [ -z `which mcookie` ]; then
+    exit 125;
+fi
+
+# The tail of the last page of the initialized data is cleared by the
+# loader.
+${PROOT} ${ROOTFS}/bin/bss
+${PROOT} -v 2 ${ROOTFS}/bin/bss 2>&1 | grep 'and [1-9][0-9]* clears'
+
+TMP=/tmp/$(mcookie)
+
+# Once the file is truncated after its last loadable segment, this
+# tail lies beyond the end of the file: it is zero-filled by the kernel
+# and the loader doesn't have to clear it anymore.
+END=0
+for RANGE in $(readelf -lW ${ROOTFS}/bin/bss | awk '$1 == "LOAD" { print $2 "+" $5 }'); do
+    if [ $((${RANGE})) -gt ${END} ]; then
+	END=$((${RANGE}))
+    fi
+done
+
+head -c ${END} ${ROOTFS}/bin/bss > ${TMP}
+chmod +x ${TMP}
+
+${PROOT} ${TMP}
+${PROOT} -v 2 ${TMP} 2>&1 | grep 'and 0 clears'
+
+rm -f ${TMP}
@@ -0,0 +1,98 @@
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+static char buffer[1024 * 1024];
+
+/* Read "/proc/self/maps" into buffer[].  */
+static void read_maps(void)
+{
+	size_t size = 0;
+	ssize_t status;
+	int fd;
+
+	fd = open("/proc/self/maps", O_RDONLY);
+	if (fd < 0)
+		exit(EXIT_FAILURE);
+
+	while ((status = read(fd, buffer + size, sizeof(buffer) - 1 - size)) > 0)
+		size += status;
+	close(fd);
+
+	if (status < 0)
+		exit(EXIT_FAILURE);
+	buffer[size] = '\0';
+}
+
+/* Return whether "/proc/self/maps" reports a mapping of @path.  */
+static int is_mapped(const char *path)
+{
+	read_maps();
+	return strstr(buffer, path) != NULL;
+}
+
+/* Return whether "/proc/self/maps" reports the mapping at @address
+ * with the permissions @perms.  */
+static int has_perms(void *address, const char *perms)
+{
+	char prefix[64];
+	char *line;
+
+	read_maps();
+
+	snprintf(prefix, sizeof(prefix), "%lx-", (unsigned long) address);
+	for (line = buffer; line != NULL && *line != '\0'; line = strchr(line, '\n')) {
+		if (*line == '\n')
+			line++;
+		if (strncmp(line, prefix, strlen(prefix)) == 0)
+			return strncmp(strchr(line, ' ') + 1, perms, strlen(perms)) == 0;
+	}
+
+	return 0;
+}
+
+int main()
+{
+	void *address;
+	int fd;
+
+	if (is_mapped(" /bin/true\n"))
+		exit(EXIT_FAILURE);
+
+	/* The emulated content is cached, it has to be updated when
+	 * the memory mappings change.  */
+	fd = open("/bin/true", O_RDONLY);
+	if (fd < 0)
+		exit(125);
+
+	address = mmap(NULL, 4096, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (address == MAP_FAILED)
+		exit(EXIT_FAILURE);
+	close(fd);
+
+	if (!is_mapped(" /bin/true\n"))
+		exit(EXIT_FAILURE);
+
+	/* Neither the number nor the size of the mappings change
+	 * here.  */
+	if (!has_perms(address, "r--p"))
+		exit(EXIT_FAILURE);
+
+	if (mprotect(address, 4096, PROT_NONE) < 0)
+		exit(EXIT_FAILURE);
+
+	if (!has_perms(address, "---p"))
+		exit(EXIT_FAILURE);
+
+	munmap(address, 4096);
+
+	if (is_mapped(" /bin/true\n"))
+		exit(EXIT_FAILURE);
+
+	exit(EXIT_SUCCESS);
+}
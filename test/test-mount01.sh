@@ -0,0 +1,34 @@
+#!/bin/sh
+
+if [ -z `which mcookie` ] || [ -z `which mount` ] || [ -z `which umount` ] || [ -z `which cat` ] || [ -z `which grep` ] || [ -z `which mkdir` ] || [ -z `which rm` ] || [ -z `which test` ] || [ -z `which wc` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+
+rm -fr ${TMP}
+mkdir -p ${TMP}/source ${TMP}/target
+echo "content" > ${TMP}/source/file
+
+# Bind mounts are emulated with bindings, they are visible in the
+# emulated mountinfo and they can be unmounted.
+test "$(${PROOT} -0 sh -c "mount --bind ${TMP}/source ${TMP}/target && cat ${TMP}/target/file")" = "content"
+${PROOT} -0 sh -c "mount --bind ${TMP}/source ${TMP}/target && grep -q ' ${TMP}/target ' /proc/self/mountinfo"
+! ${PROOT} -0 sh -c "mount --bind ${TMP}/source ${TMP}/target && umount ${TMP}/target && cat ${TMP}/target/file"
+
+# They are shared with the other processes.
+test "$(${PROOT} -0 sh -c "mount --bind ${TMP}/source ${TMP}/target; sh -c 'cat ${TMP}/target/file'")" = "content"
+
+# tmpfs is emulated with a temporary directory.
+${PROOT} -0 sh -c "mount -t tmpfs none ${TMP}/target && touch ${TMP}/target/new && grep -q '^tmpfs ${TMP}/target tmpfs' /proc/mounts"
+test ! -e ${TMP}/target/new
+
+# The actual mount table is left untouched as long as no mount is
+# emulated.
+test "$(${PROOT} cat /proc/self/mounts)" = "$(cat /proc/self/mounts)"
+test "$(${PROOT} -0 cat /proc/self/mountinfo | wc -l)" = "$(cat /proc/self/mountinfo | wc -l)"
+
+# Only known mount points can be unmounted.
+! ${PROOT} -0 umount ${TMP}/target
+
+rm -fr ${TMP}
@@ -0,0 +1,151 @@
+#define _GNU_SOURCE
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <limits.h>
+#include <errno.h>
+
+#if !defined(SYS_openat2)
+#define SYS_openat2 437
+#endif
+
+#define RESOLVE_NO_XDEV		0x01
+#define RESOLVE_NO_MAGICLINKS	0x02
+#define RESOLVE_NO_SYMLINKS	0x04
+#define RESOLVE_BENEATH		0x08
+#define RESOLVE_IN_ROOT		0x10
+
+struct open_how_v0 {
+	uint64_t flags;
+	uint64_t mode;
+	uint64_t resolve;
+};
+
+/* Return the result of openat2(dirfd, path, { O_PATH, 0, resolve }),
+ * that is, -errno on error.  */
+static int test_openat2(int dirfd, const char *path, uint64_t resolve)
+{
+	struct open_how_v0 how;
+	int fd;
+
+	memset(&how, 0, sizeof(how));
+	how.flags   = O_PATH | O_CLOEXEC;
+	how.resolve = resolve;
+
+	fd = syscall(SYS_openat2, dirfd, path, &how, sizeof(how));
+	if (fd < 0 && errno == ENOSYS)
+		exit(125);
+
+	return fd < 0 ? -errno : fd;
+}
+
+/* Check that openat2(dirfd, path, resolve) refers to @expected.  */
+static void check_same(int dirfd, const char *path, uint64_t resolve, const char *expected)
+{
+	struct stat stat1;
+	struct stat stat2;
+	int fd;
+
+	fd = test_openat2(dirfd, path, resolve);
+	if (fd < 0 || fstat(fd, &stat1) < 0 || stat(expected, &stat2) < 0)
+		exit(EXIT_FAILURE);
+	close(fd);
+
+	if (stat1.st_dev != stat2.st_dev || stat1.st_ino != stat2.st_ino)
+		exit(EXIT_FAILURE);
+}
+
+/* Check that openat2(dirfd, path, resolve) fails with @error.  */
+static void check_error(int dirfd, const char *path, uint64_t resolve, int error)
+{
+	int fd;
+
+	fd = test_openat2(dirfd, path, resolve);
+	if (fd >= 0)
+		close(fd);
+
+	if (fd != -error)
+		exit(EXIT_FAILURE);
+}
+
+int main()
+{
+	char template[] = "/tmp/openat2-XXXXXX";
+	char path[PATH_MAX];
+	char *dir;
+	int dirfd;
+	int rootfd;
+
+	dir = mkdtemp(template);
+	if (dir == NULL)
+		exit(EXIT_FAILURE);
+
+	snprintf(path, sizeof(path), "%s/sub", dir);
+	if (mkdir(path, 0700) < 0)
+		exit(EXIT_FAILURE);
+
+	snprintf(path, sizeof(path), "%s/link", dir);
+	if (symlink("sub", path) < 0)
+		exit(EXIT_FAILURE);
+
+	snprintf(path, sizeof(path), "%s/abs", dir);
+	if (symlink("/", path) < 0)
+		exit(EXIT_FAILURE);
+
+	dirfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	rootfd = open("/", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (dirfd < 0 || rootfd < 0)
+		exit(EXIT_FAILURE);
+
+	snprintf(path, sizeof(path), "%s/sub", dir);
+
+	/* Plain translation.  */
+	check_same(AT_FDCWD, "/bin/true", 0, "/bin/true");
+	check_same(dirfd, "link", 0, path);
+
+	/* RESOLVE_BENEATH.  */
+	check_same(dirfd, "sub/../link", RESOLVE_BENEATH, path);
+	check_error(dirfd, "..", RESOLVE_BENEATH, EXDEV);
+	check_error(dirfd, "sub/../../tmp", RESOLVE_BENEATH, EXDEV);
+	check_error(dirfd, "/tmp", RESOLVE_BENEATH, EXDEV);
+	check_error(dirfd, "abs/tmp", RESOLVE_BENEATH, EXDEV);
+
+	/* RESOLVE_IN_ROOT.  */
+	check_same(dirfd, "/sub", RESOLVE_IN_ROOT, path);
+	check_same(dirfd, "../../sub", RESOLVE_IN_ROOT, path);
+	check_same(dirfd, "abs/link", RESOLVE_IN_ROOT, path);
+	check_same(dirfd, "/", RESOLVE_IN_ROOT, dir);
+
+	/* RESOLVE_NO_SYMLINKS.  */
+	check_same(dirfd, "sub", RESOLVE_NO_SYMLINKS, path);
+	check_error(dirfd, "link", RESOLVE_NO_SYMLINKS, ELOOP);
+	check_error(dirfd, "link/", RESOLVE_NO_SYMLINKS, ELOOP);
+
+	/* RESOLVE_NO_MAGICLINKS.  */
+	check_same(AT_FDCWD, "/proc/self/fd", RESOLVE_NO_MAGICLINKS, "/proc/self/fd");
+	check_error(AT_FDCWD, "/proc/self/cwd/", RESOLVE_NO_MAGICLINKS, ELOOP);
+
+	/* RESOLVE_NO_XDEV.  */
+	check_same(rootfd, "tmp/..", RESOLVE_NO_XDEV, "/");
+	check_error(rootfd, "proc/self", RESOLVE_NO_XDEV, EXDEV);
+
+	/* Incompatible flags.  */
+	check_error(dirfd, "sub", RESOLVE_BENEATH | RESOLVE_IN_ROOT, EINVAL);
+
+	snprintf(path, sizeof(path), "%s/sub", dir);
+	(void) rmdir(path);
+	snprintf(path, sizeof(path), "%s/link", dir);
+	(void) unlink(path);
+	snprintf(path, sizeof(path), "%s/abs", dir);
+	(void) unlink(path);
+	(void) rmdir(dir);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,75 @@
+if [ -z `which mcookie` ] || [ -z `which mkdir` ] || [ -z `which touch` ] || [ -z `which cat` ] || [ -z `which cp` ] || [ -z `which rm` ] || [ -z `which python3` ] || [ ! -x ${ROOTFS}/bin/true ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+mkdir -p ${TMP}/ro/rw ${TMP}/hidden ${TMP}/denied ${TMP}/noexec
+echo content > ${TMP}/ro/file
+cp ${ROOTFS}/bin/true ${TMP}/noexec/true
+cp ${ROOTFS}/bin/true ${TMP}/ro/true
+
+run() {
+    ${PROOT} --policy=ro:${TMP}/ro --policy=rw:${TMP}/ro/rw \
+	     --policy=hide:${TMP}/hidden --policy=deny:${TMP}/denied \
+	     --policy=noexec:${TMP}/noexec "$@"
+}
+
+# Read-only.
+run cat ${TMP}/ro/file
+! run touch ${TMP}/ro/file
+! run touch ${TMP}/ro/new
+! run rm ${TMP}/ro/file
+! run mkdir ${TMP}/ro/dir
+run ${TMP}/ro/true
+test -f ${TMP}/ro/file
+test ! -e ${TMP}/ro/new
+
+# The longest path wins.
+run touch ${TMP}/ro/rw/new
+test -f ${TMP}/ro/rw/new
+
+# Files opened for reading only can't be modified through their
+# descriptor either.
+SCRIPT='
+import ctypes, errno, os, sys
+libc = ctypes.CDLL(None, use_errno=True)
+def syscall(*args):
+    if libc.syscall(*args) < 0:
+        raise OSError(ctypes.get_errno(), os.strerror(ctypes.get_errno()))
+def check(function, *args):
+    try:
+        function(*args)
+    except OSError as error:
+        assert error.errno == int(sys.argv[2]), (function, error)
+        return
+    assert int(sys.argv[2]) == 0, function
+fd = os.open(sys.argv[1], os.O_RDONLY)
+check(os.chmod, fd, 0o600)
+check(os.chown, fd, -1, -1)
+check(os.utime, fd)
+check(os.truncate, fd, 0)
+check(os.posix_fallocate, fd, 0, 4096)
+check(os.setxattr, fd, "user.test", b"value")
+check(os.removexattr, fd, "user.test")
+if os.uname().machine == "x86_64":
+    check(syscall, 260, fd, b"", -1, -1, 0x1000) # fchownat, AT_EMPTY_PATH
+    check(syscall, 452, fd, b"", 0o600, 0x1000)  # fchmodat2, AT_EMPTY_PATH
+'
+
+run python3 -c "${SCRIPT}" ${TMP}/ro/file 30 # EROFS
+test "$(cat ${TMP}/ro/file)" = "content"
+
+# Hidden, denied and not executable.
+run sh -c "ls ${TMP}/hidden 2>&1" | grep 'No such file'
+run sh -c "ls ${TMP}/denied 2>&1" | grep 'Permission denied'
+! run ${TMP}/noexec/true
+run cat ${TMP}/noexec/true > /dev/null
+
+# Guest paths are resolved regarding the guest rootfs.
+${PROOT} -r ${ROOTFS} /bin/true
+! ${PROOT} -r ${ROOTFS} --policy=hide:/bin /bin/true
+
+! ${PROOT} --policy=unknown:/ true
+! ${PROOT} --policy=ro true
+
+rm -fr ${TMP}
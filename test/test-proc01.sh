@@ -0,0 +1,18 @@
+if [ ! -x  ${ROOTFS}/bin/cat ] || [ -z `which grep` ] || [ -z `which mcookie` ] || [ -z `which cp` ] || [ -z `which rm` ]; then
+    exit 125;
+fi
+
+# Paths of mapped files are reported from the guest point-of-view.
+${PROOT} -r ${ROOTFS} -b /proc /bin/cat /proc/self/maps | grep ' /bin/cat$'
+! ${PROOT} -r ${ROOTFS} -b /proc /bin/cat /proc/self/maps | grep "${ROOTFS}"
+
+${PROOT} -r ${ROOTFS} -b /proc /bin/cat /proc/self/smaps | grep ' /bin/cat$'
+! ${PROOT} -r ${ROOTFS} -b /proc /bin/cat /proc/self/smaps | grep "${ROOTFS}"
+
+TMP=/tmp/$(mcookie)
+mkdir -p ${TMP}
+cp ${ROOTFS}/bin/cat ${TMP}/cat
+
+${PROOT} -b ${TMP}:/this_shall_not_exist_outside_proot /this_shall_not_exist_outside_proot/cat /proc/self/maps | grep ' /this_shall_not_exist_outside_proot/cat$'
+
+rm -fr ${TMP}
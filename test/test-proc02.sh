@@ -0,0 +1,12 @@
+if [ ! -x  ${ROOTFS}/bin/readlink ]; then
+    exit 125;
+fi
+
+# Links in "/proc/thread-self/" -- that is, in
+# "/proc/<PID>/task/<TID>/" -- are those of the current thread.
+test "$(${PROOT} -r ${ROOTFS} -b /proc /bin/readlink /proc/thread-self/exe)" = "/bin/readlink"
+test "$(${PROOT} -r ${ROOTFS} -b /proc -w /tmp /bin/readlink /proc/thread-self/cwd)" = "/tmp"
+test "$(${PROOT} -r ${ROOTFS} -b /proc /bin/readlink /proc/thread-self/root)" = "$(${PROOT} -r ${ROOTFS} -b /proc /bin/readlink /proc/self/root)"
+
+test "$(${PROOT} -r ${ROOTFS} -b /proc /bin/readlink /proc/self/exe)" = "/bin/readlink"
+test "$(${PROOT} -r ${ROOTFS} -b /proc -w /tmp /bin/readlink /proc/self/cwd)" = "/tmp"
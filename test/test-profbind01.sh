@@ -0,0 +1,21 @@
+if [ -z `which mcookie` ] || [ -z `which cat` ] || [ -z `which grep` ] || [ -z `which mkdir` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+mkdir -p ${TMP}/used ${TMP}/unused
+echo content > ${TMP}/used/file
+
+${PROOT} --profile-bindings -b ${TMP}/used:/used -b ${TMP}/unused:/unused cat /used/file 2> ${TMP}/report
+
+# Used bindings are ranked, the others are listed apart.
+grep -E 'ms +[0-9]+ +[1-9][0-9]*  /$' ${TMP}/report
+grep -E 'ms +[0-9]+ +[1-9][0-9]*  '${TMP}'/used:/used$' ${TMP}/report
+sed -n '/unused bindings:/,$p' ${TMP}/report | grep "${TMP}/unused:/unused"
+! sed -n '/unused bindings:/,$p' ${TMP}/report | grep "${TMP}/used:/used"
+
+# No report by default.
+${PROOT} -b ${TMP}/used:/used cat /used/file 2> ${TMP}/report
+! grep 'bindings profile' ${TMP}/report
+
+rm -fr ${TMP}
@@ -0,0 +1,23 @@
+#!/bin/sh
+if [ -z `which mcookie` ] || [ -z `which mkdir` ] || [ -z `which mv` ] || [ -z `which pwd` ] || [ -z `which rm` ] || [ -z `which sleep` ] || [ -z `which test` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+PWD_BIN=$(which pwd)
+
+rm -fr ${TMP}
+mkdir -p ${TMP}/a/b
+
+# The cwd of the process that renames the directory is updated.
+test "$(${PROOT} -w ${TMP}/a/b sh -c "mv ${TMP}/a ${TMP}/c; ${PWD_BIN}")" = "${TMP}/c/b"
+
+# The cwd of the other processes located under the renamed directory
+# is updated too.
+test "$(${PROOT} -w ${TMP}/c/b sh -c "(sleep 1; ${PWD_BIN}) & mv ${TMP}/c ${TMP}/d; wait")" = "${TMP}/d/b"
+
+# The cwd of processes located elsewhere is unchanged.
+mkdir -p ${TMP}/f ${TMP}/f2
+test "$(${PROOT} -w ${TMP}/f2 sh -c "mv ${TMP}/f ${TMP}/g && ${PWD_BIN}")" = "${TMP}/f2"
+
+rm -fr ${TMP}
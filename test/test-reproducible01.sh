@@ -0,0 +1,72 @@
+if [ -z `which mcookie` ] || [ -z `which python3` ] || [ -z `which touch` ] || [ -z `which stat` ] || [ -z `which sort` ] || [ -z `which rm` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+mkdir ${TMP}
+
+# Random bytes from getrandom(2) and AT_RANDOM, and the host name.
+SCRIPT='
+import ctypes, os
+libc = ctypes.CDLL(None)
+libc.getauxval.restype = ctypes.c_ulong
+print(os.getrandom(16).hex(), ctypes.string_at(libc.getauxval(25), 16).hex(), os.uname().nodename)
+'
+
+A=$(${PROOT} --reproducible=1 python3 -c "${SCRIPT}")
+B=$(${PROOT} --reproducible=1 python3 -c "${SCRIPT}")
+C=$(${PROOT} --reproducible=2 python3 -c "${SCRIPT}")
+
+test "${A}" = "${B}"
+test "${A}" != "${C}"
+echo "${A}" | grep ' localhost$'
+
+# Directory entries are sorted.
+for i in $(seq 100); do
+    touch ${TMP}/$(mcookie)
+done
+
+${PROOT} --reproducible=1 ls -f ${TMP} > ${TMP}.ls
+LC_ALL=C sort ${TMP}.ls | cmp - ${TMP}.ls
+
+# Directory entries keep the offsets reported by the kernel, and
+# seekdir(3) resumes right after the entry at the given offset.
+SCRIPT='
+import ctypes, sys
+class Dirent(ctypes.Structure):
+    _fields_ = [("ino", ctypes.c_uint64), ("off", ctypes.c_int64), ("reclen", ctypes.c_ushort),
+                ("type", ctypes.c_ubyte), ("name", ctypes.c_char * 256)]
+libc = ctypes.CDLL(None)
+libc.opendir.restype = ctypes.c_void_p
+libc.opendir.argtypes = [ctypes.c_char_p]
+libc.readdir.restype = ctypes.POINTER(Dirent)
+libc.readdir.argtypes = [ctypes.c_void_p]
+libc.telldir.restype = ctypes.c_long
+libc.telldir.argtypes = [ctypes.c_void_p]
+libc.seekdir.argtypes = [ctypes.c_void_p, ctypes.c_long]
+def read(dir):
+    entries = []
+    while True:
+        dirent = libc.readdir(dir)
+        if not dirent:
+            return entries
+        entries.append((dirent.contents.name.decode(), dirent.contents.off, libc.telldir(dir)))
+dir = libc.opendir(sys.argv[1].encode())
+entries = read(dir)
+libc.seekdir(dir, entries[49][2])
+assert read(dir) == entries[50:]
+for name, offset, position in sorted(entries):
+    print(name, offset)
+'
+
+python3 -c "${SCRIPT}" ${TMP} > ${TMP}.offsets
+${PROOT} --reproducible=1 python3 -c "${SCRIPT}" ${TMP} | cmp - ${TMP}.offsets
+
+# Timestamps of files created in the session are pinned.
+touch -d @500 ${TMP}/old
+
+env SOURCE_DATE_EPOCH=1000000000 ${PROOT} --reproducible=1 sh -c "touch ${TMP}/new; stat -c %Y ${TMP}/new ${TMP}/old" > ${TMP}.stat
+test "$(cat ${TMP}.stat)" = "1000000000
+500"
+
+rm -fr ${TMP} ${TMP}.ls ${TMP}.offsets ${TMP}.stat
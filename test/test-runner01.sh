@@ -0,0 +1,52 @@
+if [ ! -x  ${ROOTFS}/bin/true ] || [ -z `which mcookie` ] || [ -z `which printf` ] || [ -z `which dd` ] || [ -z `which grep` ] || [ -z `which cp` ] || [ -z `which mkdir` ] || [ -z `which rm` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+mkdir ${ROOTFS}/${TMP}
+
+# Forge an ELF program for the machine $2 (octal e_machine, encoded
+# with respect to the byte order), the class $3 (octal
+# e_ident[EI_CLASS]) and the byte order $4 (octal e_ident[EI_DATA]).
+forge() {
+    cp ${ROOTFS}/bin/true ${ROOTFS}/${TMP}/$1
+    printf "$2" | dd of=${ROOTFS}/${TMP}/$1 bs=1 seek=18 conv=notrunc 2>/dev/null
+    printf "$3$4" | dd of=${ROOTFS}/${TMP}/$1 bs=1 seek=4 conv=notrunc 2>/dev/null
+}
+
+forge aarch64 '\267\000' '\002' '\001'
+forge arm     '\050\000' '\001' '\001'
+forge riscv64 '\363\000' '\002' '\001'
+forge riscv32 '\363\000' '\001' '\001'
+forge mips    '\000\010' '\001' '\002'
+forge mipsel  '\010\000' '\001' '\001'
+forge unknown '\377\000' '\002' '\001'
+
+# Each runner is a fake one that prints its own name.
+${PROOT} -r ${ROOTFS} --runner='aarch64:echo aarch64' ${TMP}/aarch64 | grep "^aarch64 .*-0 ${TMP}/aarch64 ${TMP}/aarch64$"
+${PROOT} -r ${ROOTFS} --runner='aarch64:echo aarch64' --runner='arm:echo arm' ${TMP}/arm | grep "^arm .*-0 ${TMP}/arm ${TMP}/arm$"
+${PROOT} -r ${ROOTFS} --runner='riscv64:echo riscv64' --runner='243/32:echo riscv32' ${TMP}/riscv64 | grep "^riscv64 .*-0 ${TMP}/riscv64 ${TMP}/riscv64$"
+${PROOT} -r ${ROOTFS} --runner='riscv64:echo riscv64' --runner='243/32:echo riscv32' ${TMP}/riscv32 | grep "^riscv32 .*-0 ${TMP}/riscv32 ${TMP}/riscv32$"
+
+# The byte order is part of the machine.
+${PROOT} -r ${ROOTFS} --runner='mips:echo mips' --runner='mipsel:echo mipsel' ${TMP}/mips | grep "^mips .*-0 ${TMP}/mips ${TMP}/mips$"
+${PROOT} -r ${ROOTFS} --runner='mips:echo mips' --runner='mipsel:echo mipsel' ${TMP}/mipsel | grep "^mipsel .*-0 ${TMP}/mipsel ${TMP}/mipsel$"
+${PROOT} -r ${ROOTFS} --runner='mipsel:echo mipsel' --runner='mips:echo mips' ${TMP}/mips | grep "^mips .*-0 ${TMP}/mips ${TMP}/mips$"
+
+# Host programs are still executed natively.
+${PROOT} -r ${ROOTFS} --runner='aarch64:echo aarch64' /bin/true
+
+# Otherwise the runner specified with -q is used, if any.
+${PROOT} -r ${ROOTFS} --runner='aarch64:echo aarch64' -q 'echo default' ${TMP}/unknown | grep "^default .*-0 ${TMP}/unknown ${TMP}/unknown$"
+! ${PROOT} -r ${ROOTFS} --runner='aarch64:echo aarch64' ${TMP}/unknown
+
+# The machine of a program is read again once it is modified.
+HOST_TMP=${ROOTFS}/${TMP}
+${PROOT} --runner='aarch64:echo aarch64' --runner='arm:echo arm' sh -c "${HOST_TMP}/arm; cp ${HOST_TMP}/aarch64 ${HOST_TMP}/arm; ${HOST_TMP}/arm" > ${HOST_TMP}/output
+grep "^arm " ${HOST_TMP}/output
+grep "^aarch64 " ${HOST_TMP}/output
+
+! ${PROOT} --runner='unknown:echo' true
+! ${PROOT} --runner='aarch64' true
+
+rm -fr ${ROOTFS}/${TMP}
@@ -0,0 +1,31 @@
+if [ -z `which sleep` ] || [ -z `which kill` ]; then
+    exit 125
+fi
+
+# Termination signals sent to PRoot are forwarded to the tracees ...
+${PROOT} sleep 60 &
+PID=$!
+sleep 2
+kill -TERM ${PID}
+STATUS=0
+wait ${PID} || STATUS=$?
+test ${STATUS} -eq 143
+
+# ... which are killed if they are still alive after the grace period.
+${PROOT} --grace-period=1 sh -c 'trap "" TERM; sleep 60' &
+PID=$!
+sleep 2
+kill -TERM ${PID}
+STATUS=0
+wait ${PID} || STATUS=$?
+test ${STATUS} -eq 137
+
+# Other SIGALRMs are ignored, as well as termination signals sent by
+# the tracees themselves.
+${PROOT} sleep 3 &
+PID=$!
+sleep 1
+kill -ALRM ${PID}
+wait ${PID}
+
+${PROOT} sh -c 'kill -TERM ${PPID}; sleep 1'
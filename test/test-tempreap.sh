@@ -0,0 +1,24 @@
+if [ -z `which mcookie` ] || [ -z `which mkdir` ] || [ -z `which ls` ] || [ -z `which rm` ] || [ -z `which sleep` ] || [ -z `which env` ] || [ -z `which true` ]; then
+    exit 125
+fi
+
+TMP=/tmp/$(mcookie)
+mkdir ${TMP}
+
+# Nothing is left behind on normal termination.
+env PROOT_TMP_DIR=${TMP} ${PROOT} true
+test -z "$(ls ${TMP})"
+
+# The session directory of a killed PRoot ...
+env PROOT_TMP_DIR=${TMP} ${PROOT} sleep 60 &
+PID=$!
+sleep 2
+kill -KILL ${PID}
+wait ${PID} || true
+test -n "$(ls ${TMP})"
+
+# ... is removed by the next PRoot.
+env PROOT_TMP_DIR=${TMP} ${PROOT} true
+test -z "$(ls ${TMP})"
+
+rm -fr ${TMP}
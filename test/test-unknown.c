@@ -0,0 +1,29 @@
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* open_tree(2) takes a path but proot doesn't know it yet.  */
+#if !defined(SYS_open_tree)
+#define SYS_open_tree 428
+#endif
+
+int main(int argc, char *argv[])
+{
+	int fd;
+
+	fd = syscall(SYS_open_tree, -1, "", 0);
+	if (fd >= 0)
+		close(fd);
+
+	/* Denied syscalls fail before reaching the kernel.  */
+	if (argc >= 2 && strcmp(argv[1], "deny") == 0)
+		exit(fd < 0 && errno == ENOSYS ? EXIT_SUCCESS : EXIT_FAILURE);
+
+	/* Otherwise they reach the kernel, if it supports them.  */
+	if (fd < 0 && errno == ENOSYS)
+		exit(125);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,30 @@
+if [ ! -x ${ROOTFS}/bin/test-unknown ] || [ -z `which mcookie` ] || [ -z `which grep` ] || [ -z `which rm` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+
+# Allowed by default, and not reported.
+${PROOT} -r ${ROOTFS} /bin/test-unknown 2> ${TMP}
+! grep 'unknown' ${TMP}
+
+# Reported once.
+${PROOT} --unknown-syscalls=report -r ${ROOTFS} /bin/test-unknown 2> ${TMP}
+grep 'unknown syscalls policy = report' ${TMP}
+grep 'unknown syscalls (abi 0) = .*+' ${TMP}
+test $(grep -c 'is unknown, it runs untranslated' ${TMP}) -eq 1
+
+# Denied, with or without seccomp.
+${PROOT} --unknown-syscalls=deny -r ${ROOTFS} /bin/test-unknown deny
+env PROOT_NO_SECCOMP=1 ${PROOT} --unknown-syscalls=deny -r ${ROOTFS} /bin/test-unknown deny
+
+# Allowed explicitly.
+${PROOT} --unknown-syscalls=deny,428 -r ${ROOTFS} /bin/test-unknown
+
+# Known syscalls are not affected.
+${PROOT} --unknown-syscalls=deny -r ${ROOTFS} /bin/true
+
+! ${PROOT} --unknown-syscalls=maybe true
+! ${PROOT} --unknown-syscalls=deny,foo true
+
+rm -f ${TMP}
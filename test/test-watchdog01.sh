@@ -0,0 +1,42 @@
+if [ ! -x  ${ROOTFS}/bin/clone-untraced ] || [ -z `which mcookie` ] || [ -z `which sleep` ] || [ -z `which grep` ] || [ -z `which kill` ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+
+# Processes that are running are not reported.
+${PROOT} --watchdog=1 sleep 3 2> ${TMP}
+! grep 'proot watchdog' ${TMP}
+
+# A child created with CLONE_PTRACE and CLONE_UNTRACED is kept stopped
+# by proot since its parent doesn't report it; it is killed after 3s.
+${PROOT} --watchdog=1 -r ${ROOTFS} /bin/clone-untraced 3 2> ${TMP}
+
+grep '^proot watchdog: tracees stopped for more than 1s' ${TMP}
+grep '^vpid 2: pid [0-9]*, stopped for [0-9]*s, .* sigstop 2$' ${TMP}
+! grep '^vpid 1: ' ${TMP}
+
+# Such a child can't be restarted safely.
+${PROOT} --watchdog=1,restart -r ${ROOTFS} /bin/clone-untraced 3 2> ${TMP}
+
+grep "can't be restarted safely" ${TMP}
+
+# SIGPWR is ignored without --watchdog.
+${PROOT} sh -c 'kill -PWR $PPID; sleep 1' 2> ${TMP}
+! grep 'proot state dump' ${TMP}
+
+# Otherwise it dumps the state of all tracees, here it is sent by the
+# first tracee to proot -- its actual parent.
+rm -f ${TMP}
+env PROOT_STATE_DUMP=${TMP} ${PROOT} --watchdog=60 sh -c 'kill -PWR $PPID; sleep 1'
+
+grep '^proot state dump:' ${TMP}
+grep '^vpid 1: pid [0-9]*, ' ${TMP}
+grep 'as_ptracer: nb_ptracees 0' ${TMP}
+grep 'last syscall: ' ${TMP}
+
+! ${PROOT} --watchdog=0 true
+! ${PROOT} --watchdog=1,unknown true
+${PROOT} --watchdog=1,restart true
+
+rm -f ${TMP}
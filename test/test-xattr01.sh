@@ -0,0 +1,46 @@
+if [ -z `which mcookie` ] || [ -z `which setcap` ] || [ -z `which getcap` ] || [ -z `which cp` ] || [ -z `which rm` ] || [ -z `which ln` ] || [ ! -x  ${ROOTFS}/bin/true ]; then
+    exit 125;
+fi
+
+# File capabilities can be set for real by "root".
+if [ `id -u` -eq 0 ]; then
+    exit 125;
+fi
+
+TMP=/tmp/$(mcookie)
+STORE=/tmp/$(mcookie)
+
+cp ${ROOTFS}/bin/true ${TMP}
+
+# Not emulated without -0.
+! ${PROOT} setcap cap_net_raw+ep ${TMP}
+
+${PROOT} -0 setcap cap_net_raw+ep ${TMP}
+${PROOT} -0 sh -c "setcap cap_net_raw+ep ${TMP}; getcap ${TMP}" | grep cap_net_raw
+
+# Kept across invocations only if PROOT_XATTR_STORE is set.
+! ${PROOT} -0 getcap ${TMP} | grep cap_net_raw
+
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 setcap cap_net_raw+ep ${TMP}
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 getcap ${TMP} | grep cap_net_raw
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 setcap -r ${TMP}
+! env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 getcap ${TMP} | grep cap_net_raw
+
+# Files without any attribute can be listed.
+${PROOT} -0 cp -a ${TMP} ${TMP}.copy
+rm -f ${TMP}.copy
+
+# Attributes are dropped with the last link of their file.
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 setcap cap_net_raw+ep ${TMP}
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 ln ${TMP} ${TMP}.link
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 rm ${TMP}.link
+test -s ${STORE}
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 rm ${TMP}
+test ! -s ${STORE}
+
+# Even when they were set by the same session.
+cp ${ROOTFS}/bin/true ${TMP}
+env PROOT_XATTR_STORE=${STORE} ${PROOT} -0 sh -c "setcap cap_net_raw+ep ${TMP}; rm ${TMP}"
+test ! -s ${STORE}
+
+rm -f ${TMP} ${STORE}